@@ -0,0 +1,253 @@
+/**
+ * @file chain_cache.c
+ * @brief Cache of certificate chains that verified successfully
+ *
+ * Entries only hold the SHA-256 key and the validity window of the chain,
+ * never the certificates themselves. The key covers the trusted CAs passed
+ * to the verification, the trust store version and the profile, so entries
+ * verified against other trust anchors or a laxer profile never match;
+ * changing the trust store version also flushes the cache.
+ */
+
+#include "chain_cache.h"
+#include "board_timing.h"
+#include "psa/crypto.h"
+#include <string.h>
+
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+
+#define CHAIN_CACHE_KEY_LEN 32
+
+/* Chain that verified without any flag */
+typedef struct {
+    uint8_t key[CHAIN_CACHE_KEY_LEN];
+    mbedtls_x509_time valid_from;
+    mbedtls_x509_time valid_to;
+    uint32_t last_use;
+    uint8_t in_use;
+} chain_cache_entry_t;
+
+static chain_cache_entry_t chain_cache[CHAIN_CACHE_SIZE];
+static uint32_t chain_cache_clock;
+static uint32_t chain_cache_trust_version;
+static chain_cache_stats_t chain_cache_stats;
+
+/**
+ * @brief Hash the DER of a list of certificates
+ *
+ * Each certificate is length-prefixed and the list ends with a zero length,
+ * so that certificate and list boundaries are part of the key.
+ *
+ * @param op Running hash operation
+ * @param crt First certificate, or NULL for an empty list
+ * @retval PSA_SUCCESS if successful, a PSA error otherwise
+ */
+static psa_status_t chain_cache_hash_list(psa_hash_operation_t *op, const mbedtls_x509_crt *crt)
+{
+    const mbedtls_x509_crt *cur;
+    uint8_t len[4] = { 0 };
+    psa_status_t status = PSA_SUCCESS;
+
+    for (cur = crt; status == PSA_SUCCESS && cur != NULL && cur->raw.len != 0; cur = cur->next) {
+        len[0] = (uint8_t)(cur->raw.len >> 24);
+        len[1] = (uint8_t)(cur->raw.len >> 16);
+        len[2] = (uint8_t)(cur->raw.len >> 8);
+        len[3] = (uint8_t)cur->raw.len;
+        status = psa_hash_update(op, len, sizeof(len));
+        if (status == PSA_SUCCESS) {
+            status = psa_hash_update(op, cur->raw.p, cur->raw.len);
+        }
+    }
+
+    if (status == PSA_SUCCESS) {
+        memset(len, 0, sizeof(len));
+        status = psa_hash_update(op, len, sizeof(len));
+    }
+    return status;
+}
+
+/**
+ * @brief Hash the trust store version, the trusted CAs, the profile and the
+ *        peer chain
+ *
+ * A list of trusted CAs is identified by the DER of every CA in it, so the
+ * same list loaded twice shares entries and any other list never does. A CA
+ * callback is identified by the callback and its context; what it returns is
+ * covered by the trust store version.
+ *
+ * @param crt Peer chain, leaf first
+ * @param trust_ca Trusted CAs, or NULL
+ * @param f_ca_cb Trusted CA callback, or NULL
+ * @param p_ca_cb Context of @p f_ca_cb
+ * @param profile Verification profile
+ * @param key Output SHA-256
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int chain_cache_key(const mbedtls_x509_crt *crt, const mbedtls_x509_crt *trust_ca,
+                           mbedtls_x509_crt_ca_cb_t f_ca_cb, const void *p_ca_cb,
+                           const mbedtls_x509_crt_profile *profile,
+                           uint8_t key[CHAIN_CACHE_KEY_LEN])
+{
+    psa_hash_operation_t op = PSA_HASH_OPERATION_INIT;
+    uint8_t header[20];
+    uint8_t ca_cb[1 + sizeof(f_ca_cb) + sizeof(p_ca_cb)];
+    size_t key_len;
+    psa_status_t status;
+
+    memcpy(header, &chain_cache_trust_version, 4);
+    memcpy(header + 4, &profile->allowed_mds, 4);
+    memcpy(header + 8, &profile->allowed_pks, 4);
+    memcpy(header + 12, &profile->allowed_curves, 4);
+    memcpy(header + 16, &profile->rsa_min_bitlen, 4);
+
+    /* Tagged so that a CA callback never matches a list of CAs */
+    ca_cb[0] = f_ca_cb != NULL;
+    memcpy(ca_cb + 1, &f_ca_cb, sizeof(f_ca_cb));
+    memcpy(ca_cb + 1 + sizeof(f_ca_cb), &p_ca_cb, sizeof(p_ca_cb));
+
+    status = psa_hash_setup(&op, PSA_ALG_SHA_256);
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_update(&op, header, sizeof(header));
+    }
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_update(&op, ca_cb, sizeof(ca_cb));
+    }
+    if (status == PSA_SUCCESS) {
+        status = chain_cache_hash_list(&op, f_ca_cb != NULL ? NULL : trust_ca);
+    }
+    if (status == PSA_SUCCESS) {
+        status = chain_cache_hash_list(&op, crt);
+    }
+
+    if (status == PSA_SUCCESS) {
+        status = psa_hash_finish(&op, key, CHAIN_CACHE_KEY_LEN, &key_len);
+    }
+    if (status != PSA_SUCCESS) {
+        psa_hash_abort(&op);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Register the cache with mbedTLS for the given trust anchors
+ * @param trust_version Version of the CA callback's store, or 0 without one
+ */
+void chain_cache_setup(uint32_t trust_version)
+{
+    if (trust_version != chain_cache_trust_version) {
+        chain_cache_flush();
+        chain_cache_trust_version = trust_version;
+    }
+    mbedtls_x509_crt_set_verify_cache_cb(chain_cache_lookup, chain_cache_store, NULL);
+}
+
+/**
+ * @brief Lookup callback, see mbedtls_x509_crt_cache_lookup_cb_t
+ */
+int chain_cache_lookup(void *p_ctx, const mbedtls_x509_crt *crt,
+                       const mbedtls_x509_crt *trust_ca,
+                       mbedtls_x509_crt_ca_cb_t f_ca_cb, const void *p_ca_cb,
+                       const mbedtls_x509_crt_profile *profile,
+                       mbedtls_x509_time *valid_from, mbedtls_x509_time *valid_to)
+{
+    uint8_t key[CHAIN_CACHE_KEY_LEN];
+    uint32_t start = board_timing_cycles();
+    size_t i;
+
+    (void)p_ctx;
+
+    if (chain_cache_key(crt, trust_ca, f_ca_cb, p_ca_cb, profile, key) == 0) {
+        for (i = 0; i < CHAIN_CACHE_SIZE; i++) {
+            if (chain_cache[i].in_use &&
+                memcmp(chain_cache[i].key, key, CHAIN_CACHE_KEY_LEN) == 0) {
+                chain_cache[i].last_use = ++chain_cache_clock;
+                *valid_from = chain_cache[i].valid_from;
+                *valid_to = chain_cache[i].valid_to;
+                chain_cache_stats.hits++;
+                chain_cache_stats.lookup_cycles += board_timing_cycles() - start;
+                return 0;
+            }
+        }
+    }
+
+    chain_cache_stats.misses++;
+    chain_cache_stats.lookup_cycles += board_timing_cycles() - start;
+    return -1;
+}
+
+/**
+ * @brief Store callback, see mbedtls_x509_crt_cache_store_cb_t
+ */
+void chain_cache_store(void *p_ctx, const mbedtls_x509_crt *crt,
+                       const mbedtls_x509_crt *trust_ca,
+                       mbedtls_x509_crt_ca_cb_t f_ca_cb, const void *p_ca_cb,
+                       const mbedtls_x509_crt_profile *profile,
+                       const mbedtls_x509_time *valid_from, const mbedtls_x509_time *valid_to)
+{
+    chain_cache_entry_t *victim = &chain_cache[0];
+    uint8_t key[CHAIN_CACHE_KEY_LEN];
+    size_t i;
+
+    (void)p_ctx;
+
+    if (chain_cache_key(crt, trust_ca, f_ca_cb, p_ca_cb, profile, key) != 0) {
+        return;
+    }
+
+    /* Free slot first, least recently used otherwise */
+    for (i = 0; i < CHAIN_CACHE_SIZE; i++) {
+        if (!chain_cache[i].in_use) {
+            victim = &chain_cache[i];
+            break;
+        }
+        if (chain_cache[i].last_use < victim->last_use) {
+            victim = &chain_cache[i];
+        }
+    }
+
+    memcpy(victim->key, key, CHAIN_CACHE_KEY_LEN);
+    victim->valid_from = *valid_from;
+    victim->valid_to = *valid_to;
+    victim->last_use = ++chain_cache_clock;
+    victim->in_use = 1;
+    chain_cache_stats.stores++;
+}
+
+/**
+ * @brief Forget every cached chain
+ */
+void chain_cache_flush(void)
+{
+    memset(chain_cache, 0, sizeof(chain_cache));
+    chain_cache_clock = 0;
+    chain_cache_stats.flushes++;
+}
+
+/**
+ * @brief Unregister the cache from mbedTLS and forget every cached chain
+ */
+void chain_cache_free(void)
+{
+    mbedtls_x509_crt_set_verify_cache_cb(NULL, NULL, NULL);
+    chain_cache_flush();
+}
+
+/**
+ * @brief Get chain cache counters
+ * @param stats Filled with the current counters
+ */
+void chain_cache_get_stats(chain_cache_stats_t *stats)
+{
+    *stats = chain_cache_stats;
+}
+
+/**
+ * @brief Reset chain cache counters
+ */
+void chain_cache_reset_stats(void)
+{
+    memset(&chain_cache_stats, 0, sizeof(chain_cache_stats));
+}
+
+#endif /* MBEDTLS_X509_CRT_VERIFY_CACHE */
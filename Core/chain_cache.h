@@ -0,0 +1,89 @@
+/**
+ * @file chain_cache.h
+ * @brief Cache of certificate chains that verified successfully
+ *
+ * Reconnecting to the same server presents the same chain every time. The
+ * cache plugs into mbedtls_x509_crt_set_verify_cache_cb() and remembers each
+ * chain that verified cleanly, keyed by SHA-256 over the trusted CAs of the
+ * verification (the DER of a CA list, or the identity of a CA callback and
+ * its context), the trust store version, the verification profile and the
+ * DER of the leaf and intermediates. A chain
+ * found in the cache skips chain building and every signature check; mbedTLS
+ * still checks the expected host name, the leaf key and the validity window
+ * of the whole chain.
+ */
+
+#ifndef CHAIN_CACHE_H
+#define CHAIN_CACHE_H
+
+#include <stdint.h>
+#include "mbedtls/x509_crt.h"
+
+/* Number of verified chains remembered, least recently used goes first */
+#ifndef CHAIN_CACHE_SIZE
+#define CHAIN_CACHE_SIZE 4
+#endif
+
+/**
+ * @brief Chain cache counters, cycle totals are from board_timing_cycles()
+ */
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t stores;
+    uint32_t flushes;
+    uint32_t lookup_cycles;
+} chain_cache_stats_t;
+
+/**
+ * @brief Register the cache with mbedTLS for the given trust anchors
+ *
+ * Call again whenever the CAs behind a CA callback change: a different
+ * @p trust_version drops every cached chain. Lists of trusted CAs need no
+ * version, their DER is part of the key.
+ *
+ * @param trust_version Version of the CA callback's store, e.g.
+ *                      trust_store_version(), or 0 without one
+ */
+void chain_cache_setup(uint32_t trust_version);
+
+/**
+ * @brief Lookup callback, see mbedtls_x509_crt_cache_lookup_cb_t
+ */
+int chain_cache_lookup(void *p_ctx, const mbedtls_x509_crt *crt,
+                       const mbedtls_x509_crt *trust_ca,
+                       mbedtls_x509_crt_ca_cb_t f_ca_cb, const void *p_ca_cb,
+                       const mbedtls_x509_crt_profile *profile,
+                       mbedtls_x509_time *valid_from, mbedtls_x509_time *valid_to);
+
+/**
+ * @brief Store callback, see mbedtls_x509_crt_cache_store_cb_t
+ */
+void chain_cache_store(void *p_ctx, const mbedtls_x509_crt *crt,
+                       const mbedtls_x509_crt *trust_ca,
+                       mbedtls_x509_crt_ca_cb_t f_ca_cb, const void *p_ca_cb,
+                       const mbedtls_x509_crt_profile *profile,
+                       const mbedtls_x509_time *valid_from, const mbedtls_x509_time *valid_to);
+
+/**
+ * @brief Forget every cached chain
+ */
+void chain_cache_flush(void);
+
+/**
+ * @brief Unregister the cache from mbedTLS and forget every cached chain
+ */
+void chain_cache_free(void);
+
+/**
+ * @brief Get chain cache counters
+ * @param stats Filled with the current counters
+ */
+void chain_cache_get_stats(chain_cache_stats_t *stats);
+
+/**
+ * @brief Reset chain cache counters
+ */
+void chain_cache_reset_stats(void);
+
+#endif /* CHAIN_CACHE_H */
@@ -0,0 +1,774 @@
+/**
+ * @file crl_index.c
+ * @brief Streaming CRL ingestion into a sorted revocation index
+ *
+ * The CRL is parsed one DER element at a time out of a small carry buffer:
+ * containers only have their header consumed, leaf elements are consumed
+ * whole, and the tail of each revoked entry after its serial number is
+ * hashed and dropped without being buffered. Only ECDSA signatures are
+ * supported, as for every other certificate on this device.
+ */
+
+#include "crl_index.h"
+#include "board_timing.h"
+#include "mbedtls/error.h"
+#include "mbedtls/psa_util.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+
+/* Parser states, in the order of the CertificateList fields */
+#define CRL_INDEX_S_OUTER       0
+#define CRL_INDEX_S_TBS         1
+#define CRL_INDEX_S_ISSUER      2
+#define CRL_INDEX_S_THIS_UPDATE 3
+#define CRL_INDEX_S_NEXT_UPDATE 4
+#define CRL_INDEX_S_REVOKED     5
+#define CRL_INDEX_S_ENTRY       6
+#define CRL_INDEX_S_SIG_ALG     7
+#define CRL_INDEX_S_SIG         8
+#define CRL_INDEX_S_DONE        9
+#define CRL_INDEX_S_FAILED      10
+
+/* Element not complete in the carry buffer yet */
+#define CRL_INDEX_MORE 1
+
+/* Longest serial number accepted, RFC 5280 allows 20 octets */
+#define CRL_INDEX_MAX_SERIAL_LEN 32
+
+/* ecdsa-with-SHA256/384/512, 1.2.840.10045.4.3.x */
+static const uint8_t crl_index_oid_ecdsa[7] = { 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x03 };
+
+/* FNV-1a 64 */
+static uint64_t crl_index_hash(const uint8_t *p, size_t len)
+{
+    uint64_t h = 0xCBF29CE484222325ULL;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x00000100000001B3ULL;
+    }
+    return h;
+}
+
+/* Key of a serial number, leading zero bytes do not count */
+static uint64_t crl_index_key(const uint8_t *serial, size_t len)
+{
+    while (len > 1 && serial[0] == 0) {
+        serial++;
+        len--;
+    }
+    return crl_index_hash(serial, len);
+}
+
+static int crl_index_key_cmp(const void *a, const void *b)
+{
+    uint64_t ka = *(const uint64_t *)a;
+    uint64_t kb = *(const uint64_t *)b;
+
+    return ka < kb ? -1 : ka > kb;
+}
+
+/**
+ * @brief Read a DER tag and length
+ * @param p Element start
+ * @param avail Bytes available at @p p
+ * @param tag Element tag
+ * @param hdr Length of the tag and length bytes
+ * @param len Length of the content
+ * @retval 0 if successful, CRL_INDEX_MORE if @p avail is too short, an
+ *         mbedTLS error code otherwise
+ */
+static int crl_index_tlv(const uint8_t *p, size_t avail, uint8_t *tag, size_t *hdr, size_t *len)
+{
+    size_t n;
+    size_t i;
+
+    if (avail < 2) {
+        return CRL_INDEX_MORE;
+    }
+    *tag = p[0];
+    if ((p[0] & 0x1F) == 0x1F) {
+        return MBEDTLS_ERR_X509_INVALID_FORMAT;
+    }
+    if (p[1] < 0x80) {
+        *hdr = 2;
+        *len = p[1];
+        return 0;
+    }
+
+    /* At most 16 MB, so offset sums cannot wrap on a 32-bit size_t */
+    n = p[1] & 0x7F;
+    if (n == 0 || n > 3) {
+        return MBEDTLS_ERR_X509_INVALID_FORMAT;
+    }
+    if (avail < 2 + n) {
+        return CRL_INDEX_MORE;
+    }
+    *len = 0;
+    for (i = 0; i < n; i++) {
+        *len = (*len << 8) | p[2 + i];
+    }
+    *hdr = 2 + n;
+    return 0;
+}
+
+/**
+ * @brief Check that an element ends within its container, without overflow
+ * @param pos Element offset
+ * @param hdr Length of the tag and length bytes
+ * @param len Length of the content
+ * @param end Container end offset
+ * @retval 1 if the element fits, 0 otherwise
+ */
+static int crl_index_within(size_t pos, size_t hdr, size_t len, size_t end)
+{
+    return pos <= end && hdr <= end - pos && len <= end - pos - hdr;
+}
+
+/**
+ * @brief Read a whole DER element that must end within its container
+ * @param p Element start
+ * @param avail Bytes available at @p p
+ * @param room Bytes left in the container
+ * @param tag Expected tag
+ * @param hdr Length of the tag and length bytes
+ * @param len Length of the content
+ * @retval 0 if successful, CRL_INDEX_MORE if the element is not complete
+ *         yet, an mbedTLS error code otherwise
+ */
+static int crl_index_element(const uint8_t *p, size_t avail, size_t room, uint8_t tag,
+                             size_t *hdr, size_t *len)
+{
+    uint8_t t;
+    int ret;
+
+    ret = crl_index_tlv(p, avail, &t, hdr, len);
+    if (ret != 0) {
+        return ret;
+    }
+    if (t != tag || !crl_index_within(0, *hdr, *len, room)) {
+        return MBEDTLS_ERR_X509_INVALID_FORMAT;
+    }
+    if (*hdr + *len > CRL_INDEX_CARRY_LEN) {
+        return MBEDTLS_ERR_X509_BUFFER_TOO_SMALL;
+    }
+    return avail < *hdr + *len ? CRL_INDEX_MORE : 0;
+}
+
+/**
+ * @brief Parse an UTCTime or GeneralizedTime
+ * @param tag Element tag
+ * @param p Content
+ * @param len Length of @p p
+ * @param t Parsed time
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+static int crl_index_time(uint8_t tag, const uint8_t *p, size_t len, mbedtls_x509_time *t)
+{
+    int v[7];
+    size_t digits = tag == MBEDTLS_ASN1_UTC_TIME ? 12 : 14;
+    size_t i;
+    int d = 0;
+
+    if ((tag != MBEDTLS_ASN1_UTC_TIME && tag != MBEDTLS_ASN1_GENERALIZED_TIME) ||
+        len != digits + 1 || p[digits] != 'Z') {
+        return MBEDTLS_ERR_X509_INVALID_DATE;
+    }
+    for (i = 0; i < digits; i += 2) {
+        if (p[i] < '0' || p[i] > '9' || p[i + 1] < '0' || p[i + 1] > '9') {
+            return MBEDTLS_ERR_X509_INVALID_DATE;
+        }
+        v[d++] = (p[i] - '0') * 10 + (p[i + 1] - '0');
+    }
+
+    if (tag == MBEDTLS_ASN1_UTC_TIME) {
+        t->year = v[0] < 50 ? 2000 + v[0] : 1900 + v[0];
+        d = 1;
+    } else {
+        t->year = v[0] * 100 + v[1];
+        d = 2;
+    }
+    t->mon = v[d];
+    t->day = v[d + 1];
+    t->hour = v[d + 2];
+    t->min = v[d + 3];
+    t->sec = v[d + 4];
+    return 0;
+}
+
+/**
+ * @brief Map the signature AlgorithmIdentifier to its hash
+ * @param p AlgorithmIdentifier content
+ * @param len Length of @p p
+ * @param md_alg Hash of the signature
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+static int crl_index_sig_alg(const uint8_t *p, size_t len, mbedtls_md_type_t *md_alg)
+{
+    /* ECDSA takes no parameters: the OID is the whole content */
+    if (len != 2 + sizeof(crl_index_oid_ecdsa) + 1 || p[0] != MBEDTLS_ASN1_OID ||
+        p[1] != sizeof(crl_index_oid_ecdsa) + 1 ||
+        memcmp(p + 2, crl_index_oid_ecdsa, sizeof(crl_index_oid_ecdsa)) != 0) {
+        return MBEDTLS_ERR_X509_UNKNOWN_SIG_ALG;
+    }
+
+    switch (p[len - 1]) {
+    case 2: *md_alg = MBEDTLS_MD_SHA256; break;
+    case 3: *md_alg = MBEDTLS_MD_SHA384; break;
+    case 4: *md_alg = MBEDTLS_MD_SHA512; break;
+    default: return MBEDTLS_ERR_X509_UNKNOWN_SIG_ALG;
+    }
+    return 0;
+}
+
+/* Consume bytes of the CRL, hashing those of the TBSCertList */
+static int crl_index_consume(crl_index_parser_t *parser, const uint8_t *p, size_t len)
+{
+    if (parser->hashing && len > 0 &&
+        psa_hash_update(&parser->hash, p, len) != PSA_SUCCESS) {
+        return MBEDTLS_ERR_X509_FATAL_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse the TBSCertList header, its version and its signature
+ *        algorithm, then start hashing
+ * @param parser Streaming state
+ * @param p Element start
+ * @param avail Bytes available at @p p
+ * @param used Bytes consumed
+ * @retval 0 if successful, CRL_INDEX_MORE, an mbedTLS error code otherwise
+ */
+static int crl_index_parse_tbs(crl_index_parser_t *parser, const uint8_t *p, size_t avail,
+                               size_t *used)
+{
+    const mbedtls_x509_crt_profile *profile = parser->profile;
+    uint8_t tag;
+    size_t pos = parser->offset;
+    size_t hdr;
+    size_t len;
+    size_t off;
+    int ret;
+
+    ret = crl_index_tlv(p, avail, &tag, &hdr, &len);
+    if (ret != 0) {
+        return ret;
+    }
+    if (tag != (MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE) ||
+        !crl_index_within(pos, hdr, len, parser->outer_end)) {
+        return MBEDTLS_ERR_X509_INVALID_FORMAT;
+    }
+    parser->tbs_end = pos + hdr + len;
+    off = hdr;
+
+    /* Version, v2 when present */
+    if (avail > off && p[off] == MBEDTLS_ASN1_INTEGER) {
+        ret = crl_index_element(p + off, avail - off, len, MBEDTLS_ASN1_INTEGER, &hdr, &len);
+        if (ret != 0) {
+            return ret;
+        }
+        if (len != 1 || p[off + hdr] != 1) {
+            return MBEDTLS_ERR_X509_INVALID_VERSION;
+        }
+        off += hdr + len;
+    } else if (avail <= off) {
+        return CRL_INDEX_MORE;
+    }
+
+    ret = crl_index_element(p + off, avail - off, parser->tbs_end - pos - off,
+                            MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE, &hdr, &len);
+    if (ret != 0) {
+        return ret;
+    }
+    if (hdr + len > sizeof(parser->sig_alg)) {
+        return MBEDTLS_ERR_X509_UNKNOWN_SIG_ALG;
+    }
+    ret = crl_index_sig_alg(p + off + hdr, len, &parser->md_alg);
+    if (ret != 0) {
+        return ret;
+    }
+    if (profile != NULL &&
+        (profile->allowed_mds & MBEDTLS_X509_ID_FLAG(parser->md_alg)) == 0) {
+        return MBEDTLS_ERR_X509_CERT_VERIFY_FAILED;
+    }
+    memcpy(parser->sig_alg, p + off, hdr + len);
+    parser->sig_alg_len = (uint8_t)(hdr + len);
+    off += hdr + len;
+
+    if (psa_hash_setup(&parser->hash, mbedtls_md_psa_alg_from_type(parser->md_alg)) !=
+        PSA_SUCCESS) {
+        return MBEDTLS_ERR_X509_FATAL_ERROR;
+    }
+    parser->hashing = 1;
+
+    *used = off;
+    return crl_index_consume(parser, p, off);
+}
+
+/**
+ * @brief Parse the next element in the current state
+ * @param parser Streaming state
+ * @param p Element start
+ * @param avail Bytes available at @p p
+ * @param used Bytes consumed, possibly 0 on a state change
+ * @retval 0 if successful, CRL_INDEX_MORE, an mbedTLS error code otherwise
+ */
+static int crl_index_step(crl_index_parser_t *parser, const uint8_t *p, size_t avail,
+                          size_t *used)
+{
+    crl_index_t *index = parser->index;
+    mbedtls_x509_time *t;
+    size_t pos = parser->offset;
+    uint8_t tag;
+    size_t hdr;
+    size_t len;
+    size_t shdr;
+    size_t slen;
+    size_t digest_len;
+    int ret;
+
+    *used = 0;
+
+    switch (parser->state) {
+    case CRL_INDEX_S_OUTER:
+        ret = crl_index_tlv(p, avail, &tag, &hdr, &len);
+        if (ret != 0) {
+            return ret;
+        }
+        if (tag != (MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE)) {
+            return MBEDTLS_ERR_X509_INVALID_FORMAT;
+        }
+        parser->outer_end = pos + hdr + len;
+        parser->state = CRL_INDEX_S_TBS;
+        *used = hdr;
+        return 0;
+
+    case CRL_INDEX_S_TBS:
+        ret = crl_index_parse_tbs(parser, p, avail, used);
+        if (ret == 0) {
+            parser->state = CRL_INDEX_S_ISSUER;
+        }
+        return ret;
+
+    case CRL_INDEX_S_ISSUER:
+        ret = crl_index_element(p, avail, parser->tbs_end - pos,
+                                MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE, &hdr, &len);
+        if (ret != 0) {
+            return ret;
+        }
+        /* Same comparison as mbedTLS does for a parsed CRL */
+        if (hdr + len != parser->ca->subject_raw.len ||
+            memcmp(p, parser->ca->subject_raw.p, hdr + len) != 0) {
+            return MBEDTLS_ERR_X509_BAD_INPUT_DATA;
+        }
+        index->issuer_key = crl_index_hash(p, hdr + len);
+        parser->state = CRL_INDEX_S_THIS_UPDATE;
+        break;
+
+    case CRL_INDEX_S_THIS_UPDATE:
+    case CRL_INDEX_S_NEXT_UPDATE:
+        if (parser->state == CRL_INDEX_S_NEXT_UPDATE &&
+            (pos == parser->tbs_end || (avail > 0 && p[0] != MBEDTLS_ASN1_UTC_TIME &&
+                                        p[0] != MBEDTLS_ASN1_GENERALIZED_TIME))) {
+            /* nextUpdate is optional */
+            parser->state = CRL_INDEX_S_REVOKED;
+            return 0;
+        }
+        if (avail == 0) {
+            return CRL_INDEX_MORE;
+        }
+        ret = crl_index_element(p, avail, parser->tbs_end - pos, p[0], &hdr, &len);
+        if (ret != 0) {
+            return ret;
+        }
+        if (parser->state == CRL_INDEX_S_THIS_UPDATE) {
+            t = &index->this_update;
+            parser->state = CRL_INDEX_S_NEXT_UPDATE;
+        } else {
+            t = &index->next_update;
+            index->has_next_update = 1;
+            parser->state = CRL_INDEX_S_REVOKED;
+        }
+        ret = crl_index_time(p[0], p + hdr, len, t);
+        if (ret != 0) {
+            return ret;
+        }
+        break;
+
+    case CRL_INDEX_S_REVOKED:
+        if (pos == parser->tbs_end) {
+            parser->hashing = 0;
+            if (psa_hash_finish(&parser->hash, parser->digest, sizeof(parser->digest),
+                                &digest_len) != PSA_SUCCESS) {
+                return MBEDTLS_ERR_X509_FATAL_ERROR;
+            }
+            parser->digest_len = digest_len;
+            parser->state = CRL_INDEX_S_SIG_ALG;
+            return 0;
+        }
+        ret = crl_index_tlv(p, avail, &tag, &hdr, &len);
+        if (ret != 0) {
+            return ret;
+        }
+        if (!crl_index_within(pos, hdr, len, parser->tbs_end)) {
+            return MBEDTLS_ERR_X509_INVALID_FORMAT;
+        }
+        if (tag == (MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE) &&
+            parser->revoked_end == 0) {
+            /* revokedCertificates, entries follow */
+            parser->revoked_end = pos + hdr + len;
+            parser->state = CRL_INDEX_S_ENTRY;
+            *used = hdr;
+            return crl_index_consume(parser, p, hdr);
+        }
+        if (tag == (MBEDTLS_ASN1_CONTEXT_SPECIFIC | MBEDTLS_ASN1_CONSTRUCTED | 0)) {
+            /* crlExtensions, nothing in there changes the index */
+            parser->skip = hdr + len;
+            return 0;
+        }
+        return MBEDTLS_ERR_X509_INVALID_FORMAT;
+
+    case CRL_INDEX_S_ENTRY:
+        if (pos == parser->revoked_end) {
+            parser->state = CRL_INDEX_S_REVOKED;
+            return 0;
+        }
+        ret = crl_index_tlv(p, avail, &tag, &hdr, &len);
+        if (ret != 0) {
+            return ret;
+        }
+        if (tag != (MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE) ||
+            !crl_index_within(pos, hdr, len, parser->revoked_end)) {
+            return MBEDTLS_ERR_X509_INVALID_FORMAT;
+        }
+        ret = crl_index_element(p + hdr, avail - hdr, len, MBEDTLS_ASN1_INTEGER, &shdr, &slen);
+        if (ret != 0) {
+            return ret;
+        }
+        if (slen == 0 || slen > CRL_INDEX_MAX_SERIAL_LEN) {
+            return MBEDTLS_ERR_X509_INVALID_SERIAL;
+        }
+        if (index->count == index->capacity) {
+            return MBEDTLS_ERR_X509_BUFFER_TOO_SMALL;
+        }
+        index->keys[index->count++] = crl_index_key(p + hdr + shdr, slen);
+        /* revocationDate and entry extensions are hashed, not kept */
+        parser->skip = len - shdr - slen;
+        *used = hdr + shdr + slen;
+        return crl_index_consume(parser, p, *used);
+
+    case CRL_INDEX_S_SIG_ALG:
+        ret = crl_index_element(p, avail, parser->outer_end - pos,
+                                MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE, &hdr, &len);
+        if (ret != 0) {
+            return ret;
+        }
+        if (hdr + len != parser->sig_alg_len || memcmp(p, parser->sig_alg, hdr + len) != 0) {
+            return MBEDTLS_ERR_X509_SIG_MISMATCH;
+        }
+        parser->state = CRL_INDEX_S_SIG;
+        break;
+
+    case CRL_INDEX_S_SIG:
+        ret = crl_index_element(p, avail, parser->outer_end - pos, MBEDTLS_ASN1_BIT_STRING,
+                                &hdr, &len);
+        if (ret != 0) {
+            return ret;
+        }
+        if (!crl_index_within(pos, hdr, len, parser->outer_end) ||
+            len != parser->outer_end - pos - hdr || len < 2 || p[hdr] != 0) {
+            return MBEDTLS_ERR_X509_INVALID_FORMAT;
+        }
+        ret = mbedtls_pk_verify_ext(MBEDTLS_PK_SIGALG_ECDSA, &parser->ca->pk, parser->md_alg,
+                                    parser->digest, parser->digest_len, p + hdr + 1, len - 1);
+        if (ret != 0) {
+            return ret;
+        }
+        parser->state = CRL_INDEX_S_DONE;
+        break;
+
+    default:
+        return MBEDTLS_ERR_X509_INVALID_FORMAT;
+    }
+
+    *used = hdr + len;
+    return crl_index_consume(parser, p, *used);
+}
+
+/**
+ * @brief Consume as many elements as the carry buffer holds
+ * @param parser Streaming state
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+static int crl_index_parse(crl_index_parser_t *parser)
+{
+    size_t off = 0;
+    size_t used;
+    size_t n;
+    int ret = 0;
+
+    while (parser->state != CRL_INDEX_S_DONE) {
+        if (parser->skip > 0) {
+            n = parser->fill - off < parser->skip ? parser->fill - off : parser->skip;
+            if (n == 0) {
+                break;
+            }
+            ret = crl_index_consume(parser, parser->carry + off, n);
+            if (ret != 0) {
+                return ret;
+            }
+            parser->skip -= n;
+            parser->offset += n;
+            off += n;
+            continue;
+        }
+
+        ret = crl_index_step(parser, parser->carry + off, parser->fill - off, &used);
+        if (ret == CRL_INDEX_MORE) {
+            ret = 0;
+            break;
+        }
+        if (ret != 0) {
+            return ret;
+        }
+        parser->offset += used;
+        off += used;
+    }
+
+    if (parser->state == CRL_INDEX_S_DONE && off != parser->fill) {
+        return MBEDTLS_ERR_X509_INVALID_FORMAT;
+    }
+
+    memmove(parser->carry, parser->carry + off, parser->fill - off);
+    parser->fill -= off;
+    if (parser->fill == CRL_INDEX_CARRY_LEN) {
+        return MBEDTLS_ERR_X509_BUFFER_TOO_SMALL;
+    }
+    return ret;
+}
+
+/**
+ * @brief Attach an empty index to its arena
+ * @param index Index to set up
+ * @param arena Key storage, 8-byte aligned, must stay valid
+ * @param arena_len Length of @p arena, see CRL_INDEX_ARENA_LEN()
+ */
+void crl_index_init(crl_index_t *index, void *arena, size_t arena_len)
+{
+    memset(index, 0, sizeof(*index));
+    index->keys = arena;
+    index->capacity = (uint32_t)(arena_len / sizeof(uint64_t));
+}
+
+/**
+ * @brief Start streaming a CRL into an index
+ * @param parser Streaming state
+ * @param index Index set up with crl_index_init()
+ * @param ca CA that issued the CRL, must stay valid until crl_index_finish()
+ * @param profile Hashes the CRL signature may use, or NULL to accept any
+ *        supported one
+ * @retval 0 if successful, non-zero otherwise
+ */
+int crl_index_begin(crl_index_parser_t *parser, crl_index_t *index, mbedtls_x509_crt *ca,
+                    const mbedtls_x509_crt_profile *profile)
+{
+    if (index->keys == NULL || ca == NULL) {
+        return MBEDTLS_ERR_X509_BAD_INPUT_DATA;
+    }
+
+    memset(parser, 0, sizeof(*parser));
+    parser->index = index;
+    parser->ca = ca;
+    parser->profile = profile;
+    parser->hash = psa_hash_operation_init();
+
+    index->ready = 0;
+    index->count = 0;
+    index->has_next_update = 0;
+    return 0;
+}
+
+/**
+ * @brief Feed the next chunk of the CRL DER
+ * @param parser Streaming state from crl_index_begin()
+ * @param data Next bytes of the CRL
+ * @param len Length of @p data, any size
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int crl_index_update(crl_index_parser_t *parser, const uint8_t *data, size_t len)
+{
+    uint32_t start = board_timing_cycles();
+    size_t n;
+    int ret = 0;
+
+    if (parser->state == CRL_INDEX_S_FAILED) {
+        return MBEDTLS_ERR_X509_BAD_INPUT_DATA;
+    }
+
+    while (len > 0 && ret == 0) {
+        if (parser->state == CRL_INDEX_S_DONE) {
+            ret = MBEDTLS_ERR_X509_INVALID_FORMAT;
+            break;
+        }
+
+        /* The tail of a revoked entry goes to the hash without a copy */
+        if (parser->skip > 0 && parser->fill == 0) {
+            n = len < parser->skip ? len : parser->skip;
+            ret = crl_index_consume(parser, data, n);
+            parser->skip -= n;
+            parser->offset += n;
+            data += n;
+            len -= n;
+            continue;
+        }
+
+        n = CRL_INDEX_CARRY_LEN - parser->fill;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(parser->carry + parser->fill, data, n);
+        parser->fill += n;
+        data += n;
+        len -= n;
+        ret = crl_index_parse(parser);
+    }
+
+    parser->cycles += board_timing_cycles() - start;
+    if (ret != 0) {
+        crl_index_abort(parser);
+    }
+    return ret;
+}
+
+/**
+ * @brief Check that the whole CRL was fed and make the index usable
+ * @param parser Streaming state from crl_index_begin()
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int crl_index_finish(crl_index_parser_t *parser)
+{
+    crl_index_t *index = parser->index;
+    uint32_t start = board_timing_cycles();
+
+    if (parser->state != CRL_INDEX_S_DONE) {
+        crl_index_abort(parser);
+        return MBEDTLS_ERR_X509_INVALID_FORMAT;
+    }
+
+    qsort(index->keys, index->count, sizeof(index->keys[0]), crl_index_key_cmp);
+    index->ready = 1;
+
+    parser->cycles += board_timing_cycles() - start;
+    index->stats.load_cycles = parser->cycles;
+    return 0;
+}
+
+/**
+ * @brief Give up on a CRL being streamed
+ * @param parser Streaming state from crl_index_begin()
+ */
+void crl_index_abort(crl_index_parser_t *parser)
+{
+    psa_hash_abort(&parser->hash);
+    parser->hashing = 0;
+    parser->state = CRL_INDEX_S_FAILED;
+    parser->index->ready = 0;
+    parser->index->count = 0;
+}
+
+/**
+ * @brief Look a serial number up in the index
+ * @param index Index loaded with crl_index_finish()
+ * @param serial Serial number content, as in mbedtls_x509_crt.serial
+ * @param len Length of @p serial
+ * @retval 1 if the serial number is listed, 0 otherwise
+ */
+int crl_index_lookup(crl_index_t *index, const uint8_t *serial, size_t len)
+{
+    uint32_t start = board_timing_cycles();
+    uint64_t key = crl_index_key(serial, len);
+    uint32_t lo = 0;
+    uint32_t hi = index->count;
+    uint32_t mid;
+    int found = 0;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (index->keys[mid] < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo < index->count && index->keys[lo] == key) {
+        found = 1;
+        index->stats.revoked++;
+    }
+
+    index->stats.lookups++;
+    index->stats.lookup_cycles += board_timing_cycles() - start;
+    return found;
+}
+
+/**
+ * @brief Check a certificate against the index
+ * @param index Index loaded with crl_index_finish()
+ * @param crt Certificate to check
+ * @param flags Verification flags to update
+ */
+void crl_index_check(crl_index_t *index, const mbedtls_x509_crt *crt, uint32_t *flags)
+{
+    if (!index->ready ||
+        crl_index_hash(crt->issuer_raw.p, crt->issuer_raw.len) != index->issuer_key) {
+        return;
+    }
+
+#if defined(MBEDTLS_HAVE_TIME_DATE)
+    if (index->has_next_update && mbedtls_x509_time_is_past(&index->next_update)) {
+        *flags |= MBEDTLS_X509_BADCRL_EXPIRED;
+    }
+    if (mbedtls_x509_time_is_future(&index->this_update)) {
+        *flags |= MBEDTLS_X509_BADCRL_FUTURE;
+    }
+#endif
+
+    if (crl_index_lookup(index, crt->serial.p, crt->serial.len)) {
+        *flags |= MBEDTLS_X509_BADCERT_REVOKED;
+    }
+}
+
+/**
+ * @brief Verification callback checking each certificate of the chain
+ */
+int crl_index_verify_cb(void *p_ctx, mbedtls_x509_crt *crt, int depth, uint32_t *flags)
+{
+    (void)depth;
+
+    crl_index_check(p_ctx, crt, flags);
+    return 0;
+}
+
+/**
+ * @brief Get revocation index counters
+ * @param index Index set up with crl_index_init()
+ * @param stats Filled with the current counters
+ */
+void crl_index_get_stats(const crl_index_t *index, crl_index_stats_t *stats)
+{
+    *stats = index->stats;
+}
+
+/**
+ * @brief Reset revocation index counters
+ * @param index Index set up with crl_index_init()
+ */
+void crl_index_reset_stats(crl_index_t *index)
+{
+    memset(&index->stats, 0, sizeof(index->stats));
+}
+
+#endif /* MBEDTLS_X509_CRT_PARSE_C */
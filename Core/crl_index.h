@@ -0,0 +1,190 @@
+/**
+ * @file crl_index.h
+ * @brief Streaming CRL ingestion into a sorted revocation index
+ *
+ * mbedtls_x509_crl_parse_der() needs the whole CRL in RAM and turns every
+ * revoked certificate into a heap node that mbedtls_x509_crt_is_revoked()
+ * then walks one by one. Here the CRL is fed in chunks of any size as it
+ * arrives, and each revoked serial number becomes one 64-bit key in an arena
+ * supplied by the caller: CRL_INDEX_ARENA_LEN(n) bytes for n entries, nothing
+ * taken from the heap. The TBSCertList is hashed on the fly and the signature
+ * is checked against the issuing CA at the end; the keys are then sorted and
+ * every revocation check is a binary search.
+ *
+ * Keys are FNV-1a 64 of the serial number without leading zero bytes. A key
+ * collision can only report a good certificate as revoked, never the other
+ * way round.
+ *
+ * crl_index_verify_cb() plugs the index into mbedtls_ssl_conf_verify() or
+ * mbedtls_x509_crt_verify(). Like any verification callback it makes mbedTLS
+ * skip the verified-chain cache.
+ */
+
+#ifndef CRL_INDEX_H
+#define CRL_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mbedtls/x509_crt.h"
+#include "psa/crypto.h"
+
+/* Largest CRL element kept whole while streaming: issuer Name, one revoked
+ * entry up to its serial number, or the signature */
+#ifndef CRL_INDEX_CARRY_LEN
+#define CRL_INDEX_CARRY_LEN 1024
+#endif
+
+/* Arena bytes needed for a CRL with the given number of entries */
+#define CRL_INDEX_ARENA_LEN(entries) ((size_t)(entries) * sizeof(uint64_t))
+
+/**
+ * @brief Revocation index counters, cycle totals are from board_timing_cycles()
+ */
+typedef struct {
+    uint32_t lookups;
+    uint32_t revoked;
+    uint32_t lookup_cycles;
+    uint32_t load_cycles;
+} crl_index_stats_t;
+
+/**
+ * @brief Revocation index of one CA, keys live in the caller's arena
+ */
+typedef struct {
+    uint64_t *keys;
+    uint32_t capacity;
+    uint32_t count;
+    uint64_t issuer_key;
+    mbedtls_x509_time this_update;
+    mbedtls_x509_time next_update;
+    uint8_t has_next_update;
+    uint8_t ready;
+    crl_index_stats_t stats;
+} crl_index_t;
+
+/**
+ * @brief State of one CRL being streamed into an index
+ *
+ * Only needed while loading, it can live on the stack.
+ */
+typedef struct {
+    crl_index_t *index;
+    mbedtls_x509_crt *ca;
+    const mbedtls_x509_crt_profile *profile;
+    psa_hash_operation_t hash;
+    mbedtls_md_type_t md_alg;
+    uint8_t digest[PSA_HASH_MAX_SIZE];
+    size_t digest_len;
+    size_t offset;
+    size_t outer_end;
+    size_t tbs_end;
+    size_t revoked_end;
+    size_t skip;
+    size_t fill;
+    uint32_t cycles;
+    uint8_t state;
+    uint8_t hashing;
+    uint8_t sig_alg_len;
+    uint8_t sig_alg[16];
+    uint8_t carry[CRL_INDEX_CARRY_LEN];
+} crl_index_parser_t;
+
+/**
+ * @brief Attach an empty index to its arena
+ * @param index Index to set up
+ * @param arena Key storage, 8-byte aligned, must stay valid
+ * @param arena_len Length of @p arena, see CRL_INDEX_ARENA_LEN()
+ */
+void crl_index_init(crl_index_t *index, void *arena, size_t arena_len);
+
+/**
+ * @brief Start streaming a CRL into an index
+ *
+ * The index is emptied and stays unusable until crl_index_finish() succeeds.
+ * To keep checking against the previous CRL while a new one downloads, load
+ * the new one into a second index and swap them.
+ *
+ * @param parser Streaming state
+ * @param index Index set up with crl_index_init()
+ * @param ca CA that issued the CRL, must stay valid until crl_index_finish()
+ * @param profile Hashes the CRL signature may use, or NULL to accept any
+ *        supported one
+ * @retval 0 if successful, non-zero otherwise
+ */
+int crl_index_begin(crl_index_parser_t *parser, crl_index_t *index, mbedtls_x509_crt *ca,
+                    const mbedtls_x509_crt_profile *profile);
+
+/**
+ * @brief Feed the next chunk of the CRL DER
+ * @param parser Streaming state from crl_index_begin()
+ * @param data Next bytes of the CRL
+ * @param len Length of @p data, any size
+ * @retval 0 if successful, an mbedTLS error code if the CRL is malformed,
+ *         not issued by the CA, badly signed or has more entries than the
+ *         arena holds
+ */
+int crl_index_update(crl_index_parser_t *parser, const uint8_t *data, size_t len);
+
+/**
+ * @brief Check that the whole CRL was fed and make the index usable
+ * @param parser Streaming state from crl_index_begin()
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int crl_index_finish(crl_index_parser_t *parser);
+
+/**
+ * @brief Give up on a CRL being streamed
+ * @param parser Streaming state from crl_index_begin()
+ */
+void crl_index_abort(crl_index_parser_t *parser);
+
+/**
+ * @brief Look a serial number up in the index
+ * @param index Index loaded with crl_index_finish()
+ * @param serial Serial number content, as in mbedtls_x509_crt.serial
+ * @param len Length of @p serial
+ * @retval 1 if the serial number is listed, 0 otherwise
+ */
+int crl_index_lookup(crl_index_t *index, const uint8_t *serial, size_t len);
+
+/**
+ * @brief Check a certificate against the index, as mbedTLS checks it
+ *        against a parsed CRL
+ *
+ * Certificates of other issuers are left alone. For the others the CRL
+ * validity sets MBEDTLS_X509_BADCRL_EXPIRED or MBEDTLS_X509_BADCRL_FUTURE and
+ * a listed serial number sets MBEDTLS_X509_BADCERT_REVOKED. Every listed
+ * serial number counts as revoked, whatever its revocationDate.
+ *
+ * @param index Index loaded with crl_index_finish()
+ * @param crt Certificate to check
+ * @param flags Verification flags to update
+ */
+void crl_index_check(crl_index_t *index, const mbedtls_x509_crt *crt, uint32_t *flags);
+
+/**
+ * @brief Verification callback checking each certificate of the chain,
+ *        see mbedtls_ssl_conf_verify()
+ * @param p_ctx Index loaded with crl_index_finish(), or not loaded yet to
+ *        skip revocation checks
+ * @param crt Certificate being verified
+ * @param depth Depth of @p crt in the chain
+ * @param flags Verification flags of @p crt
+ * @retval 0
+ */
+int crl_index_verify_cb(void *p_ctx, mbedtls_x509_crt *crt, int depth, uint32_t *flags);
+
+/**
+ * @brief Get revocation index counters
+ * @param index Index set up with crl_index_init()
+ * @param stats Filled with the current counters
+ */
+void crl_index_get_stats(const crl_index_t *index, crl_index_stats_t *stats);
+
+/**
+ * @brief Reset revocation index counters
+ * @param index Index set up with crl_index_init()
+ */
+void crl_index_reset_stats(crl_index_t *index);
+
+#endif /* CRL_INDEX_H */
@@ -0,0 +1,476 @@
+/**
+ * @file dtls_client.c
+ * @brief DTLS 1.2 telemetry client with Connection ID for sleepy devices
+ *
+ * The client offers an empty CID of its own: it has its own socket, so it
+ * needs no ID to find the connection, while the server's CID goes into every
+ * record the client sends. Retransmissions run on the millisecond tick
+ * through board_timing_set_delay()/board_timing_get_delay(), since the
+ * timing.c implementation only builds on POSIX and Windows.
+ */
+
+#include "dtls_client.h"
+#include "se05x_init.h"
+#include "se05x_async.h"
+#include "se05x_ecdh.h"
+#include "se05x_session.h"
+#include "tls_profile.h"
+#include "board_timing.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/entropy.h"
+#include "sss_mbedtls.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(MBEDTLS_SSL_PROTO_DTLS) && defined(MBEDTLS_SSL_DTLS_CONNECTION_ID) && \
+    defined(MBEDTLS_NET_C)
+
+static mbedtls_net_context dtls_fd;
+static mbedtls_entropy_context dtls_entropy;
+static mbedtls_ctr_drbg_context dtls_ctr_drbg;
+static mbedtls_ssl_context dtls_ssl;
+static mbedtls_ssl_config dtls_conf;
+static board_timing_delay_t dtls_timer;
+
+/* Last negotiated session, resumed when the connection state is lost */
+static mbedtls_ssl_session dtls_session;
+static int dtls_session_valid;
+
+/* The server put a CID in its ServerHello */
+static int dtls_cid_in_use;
+static int dtls_open;
+
+static dtls_client_stats_t dtls_stats;
+
+/* Handshake profile, reported if tls_profile_set_report() was called */
+static tls_profile_t dtls_profile;
+
+/**
+ * @brief Send callback counting traffic
+ */
+static int dtls_client_net_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    int ret = mbedtls_net_send(ctx, buf, len);
+
+    if (ret > 0) {
+        dtls_stats.bytes_sent += (uint32_t)ret;
+        dtls_stats.datagrams_sent++;
+    }
+    return ret;
+}
+
+/**
+ * @brief Receive callback counting traffic
+ */
+static int dtls_client_net_recv(void *ctx, unsigned char *buf, size_t len, uint32_t timeout)
+{
+    int ret = mbedtls_net_recv_timeout(ctx, buf, len, timeout);
+
+    if (ret > 0) {
+        dtls_stats.bytes_received += (uint32_t)ret;
+        dtls_stats.datagrams_received++;
+    }
+    return ret;
+}
+
+/**
+ * @brief Set up the contexts for one transport
+ * @param transport MBEDTLS_SSL_TRANSPORT_DATAGRAM, or
+ *        MBEDTLS_SSL_TRANSPORT_STREAM for the TLS comparison
+ * @param trust_ca CAs the server chain must verify against
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int dtls_client_setup(int transport, mbedtls_x509_crt *trust_ca)
+{
+    const char *pers = "dtls_client";
+    sss_status_t status;
+    int ret;
+
+    mbedtls_net_init(&dtls_fd);
+    mbedtls_ssl_init(&dtls_ssl);
+    mbedtls_ssl_config_init(&dtls_conf);
+    mbedtls_ctr_drbg_init(&dtls_ctr_drbg);
+    mbedtls_entropy_init(&dtls_entropy);
+    dtls_open = 1;
+
+    if ((ret = mbedtls_ctr_drbg_seed(&dtls_ctr_drbg, mbedtls_entropy_func, &dtls_entropy,
+                                     (const unsigned char *) pers, strlen(pers))) != 0) {
+        printf("ERROR: mbedtls_ctr_drbg_seed returned -0x%04X\n", -ret);
+        return -1;
+    }
+
+    if ((ret = mbedtls_ssl_config_defaults(&dtls_conf, MBEDTLS_SSL_IS_CLIENT, transport,
+                                           MBEDTLS_SSL_PRESET_DEFAULT)) != 0) {
+        printf("ERROR: mbedtls_ssl_config_defaults returned -0x%04X\n", -ret);
+        return -1;
+    }
+    mbedtls_ssl_conf_rng(&dtls_conf, mbedtls_ctr_drbg_random, &dtls_ctr_drbg);
+    mbedtls_ssl_conf_ca_chain(&dtls_conf, trust_ca, NULL);
+    mbedtls_ssl_conf_read_timeout(&dtls_conf, DTLS_READ_TIMEOUT_MS);
+
+    if (transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
+        mbedtls_ssl_conf_handshake_timeout(&dtls_conf, DTLS_HANDSHAKE_TIMEOUT_MIN_MS,
+                                           DTLS_HANDSHAKE_TIMEOUT_MAX_MS);
+        /* Records with another CID are stale, drop them */
+        if ((ret = mbedtls_ssl_conf_cid(&dtls_conf, 0,
+                                        MBEDTLS_SSL_UNEXPECTED_CID_IGNORE)) != 0) {
+            printf("ERROR: mbedtls_ssl_conf_cid returned -0x%04X\n", -ret);
+            return -1;
+        }
+    } else {
+        /* Compare with TLS 1.2, whose session is complete after the
+         * handshake like the DTLS one */
+        mbedtls_ssl_conf_max_tls_version(&dtls_conf, MBEDTLS_SSL_VERSION_TLS1_2);
+    }
+
+    /* Same SE05x client key as the TLS client */
+    status = sss_mbedtls_associate_keypair(&dtls_ssl, &g_tls_key);
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: Failed to associate SE05x key with mbed TLS (status = 0x%X)\n", status);
+        return -1;
+    }
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+    se05x_async_conf(&dtls_conf, &g_tls_key);
+#endif
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+    se05x_ecdh_conf(&dtls_conf);
+#endif
+
+    if ((ret = mbedtls_ssl_setup(&dtls_ssl, &dtls_conf)) != 0) {
+        printf("ERROR: mbedtls_ssl_setup returned -0x%04X\n", -ret);
+        return -1;
+    }
+    if ((ret = mbedtls_ssl_set_hostname(&dtls_ssl, DTLS_SERVER_NAME)) != 0) {
+        printf("ERROR: mbedtls_ssl_set_hostname returned -0x%04X\n", -ret);
+        return -1;
+    }
+
+    if (transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
+        if ((ret = mbedtls_ssl_set_cid(&dtls_ssl, MBEDTLS_SSL_CID_ENABLED, NULL, 0)) != 0) {
+            printf("ERROR: mbedtls_ssl_set_cid returned -0x%04X\n", -ret);
+            return -1;
+        }
+        mbedtls_ssl_set_timer_cb(&dtls_ssl, &dtls_timer,
+                                 board_timing_set_delay, board_timing_get_delay);
+        mbedtls_ssl_set_mtu(&dtls_ssl, DTLS_CLIENT_MTU);
+    }
+    tls_profile_set_bio(&dtls_profile, &dtls_ssl, &dtls_fd, dtls_client_net_send, NULL,
+                        dtls_client_net_recv);
+    return 0;
+}
+
+/**
+ * @brief Connect the socket of the current transport
+ * @param transport Transport the contexts were set up for
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int dtls_client_connect(int transport)
+{
+    int ret;
+
+    if (transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
+        ret = mbedtls_net_connect(&dtls_fd, DTLS_SERVER_NAME, DTLS_SERVER_PORT,
+                                  MBEDTLS_NET_PROTO_UDP);
+    } else {
+        ret = mbedtls_net_connect(&dtls_fd, DTLS_SERVER_NAME, DTLS_TLS_SERVER_PORT,
+                                  MBEDTLS_NET_PROTO_TCP);
+    }
+    if (ret != 0) {
+        printf("ERROR: mbedtls_net_connect returned -0x%04X\n", -ret);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Run the handshake and remember the session
+ * @param resuming A session was set with mbedtls_ssl_set_session()
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int dtls_client_handshake(int resuming)
+{
+    uint32_t start = board_timing_cycles();
+    int ret;
+
+    while ((ret = tls_profile_handshake(&dtls_profile, &dtls_ssl)) != 0) {
+        if (ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+            se05x_async_poll();
+            continue;
+        }
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            printf("ERROR: mbedtls_ssl_handshake returned -0x%04X\n", -ret);
+            return -1;
+        }
+    }
+    dtls_stats.handshake_cycles += board_timing_cycles() - start;
+    dtls_stats.handshakes++;
+    if (resuming) {
+        dtls_stats.resumptions++;
+    }
+
+    if (mbedtls_ssl_get_verify_result(&dtls_ssl) != 0) {
+        printf("Certificate verification failed\n");
+        return -1;
+    }
+
+    /* Fails over TCP, where there is no CID */
+    if (mbedtls_ssl_get_peer_cid(&dtls_ssl, &dtls_cid_in_use, NULL, NULL) != 0) {
+        dtls_cid_in_use = MBEDTLS_SSL_CID_DISABLED;
+    }
+
+    mbedtls_ssl_session_free(&dtls_session);
+    mbedtls_ssl_session_init(&dtls_session);
+    dtls_session_valid = mbedtls_ssl_get_session(&dtls_ssl, &dtls_session) == 0;
+    return 0;
+}
+
+/**
+ * @brief Open the DTLS connection to the telemetry server
+ * @param trust_ca CAs the server chain must verify against
+ * @retval 0 if successful, non-zero otherwise
+ */
+int dtls_client_open(mbedtls_x509_crt *trust_ca)
+{
+    int resuming;
+
+    if (dtls_client_setup(MBEDTLS_SSL_TRANSPORT_DATAGRAM, trust_ca) != 0 ||
+        dtls_client_connect(MBEDTLS_SSL_TRANSPORT_DATAGRAM) != 0) {
+        dtls_client_close();
+        return -1;
+    }
+
+    resuming = se05x_session_load(SE05X_SESSION_SLOT_DTLS, &dtls_ssl, DTLS_SERVER_NAME) == 0;
+    if (dtls_client_handshake(resuming) != 0) {
+        dtls_client_close();
+        return -1;
+    }
+
+    if (se05x_session_save(SE05X_SESSION_SLOT_DTLS, &dtls_ssl, DTLS_SERVER_NAME) != 0) {
+        printf("WARNING: DTLS session not stored\n");
+    }
+    printf("DTLS connection open, %s, CID %s\n", mbedtls_ssl_get_ciphersuite(&dtls_ssl),
+           dtls_cid_in_use == MBEDTLS_SSL_CID_ENABLED ? "in use" : "refused by server");
+    return 0;
+}
+
+/**
+ * @brief Send one telemetry record
+ * @param data Record payload
+ * @param len Length of @p data
+ * @retval Number of bytes sent, negative on error
+ */
+int dtls_client_send(const uint8_t *data, size_t len)
+{
+    int ret;
+
+    do {
+        ret = mbedtls_ssl_write(&dtls_ssl, data, len);
+    } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+
+    if (ret < 0) {
+        printf("ERROR: mbedtls_ssl_write returned -0x%04X\n", -ret);
+    }
+    return ret;
+}
+
+/**
+ * @brief Wait for the next record from the server
+ * @param buf Output buffer
+ * @param size Size of @p buf
+ * @retval Number of bytes received, negative on error or timeout
+ */
+int dtls_client_recv(uint8_t *buf, size_t size)
+{
+    int ret;
+
+    do {
+        ret = mbedtls_ssl_read(&dtls_ssl, buf, size);
+    } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_TIMEOUT) {
+        printf("ERROR: mbedtls_ssl_read returned -0x%04X\n", -ret);
+    }
+    return ret == 0 ? -1 : ret;
+}
+
+/**
+ * @brief Close the socket before sleeping, the DTLS state is kept
+ */
+void dtls_client_sleep(void)
+{
+    mbedtls_net_free(&dtls_fd);
+}
+
+/**
+ * @brief Reopen the socket and, if needed, resume the session
+ * @param resume Resume even if a CID is in use
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int dtls_client_rewake(int resume)
+{
+    int ret;
+
+    if (dtls_client_connect(MBEDTLS_SSL_TRANSPORT_DATAGRAM) != 0) {
+        return -1;
+    }
+    if (dtls_cid_in_use == MBEDTLS_SSL_CID_ENABLED && !resume) {
+        /* The server finds the connection by CID, whatever our address */
+        return 0;
+    }
+
+    if (!dtls_session_valid) {
+        return -1;
+    }
+    if ((ret = mbedtls_ssl_session_reset(&dtls_ssl)) != 0 ||
+        (ret = mbedtls_ssl_set_cid(&dtls_ssl, MBEDTLS_SSL_CID_ENABLED, NULL, 0)) != 0 ||
+        (ret = mbedtls_ssl_set_session(&dtls_ssl, &dtls_session)) != 0) {
+        printf("ERROR: DTLS session resumption setup returned -0x%04X\n", -ret);
+        return -1;
+    }
+    return dtls_client_handshake(1);
+}
+
+/**
+ * @brief Reopen the socket after sleeping
+ * @retval 0 if successful, non-zero otherwise
+ */
+int dtls_client_wake(void)
+{
+    return dtls_client_rewake(0);
+}
+
+/**
+ * @brief Close the connection and release all contexts
+ */
+void dtls_client_close(void)
+{
+    if (!dtls_open) {
+        return;
+    }
+    mbedtls_ssl_close_notify(&dtls_ssl);
+    mbedtls_net_free(&dtls_fd);
+    mbedtls_ssl_free(&dtls_ssl);
+    mbedtls_ssl_config_free(&dtls_conf);
+    mbedtls_ctr_drbg_free(&dtls_ctr_drbg);
+    mbedtls_entropy_free(&dtls_entropy);
+    dtls_cid_in_use = MBEDTLS_SSL_CID_DISABLED;
+    dtls_open = 0;
+}
+
+/**
+ * @brief One wake of the TLS comparison: connect, resume, first record
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int dtls_client_tls_wake(void)
+{
+    int ret;
+
+    if (dtls_client_connect(MBEDTLS_SSL_TRANSPORT_STREAM) != 0) {
+        return -1;
+    }
+    if ((ret = mbedtls_ssl_session_reset(&dtls_ssl)) != 0 ||
+        (ret = mbedtls_ssl_set_session(&dtls_ssl, &dtls_session)) != 0) {
+        printf("ERROR: TLS session resumption setup returned -0x%04X\n", -ret);
+        return -1;
+    }
+    return dtls_client_handshake(1);
+}
+
+/**
+ * @brief Compare wake-to-first-record latency and traffic after a sleep
+ * @param trust_ca CAs the server chain must verify against
+ * @param iterations Number of sleep/wake cycles per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int dtls_client_bench_wake(mbedtls_x509_crt *trust_ca, uint32_t iterations)
+{
+    static const char *const mode_name[] = { "DTLS CID", "DTLS resumption", "TLS resumption" };
+    static const uint8_t record[] = "{\"t\":21.5,\"rh\":40}";
+    uint8_t reply[256];
+    uint32_t start;
+    uint32_t total;
+    uint32_t n;
+    int mode;
+    int ret = 0;
+
+    if (iterations == 0) {
+        return -1;
+    }
+
+    for (mode = 0; mode <= 2 && ret == 0; mode++) {
+        int transport = mode == 2 ? MBEDTLS_SSL_TRANSPORT_STREAM : MBEDTLS_SSL_TRANSPORT_DATAGRAM;
+
+        /* Full handshake first, not counted */
+        if (dtls_client_setup(transport, trust_ca) != 0 ||
+            dtls_client_connect(transport) != 0 || dtls_client_handshake(0) != 0) {
+            printf("ERROR: Wake benchmark (%s) failed to connect\n", mode_name[mode]);
+            dtls_client_close();
+            return -1;
+        }
+        if (mode == 0 && dtls_cid_in_use != MBEDTLS_SSL_CID_ENABLED) {
+            printf("WARNING: Server refused the CID, DTLS CID mode resumes instead\n");
+        }
+
+        total = 0;
+        dtls_client_reset_stats();
+        for (n = 0; n < iterations && ret == 0; n++) {
+            if (mode == 2) {
+                mbedtls_ssl_close_notify(&dtls_ssl);
+            }
+            dtls_client_sleep();
+
+            start = board_timing_cycles();
+            if (mode == 2) {
+                ret = dtls_client_tls_wake();
+            } else {
+                ret = dtls_client_rewake(mode == 1);
+            }
+            if (ret == 0 && dtls_client_send(record, sizeof(record) - 1) < 0) {
+                ret = -1;
+            }
+            if (ret == 0 && dtls_client_recv(reply, sizeof(reply)) < 0) {
+                ret = -1;
+            }
+            total += board_timing_cycles() - start;
+        }
+
+        if (ret != 0) {
+            printf("ERROR: Wake benchmark (%s) failed\n", mode_name[mode]);
+        } else {
+            printf("Wake benchmark (%s): %lu ms to first record, %lu bytes out in %lu "
+                   "packets, %lu bytes in in %lu packets, per wake\n",
+                   mode_name[mode],
+                   (unsigned long)(board_timing_cycles_to_us(total / iterations) / 1000),
+                   (unsigned long)(dtls_stats.bytes_sent / iterations),
+                   (unsigned long)(dtls_stats.datagrams_sent / iterations),
+                   (unsigned long)(dtls_stats.bytes_received / iterations),
+                   (unsigned long)(dtls_stats.datagrams_received / iterations));
+        }
+        dtls_client_close();
+    }
+
+    mbedtls_ssl_session_free(&dtls_session);
+    dtls_session_valid = 0;
+    return ret;
+}
+
+/**
+ * @brief Get traffic counters
+ * @param stats Filled with the current counters
+ */
+void dtls_client_get_stats(dtls_client_stats_t *stats)
+{
+    *stats = dtls_stats;
+}
+
+/**
+ * @brief Reset traffic counters
+ */
+void dtls_client_reset_stats(void)
+{
+    memset(&dtls_stats, 0, sizeof(dtls_stats));
+}
+
+#endif /* MBEDTLS_SSL_PROTO_DTLS && MBEDTLS_SSL_DTLS_CONNECTION_ID && MBEDTLS_NET_C */
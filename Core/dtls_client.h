@@ -0,0 +1,131 @@
+/**
+ * @file dtls_client.h
+ * @brief DTLS 1.2 telemetry client with Connection ID for sleepy devices
+ *
+ * The client authenticates with the SE05x key like the TLS client and asks
+ * the server for a Connection ID. With a CID the server finds the
+ * connection by the ID in each record rather than by address, so after a
+ * sleep, when the radio comes back on a new port or the NAT binding has
+ * changed, records flow again without any handshake. Without one, or after
+ * the connection state was lost, the session kept in RAM or in the SE05x is
+ * resumed with an abbreviated handshake.
+ */
+
+#ifndef DTLS_CLIENT_H
+#define DTLS_CLIENT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mbedtls/x509_crt.h"
+
+/* Telemetry server, DTLS over UDP and TLS over TCP for comparison */
+#define DTLS_SERVER_NAME "telemetry.example.com"
+#define DTLS_SERVER_PORT "5684"
+#define DTLS_TLS_SERVER_PORT "4433"
+
+/* Largest datagram sent, below the path MTU of cellular links */
+#ifndef DTLS_CLIENT_MTU
+#define DTLS_CLIENT_MTU 1200
+#endif
+
+/* Handshake retransmission timeout, doubled from min up to max */
+#ifndef DTLS_HANDSHAKE_TIMEOUT_MIN_MS
+#define DTLS_HANDSHAKE_TIMEOUT_MIN_MS 1000
+#endif
+#ifndef DTLS_HANDSHAKE_TIMEOUT_MAX_MS
+#define DTLS_HANDSHAKE_TIMEOUT_MAX_MS 16000
+#endif
+
+/* Longest wait for an application record */
+#ifndef DTLS_READ_TIMEOUT_MS
+#define DTLS_READ_TIMEOUT_MS 5000
+#endif
+
+/**
+ * @brief Traffic counters, as handed to and from the socket
+ *
+ * UDP/IP headers (28 bytes per datagram) and, over TCP, segments mbedTLS
+ * does not see (SYN, ACK, FIN) are not included.
+ */
+typedef struct {
+    uint32_t bytes_sent;
+    uint32_t bytes_received;
+    uint32_t datagrams_sent;
+    uint32_t datagrams_received;
+    uint32_t handshakes;
+    uint32_t resumptions;
+    uint32_t handshake_cycles;
+} dtls_client_stats_t;
+
+/**
+ * @brief Open the DTLS connection to the telemetry server
+ *
+ * The session stored in the SE05x, if any, is resumed.
+ *
+ * @param trust_ca CAs the server chain must verify against
+ * @retval 0 if successful, non-zero otherwise
+ */
+int dtls_client_open(mbedtls_x509_crt *trust_ca);
+
+/**
+ * @brief Send one telemetry record
+ * @param data Record payload
+ * @param len Length of @p data, at most what fits in DTLS_CLIENT_MTU
+ * @retval Number of bytes sent, negative on error
+ */
+int dtls_client_send(const uint8_t *data, size_t len);
+
+/**
+ * @brief Wait up to DTLS_READ_TIMEOUT_MS for the next record from the server
+ * @param buf Output buffer
+ * @param size Size of @p buf
+ * @retval Number of bytes received, negative on error or timeout
+ */
+int dtls_client_recv(uint8_t *buf, size_t size);
+
+/**
+ * @brief Close the socket before sleeping, the DTLS state is kept
+ */
+void dtls_client_sleep(void);
+
+/**
+ * @brief Reopen the socket after sleeping
+ *
+ * The new socket usually has another source port, like a device whose NAT
+ * binding expired. With a CID the connection continues as is, otherwise the
+ * session is resumed.
+ *
+ * @retval 0 if successful, non-zero otherwise
+ */
+int dtls_client_wake(void);
+
+/**
+ * @brief Close the connection and release all contexts
+ */
+void dtls_client_close(void);
+
+/**
+ * @brief Compare wake-to-first-record latency and traffic after a sleep
+ *        for DTLS with CID, DTLS with session resumption and TLS with
+ *        session resumption
+ *
+ * Each wake sends one record and waits for the first record back.
+ *
+ * @param trust_ca CAs the server chain must verify against
+ * @param iterations Number of sleep/wake cycles per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int dtls_client_bench_wake(mbedtls_x509_crt *trust_ca, uint32_t iterations);
+
+/**
+ * @brief Get traffic counters
+ * @param stats Filled with the current counters
+ */
+void dtls_client_get_stats(dtls_client_stats_t *stats);
+
+/**
+ * @brief Reset traffic counters
+ */
+void dtls_client_reset_stats(void);
+
+#endif /* DTLS_CLIENT_H */
@@ -0,0 +1,148 @@
+/**
+ * @file ecp_p256_comb.c
+ * @brief Flash-resident fixed-base comb table for the secp256r1 generator
+ *
+ * Without a table, every multiplication by G on a freshly loaded group
+ * builds the 16-point comb table on the heap, and host-side ECDHE key
+ * generation and ECDSA verify load a new group every time, so the table
+ * never gets reused. With ECP_P256_ROM_COMB the table is const data and only
+ * the scalar recoding and the result point use RAM. Host ECDHE key pairs
+ * come from ecp_p256_comb_gen_keypair() (see se05x_ecdh.c), and
+ * se05x_verify.c attaches the table for host-side verification.
+ */
+
+#include "ecp_p256_comb.h"
+
+#if defined(ECP_P256_ROM_COMB)
+
+#include <stddef.h>
+
+#if defined(MBEDTLS_ECP_ALT)
+#error "ECP_P256_ROM_COMB requires the software ECP implementation"
+#endif
+
+#ifndef MBEDTLS_PRIVATE
+#define MBEDTLS_PRIVATE(member) member
+#endif
+
+#if defined(MBEDTLS_HAVE_INT32)
+#define ECP_COMB_BYTES_TO_T_UINT_4(a, b, c, d)         \
+    (((mbedtls_mpi_uint) (a) << 0) |                   \
+     ((mbedtls_mpi_uint) (b) << 8) |                   \
+     ((mbedtls_mpi_uint) (c) << 16) |                  \
+     ((mbedtls_mpi_uint) (d) << 24))
+#define ECP_COMB_BYTES_TO_T_UINT_8(a, b, c, d, e, f, g, h) \
+    ECP_COMB_BYTES_TO_T_UINT_4(a, b, c, d),                \
+    ECP_COMB_BYTES_TO_T_UINT_4(e, f, g, h)
+#else
+#define ECP_COMB_BYTES_TO_T_UINT_8(a, b, c, d, e, f, g, h) \
+    (((mbedtls_mpi_uint) (a) << 0) |                       \
+     ((mbedtls_mpi_uint) (b) << 8) |                       \
+     ((mbedtls_mpi_uint) (c) << 16) |                      \
+     ((mbedtls_mpi_uint) (d) << 24) |                      \
+     ((mbedtls_mpi_uint) (e) << 32) |                      \
+     ((mbedtls_mpi_uint) (f) << 40) |                      \
+     ((mbedtls_mpi_uint) (g) << 48) |                      \
+     ((mbedtls_mpi_uint) (h) << 56))
+#endif
+
+/* Z = 1: the comb code adds table points with ecp_add_mixed() */
+static const mbedtls_mpi_uint ecp_comb_one[] = { 1 };
+
+#define ECP_COMB_MPI_INIT(limbs)                                       \
+    { .MBEDTLS_PRIVATE(s) = 1,                                         \
+      .MBEDTLS_PRIVATE(n) = sizeof(limbs) / sizeof(mbedtls_mpi_uint),  \
+      .MBEDTLS_PRIVATE(p) = (mbedtls_mpi_uint *) (limbs) }
+
+#define ECP_COMB_POINT_INIT_XY_Z1(x, y)         \
+    { .MBEDTLS_PRIVATE(X) = ECP_COMB_MPI_INIT(x), \
+      .MBEDTLS_PRIVATE(Y) = ECP_COMB_MPI_INIT(y), \
+      .MBEDTLS_PRIVATE(Z) = ECP_COMB_MPI_INIT(ecp_comb_one) }
+
+#include "ecp_p256_comb_table.h"
+
+/* ecp_mul_comb() uses grp->T without checking its size, so the table must
+ * have the width ecp_pick_window() picks for G on a 256-bit curve: 4, plus
+ * one with MBEDTLS_ECP_FIXED_POINT_OPTIM, capped at MBEDTLS_ECP_WINDOW_SIZE
+ * (see mbedtls_user_conf.h) */
+#if MBEDTLS_ECP_FIXED_POINT_OPTIM == 1
+#define ECP_P256_COMB_WANTED 5
+#else
+#define ECP_P256_COMB_WANTED 4
+#endif
+#if MBEDTLS_ECP_WINDOW_SIZE < ECP_P256_COMB_WANTED
+#undef ECP_P256_COMB_WANTED
+#define ECP_P256_COMB_WANTED MBEDTLS_ECP_WINDOW_SIZE
+#endif
+#if ECP_P256_COMB_WINDOW != ECP_P256_COMB_WANTED
+#error "ECP_P256_ROM_COMB table width does not match the mbedTLS comb window"
+#endif
+
+/**
+ * @brief Attach the ROM comb table to a secp256r1 group
+ * @param grp Group loaded with mbedtls_ecp_group_load()
+ * @retval 1 if the table was attached, 0 if the group was left untouched
+ */
+int ecp_p256_comb_attach(mbedtls_ecp_group *grp)
+{
+    /* Leave groups alone that already carry a table */
+    if (grp->id != MBEDTLS_ECP_DP_SECP256R1 || grp->MBEDTLS_PRIVATE(T) != NULL) {
+        return 0;
+    }
+
+    /* ecp_mul_comb() only reads grp->T when it is already set */
+    grp->MBEDTLS_PRIVATE(T) = (mbedtls_ecp_point *) ecp_p256_comb_T;
+    grp->MBEDTLS_PRIVATE(T_size) = ECP_P256_COMB_SIZE;
+    return 1;
+}
+
+/**
+ * @brief Detach the ROM comb table from a group
+ * @param grp Group previously passed to ecp_p256_comb_attach()
+ */
+void ecp_p256_comb_detach(mbedtls_ecp_group *grp)
+{
+    if (grp->MBEDTLS_PRIVATE(T) == (mbedtls_ecp_point *) ecp_p256_comb_T) {
+        grp->MBEDTLS_PRIVATE(T) = NULL;
+        grp->MBEDTLS_PRIVATE(T_size) = 0;
+    }
+}
+
+#else /* ECP_P256_ROM_COMB */
+
+int ecp_p256_comb_attach(mbedtls_ecp_group *grp)
+{
+    (void) grp;
+    return 0;
+}
+
+void ecp_p256_comb_detach(mbedtls_ecp_group *grp)
+{
+    (void) grp;
+}
+
+#endif /* ECP_P256_ROM_COMB */
+
+/**
+ * @brief Generate an EC key pair, using the ROM comb table for secp256r1
+ * @param grp ECP group
+ * @param d Private key
+ * @param Q Public key
+ * @param f_rng RNG function
+ * @param p_rng RNG context
+ * @retval 0 if successful, an MBEDTLS_ERR_ECP_XXX code otherwise
+ */
+int ecp_p256_comb_gen_keypair(mbedtls_ecp_group *grp, mbedtls_mpi *d, mbedtls_ecp_point *Q,
+                              int (*f_rng)(void *, unsigned char *, size_t),
+                              void *p_rng)
+{
+    int ret;
+    int attached = ecp_p256_comb_attach(grp);
+
+    ret = mbedtls_ecp_gen_keypair(grp, d, Q, f_rng, p_rng);
+
+    if (attached) {
+        ecp_p256_comb_detach(grp);
+    }
+    return ret;
+}
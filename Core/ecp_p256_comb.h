@@ -0,0 +1,46 @@
+/**
+ * @file ecp_p256_comb.h
+ * @brief Flash-resident fixed-base comb table for the secp256r1 generator
+ *
+ * The table is generated at build time by scripts/gen_ecp_p256_comb.py when
+ * the ECP_P256_ROM_COMB CMake option is on. Attaching it to a group makes
+ * ecp_mul_comb() use it for every multiplication by G instead of building
+ * and caching the table in RAM.
+ */
+
+#ifndef ECP_P256_COMB_H
+#define ECP_P256_COMB_H
+
+#include "mbedtls/ecp.h"
+#include <stddef.h>
+
+/**
+ * @brief Attach the ROM comb table to a secp256r1 group
+ * @param grp Group loaded with mbedtls_ecp_group_load()
+ * @retval 1 if the table was attached, 0 if the group was left untouched
+ *
+ * @note Call ecp_p256_comb_detach() before mbedtls_ecp_group_free(), which
+ *       would otherwise try to free the table.
+ */
+int ecp_p256_comb_attach(mbedtls_ecp_group *grp);
+
+/**
+ * @brief Detach the ROM comb table from a group
+ * @param grp Group previously passed to ecp_p256_comb_attach()
+ */
+void ecp_p256_comb_detach(mbedtls_ecp_group *grp);
+
+/**
+ * @brief Generate an EC key pair, using the ROM comb table for secp256r1
+ * @param grp ECP group
+ * @param d Private key
+ * @param Q Public key
+ * @param f_rng RNG function
+ * @param p_rng RNG context
+ * @retval 0 if successful, an MBEDTLS_ERR_ECP_XXX code otherwise
+ */
+int ecp_p256_comb_gen_keypair(mbedtls_ecp_group *grp, mbedtls_mpi *d, mbedtls_ecp_point *Q,
+                              int (*f_rng)(void *, unsigned char *, size_t),
+                              void *p_rng);
+
+#endif /* ECP_P256_COMB_H */
@@ -0,0 +1,204 @@
+/**
+ * @file fw_verify.c
+ * @brief Streaming verification of PKCS#7-signed firmware images
+ */
+
+#include "fw_verify.h"
+#include "se05x_init.h"
+#include "board_timing.h"
+#include "mbedtls/psa_util.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(MBEDTLS_PKCS7_C)
+
+/**
+ * @brief Parse the detached signature and start the image digest
+ * @param ctx Verification context
+ * @param sig DER PKCS#7 SignedData without content or signed attributes
+ * @param sig_len Length of @p sig, at most FW_VERIFY_MAX_SIG_LEN
+ * @param where Where the image digest runs
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int fw_verify_begin(fw_verify_t *ctx, const uint8_t *sig, size_t sig_len,
+                    fw_verify_digest_t where)
+{
+    sss_algorithm_t algorithm;
+    int ret;
+
+    memset(ctx, 0, sizeof(*ctx));
+    mbedtls_pkcs7_init(&ctx->pkcs7);
+    ctx->hash = psa_hash_operation_init();
+    ctx->where = where;
+
+    if (sig_len > FW_VERIFY_MAX_SIG_LEN) {
+        return MBEDTLS_ERR_PKCS7_BAD_INPUT_DATA;
+    }
+
+    ret = mbedtls_pkcs7_parse_der(&ctx->pkcs7, sig, sig_len);
+    if (ret < 0) {
+        return ret;
+    }
+    if (ret != MBEDTLS_PKCS7_SIGNED_DATA) {
+        return MBEDTLS_ERR_PKCS7_FEATURE_UNAVAILABLE;
+    }
+    ret = mbedtls_pkcs7_get_md_alg(&ctx->pkcs7, &ctx->md_alg);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (where == FW_VERIFY_DIGEST_SE) {
+        switch (ctx->md_alg) {
+        case MBEDTLS_MD_SHA256: algorithm = kAlgorithm_SSS_SHA256; break;
+        case MBEDTLS_MD_SHA384: algorithm = kAlgorithm_SSS_SHA384; break;
+        case MBEDTLS_MD_SHA512: algorithm = kAlgorithm_SSS_SHA512; break;
+        default: return MBEDTLS_ERR_PKCS7_FEATURE_UNAVAILABLE;
+        }
+        if (sss_digest_context_init(&ctx->digest, &g_session, algorithm,
+                                    kMode_SSS_Digest) != kStatus_SSS_Success) {
+            return MBEDTLS_ERR_PKCS7_VERIFY_FAIL;
+        }
+        ctx->active = 1;
+        if (sss_digest_init(&ctx->digest) != kStatus_SSS_Success) {
+            return MBEDTLS_ERR_PKCS7_VERIFY_FAIL;
+        }
+    } else {
+        if (psa_hash_setup(&ctx->hash, mbedtls_md_psa_alg_from_type(ctx->md_alg)) !=
+            PSA_SUCCESS) {
+            return MBEDTLS_ERR_PKCS7_VERIFY_FAIL;
+        }
+        ctx->active = 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Feed the next chunk of the image
+ * @param ctx Context from fw_verify_begin()
+ * @param data Next bytes of the image
+ * @param len Length of @p data, any size
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int fw_verify_update(fw_verify_t *ctx, const uint8_t *data, size_t len)
+{
+    uint32_t start = board_timing_cycles();
+    size_t n;
+    int ret = 0;
+
+    if (!ctx->active) {
+        return MBEDTLS_ERR_PKCS7_BAD_INPUT_DATA;
+    }
+
+    if (ctx->where == FW_VERIFY_DIGEST_SE) {
+        while (len > 0 && ret == 0) {
+            n = len < FW_VERIFY_SE_CHUNK ? len : FW_VERIFY_SE_CHUNK;
+            if (sss_digest_update(&ctx->digest, data, n) != kStatus_SSS_Success) {
+                ret = MBEDTLS_ERR_PKCS7_VERIFY_FAIL;
+            }
+            data += n;
+            len -= n;
+            ctx->stats.bytes += n;
+        }
+    } else {
+        if (psa_hash_update(&ctx->hash, data, len) != PSA_SUCCESS) {
+            ret = MBEDTLS_ERR_PKCS7_VERIFY_FAIL;
+        }
+        ctx->stats.bytes += len;
+    }
+
+    ctx->stats.digest_cycles += board_timing_cycles() - start;
+    return ret;
+}
+
+/**
+ * @brief Finish the digest and check the signature
+ * @param ctx Context from fw_verify_begin()
+ * @param signer Certificate of the signing key, or NULL to use the ones
+ *        carried in the signature
+ * @param trust_ca CAs the signer must chain to, or NULL if @p signer is
+ *        trusted as is
+ * @param flags Certificate verification flags, set when the chain check fails
+ * @retval 0 if the image is signed by a trusted key, an mbedTLS error code
+ *         otherwise
+ */
+int fw_verify_finish(fw_verify_t *ctx, mbedtls_x509_crt *signer, mbedtls_x509_crt *trust_ca,
+                     uint32_t *flags)
+{
+    uint8_t hash[PSA_HASH_MAX_SIZE];
+    size_t hash_len = sizeof(hash);
+    uint32_t start;
+    int ret = 0;
+
+    *flags = 0;
+    if (!ctx->active) {
+        return MBEDTLS_ERR_PKCS7_BAD_INPUT_DATA;
+    }
+
+    start = board_timing_cycles();
+    if (ctx->where == FW_VERIFY_DIGEST_SE) {
+        if (sss_digest_finish(&ctx->digest, hash, &hash_len) != kStatus_SSS_Success) {
+            ret = MBEDTLS_ERR_PKCS7_VERIFY_FAIL;
+        }
+        sss_digest_context_free(&ctx->digest);
+    } else {
+        if (psa_hash_finish(&ctx->hash, hash, sizeof(hash), &hash_len) != PSA_SUCCESS) {
+            ret = MBEDTLS_ERR_PKCS7_VERIFY_FAIL;
+        }
+    }
+    ctx->active = 0;
+    ctx->stats.digest_cycles += board_timing_cycles() - start;
+    if (ret != 0) {
+        return ret;
+    }
+
+    start = board_timing_cycles();
+    if (signer == NULL) {
+        signer = mbedtls_pkcs7_get_certs(&ctx->pkcs7);
+        if (signer == NULL) {
+            return MBEDTLS_ERR_PKCS7_INVALID_CERT;
+        }
+    }
+    if (trust_ca != NULL) {
+        ret = mbedtls_x509_crt_verify(signer, trust_ca, NULL, NULL, flags, NULL, NULL);
+        if (ret != 0) {
+            printf("WARNING: Firmware signer not trusted, flags 0x%08lx\n",
+                   (unsigned long)*flags);
+        }
+    }
+    if (ret == 0) {
+        ret = mbedtls_pkcs7_signed_hash_verify(&ctx->pkcs7, signer, hash, hash_len);
+    }
+    ctx->stats.verify_cycles = board_timing_cycles() - start;
+
+    return ret;
+}
+
+/**
+ * @brief Release the parsed signature and any digest in progress
+ * @param ctx Verification context
+ */
+void fw_verify_free(fw_verify_t *ctx)
+{
+    if (ctx->active) {
+        if (ctx->where == FW_VERIFY_DIGEST_SE) {
+            sss_digest_context_free(&ctx->digest);
+        } else {
+            psa_hash_abort(&ctx->hash);
+        }
+        ctx->active = 0;
+    }
+    mbedtls_pkcs7_free(&ctx->pkcs7);
+}
+
+/**
+ * @brief Get verification counters of one image
+ * @param ctx Verification context
+ * @param stats Filled with the current counters
+ */
+void fw_verify_get_stats(const fw_verify_t *ctx, fw_verify_stats_t *stats)
+{
+    *stats = ctx->stats;
+}
+
+#endif /* MBEDTLS_PKCS7_C */
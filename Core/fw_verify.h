@@ -0,0 +1,120 @@
+/**
+ * @file fw_verify.h
+ * @brief Streaming verification of PKCS#7-signed firmware images
+ *
+ * mbedtls_pkcs7_signed_data_verify() hashes the whole signed content in one
+ * call, so an OTA image has to fit in memory. Here the detached PKCS#7
+ * signature is parsed once, the image is fed in chunks of any size as it is
+ * received or read from external flash, and the digest is checked against
+ * the signature at the end with mbedtls_pkcs7_signed_hash_verify(). The
+ * digest runs on the host through PSA or on the SE05x through the SSS digest
+ * API. Memory use is the parsed signature, bounded by FW_VERIFY_MAX_SIG_LEN,
+ * and one digest state, whatever the image size.
+ *
+ * The signer certificate is either carried in the signature and checked
+ * against trusted CAs, or supplied by the caller as the trust anchor itself.
+ * An anchor whose key is registered with se05x_verify_register_key() is
+ * checked on the SE05x.
+ */
+
+#ifndef FW_VERIFY_H
+#define FW_VERIFY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fsl_sss_api.h"
+#include "mbedtls/pkcs7.h"
+#include "psa/crypto.h"
+
+/* Largest detached signature accepted, certificates included */
+#ifndef FW_VERIFY_MAX_SIG_LEN
+#define FW_VERIFY_MAX_SIG_LEN 4096
+#endif
+
+/* Image bytes per SE05x digest update, within one APDU */
+#ifndef FW_VERIFY_SE_CHUNK
+#define FW_VERIFY_SE_CHUNK 512
+#endif
+
+/**
+ * @brief Where the image digest runs
+ */
+typedef enum {
+    FW_VERIFY_DIGEST_HOST = 0,
+    FW_VERIFY_DIGEST_SE,
+} fw_verify_digest_t;
+
+/**
+ * @brief Verification counters, cycle totals are from board_timing_cycles()
+ */
+typedef struct {
+    uint32_t bytes;
+    uint32_t digest_cycles;
+    uint32_t verify_cycles;
+} fw_verify_stats_t;
+
+/**
+ * @brief Image being verified
+ */
+typedef struct {
+    mbedtls_pkcs7 pkcs7;
+    mbedtls_md_type_t md_alg;
+    fw_verify_digest_t where;
+    psa_hash_operation_t hash;
+    sss_digest_t digest;
+    uint8_t active;
+    fw_verify_stats_t stats;
+} fw_verify_t;
+
+/**
+ * @brief Parse the detached signature and start the image digest
+ *
+ * Call fw_verify_free() afterwards, whatever the result.
+ *
+ * @param ctx Verification context
+ * @param sig DER PKCS#7 SignedData without content or signed attributes,
+ *        e.g. from openssl smime -sign -binary -noattr -outform DER
+ * @param sig_len Length of @p sig, at most FW_VERIFY_MAX_SIG_LEN
+ * @param where Where the image digest runs
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int fw_verify_begin(fw_verify_t *ctx, const uint8_t *sig, size_t sig_len,
+                    fw_verify_digest_t where);
+
+/**
+ * @brief Feed the next chunk of the image
+ * @param ctx Context from fw_verify_begin()
+ * @param data Next bytes of the image
+ * @param len Length of @p data, any size
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int fw_verify_update(fw_verify_t *ctx, const uint8_t *data, size_t len);
+
+/**
+ * @brief Finish the digest and check the signature
+ * @param ctx Context from fw_verify_begin()
+ * @param signer Certificate of the signing key, or NULL to use the ones
+ *        carried in the signature
+ * @param trust_ca CAs the signer must chain to, or NULL if @p signer is
+ *        trusted as is
+ * @param flags Certificate verification flags, set when the chain check fails
+ * @retval 0 if the image is signed by a trusted key, an mbedTLS error code
+ *         otherwise
+ */
+int fw_verify_finish(fw_verify_t *ctx, mbedtls_x509_crt *signer, mbedtls_x509_crt *trust_ca,
+                     uint32_t *flags);
+
+/**
+ * @brief Release the parsed signature and any digest in progress
+ * @param ctx Verification context
+ */
+void fw_verify_free(fw_verify_t *ctx);
+
+/**
+ * @brief Get verification counters of one image
+ * @param ctx Verification context
+ * @param stats Filled with the current counters
+ */
+void fw_verify_get_stats(const fw_verify_t *ctx, fw_verify_stats_t *stats);
+
+#endif /* FW_VERIFY_H */
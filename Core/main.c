@@ -5,8 +5,10 @@
 
 #include "stm32f4xx_hal.h"
 #include "board.h"
+#include "board_timing.h"
 #include "se05x_init.h"
 #include "tls_client.h"
+#include "tls_profile.h"
 #include <stdio.h>
 
 /* Private variables ---------------------------------------------------------*/
@@ -34,6 +36,7 @@ int main(void)
     /* Initialize all configured peripherals */
     MX_GPIO_Init();
     MX_I2C1_Init();
+    board_timing_init();
 
     printf("STM32F407 + Plug & Trust + SE050 + mbedTLS TLS Connection Example\n");
     
@@ -46,6 +49,11 @@ int main(void)
     
     printf("SE050 initialized successfully\n");
     
+#if defined(TLS_PROFILE)
+    /* Break every handshake down by state: CPU, network and SE050 time */
+    tls_profile_set_report(tls_profile_print, NULL);
+#endif
+    
     /* Run TLS client example */
     if (tls_client_run() != 0) {
         printf("TLS client example failed\n");
@@ -57,7 +65,10 @@ int main(void)
     /* Infinite loop */
     while (1)
     {
-        HAL_Delay(1000);
+        /* Keep ECDHE keys ready for the next connection */
+        if (tls_client_idle() <= 0) {
+            HAL_Delay(1000);
+        }
     }
 }
 
@@ -14,8 +14,37 @@
 /* mbed TLS feature support */
 #define MBEDTLS_ECP_DP_SECP256R1_ENABLED
 #define MBEDTLS_ECP_NIST_OPTIM
+/* Comb width for multiplications by G, matching the 16-point table that
+ * ECP_P256_ROM_COMB puts in flash (scripts/gen_ecp_p256_comb.py)
+ */
+#define MBEDTLS_ECP_WINDOW_SIZE 5
+#define MBEDTLS_ECP_FIXED_POINT_OPTIM 1
 #define MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED
+#define MBEDTLS_KEY_EXCHANGE_PSK_ENABLED
 #define MBEDTLS_SSL_PROTO_TLS1_2
+#define MBEDTLS_SSL_PROTO_TLS1_3
+#define MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_EPHEMERAL_ENABLED
+#define MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_PSK_EPHEMERAL_ENABLED
+#define MBEDTLS_SSL_SESSION_TICKETS
+#define MBEDTLS_SSL_EARLY_DATA
+#define MBEDTLS_SSL_SERVER_NAME_INDICATION
+#define MBEDTLS_SSL_KEEP_PEER_CERTIFICATE
+#define MBEDTLS_SSL_PROTO_DTLS
+#define MBEDTLS_SSL_DTLS_CONNECTION_ID
+#define MBEDTLS_SSL_ASYNC_PRIVATE
+#define MBEDTLS_SSL_CACHE_HASH_INDEX
+#define MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+#define MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH
+#define MBEDTLS_SSL_IN_BUFFER_ON_DEMAND
+#define MBEDTLS_SSL_BUFFER_POOL
+#define MBEDTLS_SSL_ZERO_COPY
+#define MBEDTLS_SSL_ALIGNED_RECORDS
+#define MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK
+
+/* Client handshake messages and application requests are small; the input
+ * buffer still accepts full-size records when the server needs them.
+ */
+#define MBEDTLS_SSL_OUT_CONTENT_LEN 4096
 
 /* mbed TLS modules */
 #define MBEDTLS_AES_C
@@ -34,17 +63,42 @@
 #define MBEDTLS_OID_C
 #define MBEDTLS_PK_C
 #define MBEDTLS_PK_PARSE_C
+#define MBEDTLS_PK_WRITE_C
+#define MBEDTLS_PKCS7_C
 #define MBEDTLS_SHA256_C
+#define MBEDTLS_SSL_CACHE_C
 #define MBEDTLS_SSL_CLI_C
 #define MBEDTLS_SSL_SRV_C
 #define MBEDTLS_SSL_TLS_C
 #define MBEDTLS_X509_CRT_PARSE_C
+#define MBEDTLS_X509_CRT_BATCH_VERIFY
+#define MBEDTLS_X509_CRT_VERIFY_CACHE
+#define MBEDTLS_X509_CRL_PARSE_C
+#define MBEDTLS_X509_CREATE_C
+#define MBEDTLS_X509_CSR_WRITE_C
+#define MBEDTLS_X509_CSR_WRITE_SIGN_CB
 #define MBEDTLS_X509_USE_C
 
-/* ALT implementations */
+/* ALT implementations
+ * MBEDTLS_ECDSA_VERIFY_ALT is served by Core/se05x_verify.c, which keeps
+ * public-only keys on the host and SE-resident keys on the SE05x.
+ */
 #define MBEDTLS_ECDSA_SIGN_ALT
 #define MBEDTLS_ECDSA_VERIFY_ALT
 
+/* secp256r1 ECDHE of the handshake is served by Core/se05x_ecdh.c through
+ * mbedtls_ssl_conf_ecdhe_cb(), on the host (with the ROM comb table when
+ * ECP_P256_ROM_COMB is set) or on the SE05x.
+ */
+#define MBEDTLS_SSL_ECDHE_CB
+
+/* MBEDTLS_ECP_RESTARTABLE stays off: the crypto library does not allow it
+ * together with the ECDSA ALTs above, and it would also turn on restartable
+ * ECC in the TLS 1.2 client, which passes a restart context to X.509
+ * verification and so bypasses batch verification and the verified-chain
+ * cache.
+ */
+
 /* For test certificates */
 #define MBEDTLS_CERTS_C
 #define MBEDTLS_PEM_PARSE_C
@@ -0,0 +1,156 @@
+/**
+ * @file record_pool.c
+ * @brief Record buffers shared by every TLS connection
+ *
+ * Slots are taken from the smallest size that fits; a small request falls
+ * back to a large slot when the small ones are all lent. mbedTLS zeroizes
+ * every buffer before giving it back.
+ */
+
+#include "record_pool.h"
+#include <string.h>
+
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+
+#if RECORD_POOL_SMALL_SLOTS > 32 || RECORD_POOL_LARGE_SLOTS > 32
+#error "Record pool slots are tracked in 32-bit masks"
+#endif
+
+/* Slot sizes are multiples of 8, so every slot stays 8-byte aligned */
+#define RECORD_POOL_ALIGN(len) (((len) + 7U) & ~7U)
+#define RECORD_POOL_SMALL_STRIDE RECORD_POOL_ALIGN(RECORD_POOL_SMALL_LEN)
+#define RECORD_POOL_LARGE_STRIDE RECORD_POOL_ALIGN(RECORD_POOL_LARGE_LEN)
+
+/* A pool of equally sized slots */
+typedef struct {
+    uint8_t *base;
+    uint32_t slots;
+    uint32_t stride;
+    uint32_t used;
+} record_pool_class_t;
+
+static uint8_t record_pool_small[RECORD_POOL_SMALL_SLOTS * RECORD_POOL_SMALL_STRIDE]
+    __attribute__((aligned(8)));
+#if RECORD_POOL_LARGE_SLOTS > 0
+static uint8_t record_pool_large[RECORD_POOL_LARGE_SLOTS * RECORD_POOL_LARGE_STRIDE]
+    __attribute__((aligned(8)));
+#endif
+
+/* Smallest slots first */
+static record_pool_class_t record_pool_classes[] = {
+    { record_pool_small, RECORD_POOL_SMALL_SLOTS, RECORD_POOL_SMALL_STRIDE, 0 },
+#if RECORD_POOL_LARGE_SLOTS > 0
+    { record_pool_large, RECORD_POOL_LARGE_SLOTS, RECORD_POOL_LARGE_STRIDE, 0 },
+#endif
+};
+
+#define RECORD_POOL_CLASSES (sizeof(record_pool_classes) / sizeof(record_pool_classes[0]))
+
+static record_pool_stats_t record_pool_stats;
+
+/**
+ * @brief Let mbedTLS take record buffers from the pool
+ */
+void record_pool_setup(void)
+{
+    mbedtls_ssl_set_buffer_pool_cb(record_pool_acquire, record_pool_release, NULL);
+}
+
+/**
+ * @brief Acquire callback, see mbedtls_ssl_buffer_acquire_t
+ */
+unsigned char *record_pool_acquire(void *p_pool, size_t len)
+{
+    record_pool_class_t *cls;
+    size_t i;
+    uint32_t slot;
+
+    (void)p_pool;
+
+    for (i = 0; i < RECORD_POOL_CLASSES; i++) {
+        cls = &record_pool_classes[i];
+        if (len > cls->stride) {
+            continue;
+        }
+        for (slot = 0; slot < cls->slots; slot++) {
+            if ((cls->used & (1U << slot)) == 0) {
+                cls->used |= 1U << slot;
+                record_pool_stats.acquires++;
+                record_pool_stats.in_use++;
+                record_pool_stats.bytes_in_use += cls->stride;
+                if (record_pool_stats.in_use > record_pool_stats.peak_in_use) {
+                    record_pool_stats.peak_in_use = record_pool_stats.in_use;
+                }
+                if (record_pool_stats.bytes_in_use > record_pool_stats.peak_bytes) {
+                    record_pool_stats.peak_bytes = record_pool_stats.bytes_in_use;
+                }
+                return cls->base + slot * cls->stride;
+            }
+        }
+    }
+
+    record_pool_stats.exhausted++;
+    return NULL;
+}
+
+/**
+ * @brief Release callback, see mbedtls_ssl_buffer_release_t
+ */
+void record_pool_release(void *p_pool, unsigned char *buf, size_t len)
+{
+    record_pool_class_t *cls;
+    size_t i;
+    uint32_t slot;
+
+    (void)p_pool;
+    (void)len;
+
+    for (i = 0; i < RECORD_POOL_CLASSES; i++) {
+        cls = &record_pool_classes[i];
+        if (buf < cls->base || buf >= cls->base + cls->slots * cls->stride) {
+            continue;
+        }
+        slot = (uint32_t)(buf - cls->base) / cls->stride;
+        if (cls->used & (1U << slot)) {
+            cls->used &= ~(1U << slot);
+            record_pool_stats.releases++;
+            record_pool_stats.in_use--;
+            record_pool_stats.bytes_in_use -= cls->stride;
+        }
+        return;
+    }
+}
+
+/**
+ * @brief Stop handing out record buffers to new contexts
+ */
+void record_pool_free(void)
+{
+    mbedtls_ssl_set_buffer_pool_cb(NULL, NULL, NULL);
+}
+
+/**
+ * @brief Get record pool counters
+ * @param stats Filled with the current counters
+ */
+void record_pool_get_stats(record_pool_stats_t *stats)
+{
+    *stats = record_pool_stats;
+}
+
+/**
+ * @brief Reset record pool counters, slots in use are still counted
+ */
+void record_pool_reset_stats(void)
+{
+    uint32_t in_use = record_pool_stats.in_use;
+    uint32_t bytes_in_use = record_pool_stats.bytes_in_use;
+
+    memset(&record_pool_stats, 0, sizeof(record_pool_stats));
+    record_pool_stats.in_use = in_use;
+    record_pool_stats.peak_in_use = in_use;
+    record_pool_stats.bytes_in_use = bytes_in_use;
+    record_pool_stats.peak_bytes = bytes_in_use;
+}
+
+#endif /* MBEDTLS_SSL_BUFFER_POOL */
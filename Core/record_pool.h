@@ -0,0 +1,97 @@
+/**
+ * @file record_pool.h
+ * @brief Record buffers shared by every TLS connection
+ *
+ * Each connection needs an input and an output record buffer, but only while
+ * it handshakes or actually reads or writes a record. The pool plugs into
+ * mbedtls_ssl_set_buffer_pool_cb(): connections whose handshake is over hand
+ * their buffers back between records, so many mostly idle connections share
+ * a few statically allocated slots. Slots come in two sizes: small ones for
+ * the output buffer and the input buffer sized by max_fragment_length, and
+ * large ones for an input buffer grown by a server that sends full-size
+ * records anyway.
+ */
+
+#ifndef RECORD_POOL_H
+#define RECORD_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mbedtls/ssl.h"
+
+/* Room for the record header, explicit IV, MAC, CBC padding and CID on top
+ * of the record content, whatever the configuration */
+#define RECORD_POOL_OVERHEAD 512
+
+#ifndef RECORD_POOL_SMALL_LEN
+#define RECORD_POOL_SMALL_LEN (MBEDTLS_SSL_OUT_CONTENT_LEN + RECORD_POOL_OVERHEAD)
+#endif
+
+#ifndef RECORD_POOL_LARGE_LEN
+#define RECORD_POOL_LARGE_LEN (MBEDTLS_SSL_IN_CONTENT_LEN + RECORD_POOL_OVERHEAD)
+#endif
+
+/* A handshake holds two small slots, an active record exchange one or two */
+#ifndef RECORD_POOL_SMALL_SLOTS
+#define RECORD_POOL_SMALL_SLOTS 4
+#endif
+
+#ifndef RECORD_POOL_LARGE_SLOTS
+#define RECORD_POOL_LARGE_SLOTS 1
+#endif
+
+/* RAM taken by the pool, all of it static .bss: 4 * 4608 + 16896 = 35328
+ * bytes with the defaults and the 4096 / 16384 byte content lengths of
+ * mbedtls_user_conf.h, reserved even when no connection is open */
+#define RECORD_POOL_BYTES (RECORD_POOL_SMALL_SLOTS * RECORD_POOL_SMALL_LEN + \
+                           RECORD_POOL_LARGE_SLOTS * RECORD_POOL_LARGE_LEN)
+
+/**
+ * @brief Record pool counters
+ */
+typedef struct {
+    uint32_t acquires;
+    uint32_t releases;
+    uint32_t exhausted;
+    uint32_t in_use;
+    uint32_t peak_in_use;
+    uint32_t bytes_in_use;
+    uint32_t peak_bytes;
+} record_pool_stats_t;
+
+/**
+ * @brief Let mbedTLS take record buffers from the pool
+ *
+ * Only contexts set up afterwards use the pool.
+ */
+void record_pool_setup(void);
+
+/**
+ * @brief Acquire callback, see mbedtls_ssl_buffer_acquire_t
+ */
+unsigned char *record_pool_acquire(void *p_pool, size_t len);
+
+/**
+ * @brief Release callback, see mbedtls_ssl_buffer_release_t
+ */
+void record_pool_release(void *p_pool, unsigned char *buf, size_t len);
+
+/**
+ * @brief Stop handing out record buffers to new contexts
+ *
+ * Contexts set up before keep using the pool until they are freed.
+ */
+void record_pool_free(void);
+
+/**
+ * @brief Get record pool counters
+ * @param stats Filled with the current counters
+ */
+void record_pool_get_stats(record_pool_stats_t *stats);
+
+/**
+ * @brief Reset record pool counters, slots in use are still counted
+ */
+void record_pool_reset_stats(void);
+
+#endif /* RECORD_POOL_H */
@@ -0,0 +1,206 @@
+/**
+ * @file se05x_async.c
+ * @brief Asynchronous SE05x private key operations for mbedTLS handshakes
+ *
+ * The sign start callback only copies the hash into a queue slot, so the
+ * handshake step returns at once with MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS.
+ * se05x_async_poll() performs queued signatures one at a time; in between,
+ * the caller can drive other connections' handshakes. The resume callback
+ * hands the DER signature back to mbedTLS once it is available.
+ */
+
+#include "se05x_async.h"
+#include "se05x_init.h"
+#include <stdio.h>
+#include <string.h>
+
+/* DER encoded ECDSA signature for up to NIST P-384 */
+#define SE05X_ASYNC_SIG_MAX 104
+#define SE05X_ASYNC_HASH_MAX 48
+
+typedef enum {
+    SE05X_ASYNC_FREE = 0,
+    SE05X_ASYNC_QUEUED,
+    SE05X_ASYNC_DONE,
+    SE05X_ASYNC_FAILED,
+} se05x_async_state_t;
+
+/* One queued or finished signature */
+typedef struct {
+    se05x_async_state_t state;
+    uint32_t seq;
+    sss_object_t *key;
+    sss_algorithm_t algorithm;
+    uint8_t hash[SE05X_ASYNC_HASH_MAX];
+    size_t hash_len;
+    uint8_t sig[SE05X_ASYNC_SIG_MAX];
+    size_t sig_len;
+} se05x_async_op_t;
+
+static se05x_async_op_t async_ops[SE05X_ASYNC_MAX_OPS];
+static uint32_t async_seq;
+static se05x_async_stats_t async_stats;
+
+/**
+ * @brief Run the oldest queued signature on the SE05x
+ * @retval 1 if an operation was run, 0 if the queue is empty
+ */
+int se05x_async_poll(void)
+{
+    sss_status_t status;
+    sss_asymmetric_t ctx;
+    se05x_async_op_t *op = NULL;
+    size_t i;
+
+    for (i = 0; i < SE05X_ASYNC_MAX_OPS; i++) {
+        if (async_ops[i].state == SE05X_ASYNC_QUEUED &&
+            (op == NULL || (int32_t)(async_ops[i].seq - op->seq) < 0)) {
+            op = &async_ops[i];
+        }
+    }
+    if (op == NULL) {
+        return 0;
+    }
+
+    status = sss_asymmetric_context_init(&ctx, &g_session, op->key, op->algorithm, kMode_SSS_Sign);
+    if (status == kStatus_SSS_Success) {
+        op->sig_len = sizeof(op->sig);
+        status = sss_asymmetric_sign_digest(&ctx, op->hash, op->hash_len, op->sig, &op->sig_len);
+        sss_asymmetric_context_free(&ctx);
+    }
+
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: SE05x async sign failed (status = 0x%X)\n", status);
+        op->state = SE05X_ASYNC_FAILED;
+        async_stats.failed++;
+    } else {
+        op->state = SE05X_ASYNC_DONE;
+        async_stats.completed++;
+    }
+    return 1;
+}
+
+/**
+ * @brief Get async operation counters
+ * @param stats Filled with the current counters
+ */
+void se05x_async_get_stats(se05x_async_stats_t *stats)
+{
+    *stats = async_stats;
+}
+
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+/**
+ * @brief Start a signature: queue it and return without touching the SE05x
+ */
+static int se05x_async_sign(mbedtls_ssl_context *ssl, mbedtls_x509_crt *cert,
+                            mbedtls_md_type_t md_alg,
+                            const unsigned char *hash, size_t hash_len)
+{
+    sss_object_t *key = mbedtls_ssl_conf_get_async_config_data(mbedtls_ssl_context_get_config(ssl));
+    se05x_async_op_t *op = NULL;
+    sss_algorithm_t algorithm;
+    uint32_t queued = 0;
+    size_t i;
+
+    (void) cert;
+
+    switch (md_alg) {
+    case MBEDTLS_MD_SHA256: algorithm = kAlgorithm_SSS_ECDSA_SHA256; break;
+    case MBEDTLS_MD_SHA384: algorithm = kAlgorithm_SSS_ECDSA_SHA384; break;
+    default:
+        /* Let mbedTLS use the configured private key */
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH;
+    }
+
+    if (hash_len > SE05X_ASYNC_HASH_MAX) {
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH;
+    }
+
+    for (i = 0; i < SE05X_ASYNC_MAX_OPS; i++) {
+        if (async_ops[i].state == SE05X_ASYNC_FREE) {
+            if (op == NULL) {
+                op = &async_ops[i];
+            }
+        } else {
+            queued++;
+        }
+    }
+    if (op == NULL) {
+        printf("ERROR: SE05x async queue full\n");
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    op->key = key;
+    op->algorithm = algorithm;
+    memcpy(op->hash, hash, hash_len);
+    op->hash_len = hash_len;
+    op->seq = async_seq++;
+    op->state = SE05X_ASYNC_QUEUED;
+    mbedtls_ssl_set_async_operation_data(ssl, op);
+
+    async_stats.started++;
+    if (queued + 1 > async_stats.max_queued) {
+        async_stats.max_queued = queued + 1;
+    }
+    return MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS;
+}
+
+/**
+ * @brief Free a queue slot
+ * @param op Operation
+ */
+static void se05x_async_free_op(se05x_async_op_t *op)
+{
+    memset(op, 0, sizeof(*op));
+}
+
+/**
+ * @brief Resume a signature: hand the result back once the SE05x answered
+ */
+static int se05x_async_resume(mbedtls_ssl_context *ssl,
+                              unsigned char *output, size_t *output_len, size_t output_size)
+{
+    se05x_async_op_t *op = mbedtls_ssl_get_async_operation_data(ssl);
+    int ret = 0;
+
+    if (op->state == SE05X_ASYNC_QUEUED) {
+        return MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS;
+    }
+
+    if (op->state != SE05X_ASYNC_DONE) {
+        ret = MBEDTLS_ERR_SSL_HW_ACCEL_FAILED;
+    } else if (op->sig_len > output_size) {
+        ret = MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+    } else {
+        memcpy(output, op->sig, op->sig_len);
+        *output_len = op->sig_len;
+    }
+
+    se05x_async_free_op(op);
+    return ret;
+}
+
+/**
+ * @brief Cancel a signature, e.g. when the handshake is aborted
+ */
+static void se05x_async_cancel(mbedtls_ssl_context *ssl)
+{
+    se05x_async_op_t *op = mbedtls_ssl_get_async_operation_data(ssl);
+
+    if (op != NULL) {
+        se05x_async_free_op(op);
+    }
+}
+
+/**
+ * @brief Register the SE05x async private key callbacks on a configuration
+ * @param conf SSL configuration
+ * @param key SE05x key pair matching the configured own certificate
+ */
+void se05x_async_conf(mbedtls_ssl_config *conf, sss_object_t *key)
+{
+    mbedtls_ssl_conf_async_private_cb(conf, se05x_async_sign, se05x_async_resume,
+                                      se05x_async_cancel, key);
+}
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
@@ -0,0 +1,55 @@
+/**
+ * @file se05x_async.h
+ * @brief Asynchronous SE05x private key operations for mbedTLS handshakes
+ */
+
+#ifndef SE05X_ASYNC_H
+#define SE05X_ASYNC_H
+
+#include <stdint.h>
+#include "fsl_sss_api.h"
+#include "mbedtls/ssl.h"
+
+/* Number of signatures that can be queued at the same time, i.e. the number
+ * of connections whose handshake can wait on the SE05x concurrently */
+#ifndef SE05X_ASYNC_MAX_OPS
+#define SE05X_ASYNC_MAX_OPS 4
+#endif
+
+/**
+ * @brief Async operation counters
+ */
+typedef struct {
+    uint32_t started;
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t max_queued;
+} se05x_async_stats_t;
+
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+/**
+ * @brief Register the SE05x async private key callbacks on a configuration
+ *
+ * Signatures requested by the handshake are queued and
+ * mbedtls_ssl_handshake() returns MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS until
+ * se05x_async_poll() has run them.
+ *
+ * @param conf SSL configuration
+ * @param key SE05x key pair matching the configured own certificate
+ */
+void se05x_async_conf(mbedtls_ssl_config *conf, sss_object_t *key);
+#endif
+
+/**
+ * @brief Run the oldest queued signature on the SE05x
+ * @retval 1 if an operation was run, 0 if the queue is empty
+ */
+int se05x_async_poll(void);
+
+/**
+ * @brief Get async operation counters
+ * @param stats Filled with the current counters
+ */
+void se05x_async_get_stats(se05x_async_stats_t *stats);
+
+#endif /* SE05X_ASYNC_H */
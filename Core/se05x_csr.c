@@ -0,0 +1,237 @@
+/**
+ * @file se05x_csr.c
+ * @brief Certificate signing requests for keys held in the SE05x
+ */
+
+#include "se05x_csr.h"
+#include "se05x_init.h"
+#include "board_timing.h"
+#include "mbedtls/pk.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(MBEDTLS_X509_CSR_WRITE_SIGN_CB)
+
+static se05x_csr_stats_t csr_stats;
+
+/**
+ * @brief Sign the CertificationRequestInfo hash on the SE05x
+ * @param p_sign SE05x key pair
+ * @param sig_alg Signature algorithm selected from the public key
+ * @param md_alg Hash algorithm of @p hash
+ * @param hash Hash to sign
+ * @param hash_len Length of @p hash
+ * @param sig DER ECDSA signature
+ * @param sig_size Size of @p sig
+ * @param sig_len Length of the signature
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+static int se05x_csr_sign(void *p_sign, mbedtls_pk_sigalg_t sig_alg, mbedtls_md_type_t md_alg,
+                          const unsigned char *hash, size_t hash_len,
+                          unsigned char *sig, size_t sig_size, size_t *sig_len)
+{
+    sss_object_t *key = p_sign;
+    sss_algorithm_t algorithm;
+    sss_asymmetric_t ctx;
+    sss_status_t status;
+    uint32_t start;
+
+    if (sig_alg != MBEDTLS_PK_SIGALG_ECDSA) {
+        return MBEDTLS_ERR_X509_FEATURE_UNAVAILABLE;
+    }
+    switch (md_alg) {
+    case MBEDTLS_MD_SHA256: algorithm = kAlgorithm_SSS_ECDSA_SHA256; break;
+    case MBEDTLS_MD_SHA384: algorithm = kAlgorithm_SSS_ECDSA_SHA384; break;
+    case MBEDTLS_MD_SHA512: algorithm = kAlgorithm_SSS_ECDSA_SHA512; break;
+    default: return MBEDTLS_ERR_X509_FEATURE_UNAVAILABLE;
+    }
+
+    start = board_timing_cycles();
+    status = sss_asymmetric_context_init(&ctx, &g_session, key, algorithm, kMode_SSS_Sign);
+    if (status == kStatus_SSS_Success) {
+        *sig_len = sig_size;
+        status = sss_asymmetric_sign_digest(&ctx, (uint8_t *)hash, hash_len, sig, sig_len);
+        sss_asymmetric_context_free(&ctx);
+    }
+    csr_stats.sign_cycles += board_timing_cycles() - start;
+
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: SE05x CSR sign failed for 0x%08X (status = 0x%X)\n", key->keyId, status);
+        return MBEDTLS_ERR_X509_FATAL_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read the public key of an SE05x key pair once
+ * @param ctx Key to set up
+ * @param key EC key pair already allocated in the SE05x key store
+ * @retval 0 if successful, non-zero otherwise
+ */
+int se05x_csr_key_setup(se05x_csr_key_t *ctx, sss_object_t *key)
+{
+    sss_status_t status;
+    uint8_t der[160];
+    size_t der_len = sizeof(der);
+    size_t bit_len = 0;
+    uint32_t start = board_timing_cycles();
+    int ret;
+
+    ctx->key = key;
+    mbedtls_pk_init(&ctx->pk);
+
+    /* Reading a key pair returns its public part as SubjectPublicKeyInfo */
+    status = sss_key_store_get_key(key->keyStore, key, der, &der_len, &bit_len);
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: Failed to read public key 0x%08X (status = 0x%X)\n", key->keyId, status);
+        return -1;
+    }
+
+    ret = mbedtls_pk_parse_public_key(&ctx->pk, der, der_len);
+    if (ret != 0) {
+        printf("ERROR: mbedtls_pk_parse_public_key returned -0x%04X for 0x%08X\n",
+               (unsigned int)-ret, key->keyId);
+        mbedtls_pk_free(&ctx->pk);
+        return -1;
+    }
+
+    csr_stats.key_reads++;
+    csr_stats.read_cycles += board_timing_cycles() - start;
+    return 0;
+}
+
+/**
+ * @brief Release the cached public key
+ * @param ctx Key set up with se05x_csr_key_setup()
+ */
+void se05x_csr_key_free(se05x_csr_key_t *ctx)
+{
+    mbedtls_pk_free(&ctx->pk);
+    ctx->key = NULL;
+}
+
+/**
+ * @brief Make a CSR context sign with an SE05x key
+ * @param csr CSR context initialised with mbedtls_x509write_csr_init()
+ * @param ctx Key set up with se05x_csr_key_setup()
+ */
+void se05x_csr_bind(mbedtls_x509write_csr *csr, se05x_csr_key_t *ctx)
+{
+    mbedtls_x509write_csr_set_key(csr, &ctx->pk);
+    mbedtls_x509write_csr_set_md_alg(csr, MBEDTLS_MD_SHA256);
+    mbedtls_x509write_csr_set_sign_cb(csr, se05x_csr_sign, ctx->key);
+}
+
+/**
+ * @brief Write a DER CSR for an SE05x key
+ * @param ctx Key set up with se05x_csr_key_setup()
+ * @param subject Subject name
+ * @param buf Output buffer, the CSR is written at its start
+ * @param size Size of @p buf
+ * @param len Length of the CSR
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int se05x_csr_write(se05x_csr_key_t *ctx, const char *subject, uint8_t *buf, size_t size,
+                    size_t *len)
+{
+    mbedtls_x509write_csr csr;
+    uint32_t start = board_timing_cycles();
+    int ret;
+
+    *len = 0;
+    mbedtls_x509write_csr_init(&csr);
+    se05x_csr_bind(&csr, ctx);
+
+    ret = mbedtls_x509write_csr_set_subject_name(&csr, subject);
+    if (ret == 0) {
+        ret = mbedtls_x509write_csr_der(&csr, buf, size);
+    }
+    mbedtls_x509write_csr_free(&csr);
+
+    if (ret < 0) {
+        csr_stats.failed++;
+        return ret;
+    }
+
+    /* The DER is written at the end of the buffer */
+    memmove(buf, buf + size - ret, (size_t)ret);
+    *len = (size_t)ret;
+    csr_stats.written++;
+    csr_stats.write_cycles += board_timing_cycles() - start;
+    return 0;
+}
+
+/**
+ * @brief Write CSRs for several SE05x key slots over the current session
+ * @param key_ids Key IDs of EC key pairs in the SE05x
+ * @param subjects Subject name of each CSR
+ * @param count Number of entries in @p key_ids and @p subjects
+ * @param out Output buffer
+ * @param out_size Size of @p out
+ * @param csr_len Length of each CSR in @p out, 0 if it failed
+ * @retval Number of CSRs written
+ */
+size_t se05x_csr_batch(const uint32_t *key_ids, const char *const *subjects, size_t count,
+                       uint8_t *out, size_t out_size, size_t *csr_len)
+{
+    se05x_csr_key_t ctx;
+    sss_object_t key;
+    uint32_t start = board_timing_cycles();
+    size_t offset = 0;
+    size_t done = 0;
+    size_t i;
+    int ret;
+
+    for (i = 0; i < count; i++) {
+        csr_len[i] = 0;
+
+        if (sss_key_object_init(&key, &g_key_store) != kStatus_SSS_Success) {
+            csr_stats.failed++;
+            continue;
+        }
+        if (sss_key_object_get_handle(&key, key_ids[i]) != kStatus_SSS_Success) {
+            printf("ERROR: No key pair 0x%08X in SE05x\n", (unsigned int)key_ids[i]);
+            csr_stats.failed++;
+            sss_key_object_free(&key);
+            continue;
+        }
+
+        if (se05x_csr_key_setup(&ctx, &key) != 0) {
+            csr_stats.failed++;
+        } else {
+            ret = se05x_csr_write(&ctx, subjects[i], out + offset, out_size - offset,
+                                  &csr_len[i]);
+            if (ret != 0) {
+                printf("ERROR: CSR for 0x%08X returned -0x%04X\n", (unsigned int)key_ids[i],
+                       (unsigned int)-ret);
+            } else {
+                offset += csr_len[i];
+                done++;
+            }
+            se05x_csr_key_free(&ctx);
+        }
+        sss_key_object_free(&key);
+    }
+
+    csr_stats.batch_cycles += board_timing_cycles() - start;
+    return done;
+}
+
+/**
+ * @brief Get CSR counters
+ * @param stats Filled with the current counters
+ */
+void se05x_csr_get_stats(se05x_csr_stats_t *stats)
+{
+    *stats = csr_stats;
+}
+
+/**
+ * @brief Reset CSR counters
+ */
+void se05x_csr_reset_stats(void)
+{
+    memset(&csr_stats, 0, sizeof(csr_stats));
+}
+
+#endif /* MBEDTLS_X509_CSR_WRITE_SIGN_CB */
@@ -0,0 +1,112 @@
+/**
+ * @file se05x_csr.h
+ * @brief Certificate signing requests for keys held in the SE05x
+ *
+ * The public key of an SE05x key pair is read once into a public-only PK
+ * context, which mbedtls_x509write_csr_der() writes into the CSR. The CSR
+ * itself is signed on the SE05x through the CSR signing callback, so the
+ * private key never leaves it and rebuilding a CSR for the same key costs
+ * one sign APDU and no key read.
+ */
+
+#ifndef SE05X_CSR_H
+#define SE05X_CSR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fsl_sss_api.h"
+#include "mbedtls/x509_csr.h"
+
+/* Largest CSR written by se05x_csr_batch() for one key */
+#ifndef SE05X_CSR_MAX_LEN
+#define SE05X_CSR_MAX_LEN 512
+#endif
+
+/**
+ * @brief CSR counters, cycle totals are from board_timing_cycles()
+ */
+typedef struct {
+    uint32_t key_reads;
+    uint32_t read_cycles;
+    uint32_t written;
+    uint32_t write_cycles;
+    uint32_t sign_cycles;
+    uint32_t batch_cycles;
+    uint32_t failed;
+} se05x_csr_stats_t;
+
+/**
+ * @brief SE05x key pair with its public part cached on the host
+ */
+typedef struct {
+    sss_object_t *key;
+    mbedtls_pk_context pk;
+} se05x_csr_key_t;
+
+/**
+ * @brief Read the public key of an SE05x key pair once
+ * @param ctx Key to set up
+ * @param key EC key pair already allocated in the SE05x key store, e.g.
+ *        g_tls_key, must stay valid
+ * @retval 0 if successful, non-zero otherwise
+ */
+int se05x_csr_key_setup(se05x_csr_key_t *ctx, sss_object_t *key);
+
+/**
+ * @brief Release the cached public key
+ * @param ctx Key set up with se05x_csr_key_setup()
+ */
+void se05x_csr_key_free(se05x_csr_key_t *ctx);
+
+/**
+ * @brief Make a CSR context sign with an SE05x key
+ *
+ * Sets the cached public key, the SHA-256 signature hash and the SE05x
+ * signing callback; the subject and extensions are left to the caller.
+ *
+ * @param csr CSR context initialised with mbedtls_x509write_csr_init()
+ * @param ctx Key set up with se05x_csr_key_setup(), must stay valid
+ */
+void se05x_csr_bind(mbedtls_x509write_csr *csr, se05x_csr_key_t *ctx);
+
+/**
+ * @brief Write a DER CSR for an SE05x key
+ * @param ctx Key set up with se05x_csr_key_setup()
+ * @param subject Subject name, e.g. "CN=device-0001,O=Example"
+ * @param buf Output buffer, the CSR is written at its start
+ * @param size Size of @p buf
+ * @param len Length of the CSR
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int se05x_csr_write(se05x_csr_key_t *ctx, const char *subject, uint8_t *buf, size_t size,
+                    size_t *len);
+
+/**
+ * @brief Write CSRs for several SE05x key slots over the current session
+ *
+ * The CSRs are written back to back into @p out. A slot that fails gets a
+ * zero length and the others are still written.
+ *
+ * @param key_ids Key IDs of EC key pairs in the SE05x
+ * @param subjects Subject name of each CSR
+ * @param count Number of entries in @p key_ids and @p subjects
+ * @param out Output buffer, SE05X_CSR_MAX_LEN bytes per key is enough
+ * @param out_size Size of @p out
+ * @param csr_len Length of each CSR in @p out, 0 if it failed
+ * @retval Number of CSRs written
+ */
+size_t se05x_csr_batch(const uint32_t *key_ids, const char *const *subjects, size_t count,
+                       uint8_t *out, size_t out_size, size_t *csr_len);
+
+/**
+ * @brief Get CSR counters
+ * @param stats Filled with the current counters
+ */
+void se05x_csr_get_stats(se05x_csr_stats_t *stats);
+
+/**
+ * @brief Reset CSR counters
+ */
+void se05x_csr_reset_stats(void);
+
+#endif /* SE05X_CSR_H */
@@ -0,0 +1,669 @@
+/**
+ * @file se05x_ecdh.c
+ * @brief ECDHE ephemeral key generation and shared secret derivation on the
+ *        host or on the SE05x
+ *
+ * se05x_ecdh_conf() registers the mbedtls_ssl_conf_ecdhe_cb() callbacks, so
+ * the secp256r1 key exchange of the TLS 1.2 ClientKeyExchange and of the
+ * TLS 1.3 key share lands here instead of in PSA. Every ephemeral key is an
+ * entry of ecdh_keys[], whose address is the handle the handshake keeps
+ * until the derivation. On the SE05x path the key pair is generated in a
+ * transient object, only its public point is returned to mbedTLS, and the
+ * premaster secret is derived with sss_derive_key_dh(). On the host path the
+ * key pair is generated with the ROM comb table and the shared secret is
+ * computed with mbedtls_ecp_mul().
+ *
+ * Key pairs can also be generated ahead of time by se05x_ecdh_pool_refill()
+ * and handed out by the generate callback; every pooled key leaves the pool
+ * when it is handed out, so it is used by one handshake only.
+ */
+
+#include "se05x_ecdh.h"
+#include "se05x_init.h"
+#include "board_timing.h"
+#include "ecp_p256_comb.h"
+#include "fsl_sss_util_asn1_der.h"
+#include "mbedtls/ecp.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Uncompressed NIST P-256 point: 0x04 || X || Y */
+#define SE05X_ECDH_POINT_LEN 65
+#define SE05X_ECDH_SECRET_LEN 32
+
+/* Index into the per-side moving averages */
+#define SE05X_ECDH_HOST 0
+#define SE05X_ECDH_SE 1
+
+/* Weight of a new sample in the moving averages is 1 / 2^SHIFT */
+#define SE05X_ECDH_AVG_SHIFT 2
+
+/* SubjectPublicKeyInfo header for an uncompressed NIST P-256 point */
+static const uint8_t p256_spki_header[] = {
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01,
+    0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00,
+};
+
+/* Ephemeral key pair, held by a handshake or pooled */
+typedef struct {
+    uint8_t in_use;
+    uint8_t pooled;
+    uint8_t on_se;
+    /* Transient SE05x key pair when on_se, host private key otherwise */
+    sss_object_t key;
+    mbedtls_mpi d;
+    uint8_t point[SE05X_ECDH_POINT_LEN];
+} se05x_ecdh_key_t;
+
+static se05x_ecdh_mode_t ecdh_mode = SE05X_ECDH_MODE_AUTO;
+static se05x_ecdh_key_t ecdh_keys[SE05X_ECDH_MAX_KEYS];
+static size_t pool_depth = SE05X_ECDH_POOL_DEPTH;
+static uint32_t gen_avg[2];
+static uint32_t derive_avg[2];
+static uint32_t handshake_count;
+static se05x_ecdh_stats_t ecdh_stats;
+
+/**
+ * @brief Select where ECDHE runs
+ * @param mode New mode
+ */
+void se05x_ecdh_set_mode(se05x_ecdh_mode_t mode)
+{
+    ecdh_mode = mode;
+}
+
+/**
+ * @brief Erase an ephemeral key and free its entry
+ * @param key Entry in use
+ */
+static void se05x_ecdh_free_key(se05x_ecdh_key_t *key)
+{
+    if (key->on_se) {
+        if (key->key.keyStore != NULL) {
+            sss_key_store_erase_key(&g_key_store, &key->key);
+        }
+        sss_key_object_free(&key->key);
+    } else {
+        mbedtls_mpi_free(&key->d);
+    }
+    memset(key, 0, sizeof(*key));
+}
+
+/**
+ * @brief Erase all pooled keys
+ */
+void se05x_ecdh_pool_flush(void)
+{
+    size_t i;
+
+    for (i = 0; i < SE05X_ECDH_MAX_KEYS; i++) {
+        if (ecdh_keys[i].in_use && ecdh_keys[i].pooled) {
+            se05x_ecdh_free_key(&ecdh_keys[i]);
+        }
+    }
+}
+
+/**
+ * @brief Set the number of keys the pool keeps ready per side
+ * @param depth Pool depth, at most SE05X_ECDH_POOL_DEPTH, 0 disables the pool
+ */
+void se05x_ecdh_pool_set_depth(size_t depth)
+{
+    if (depth > SE05X_ECDH_POOL_DEPTH) {
+        depth = SE05X_ECDH_POOL_DEPTH;
+    }
+    if (depth < pool_depth) {
+        se05x_ecdh_pool_flush();
+    }
+    pool_depth = depth;
+}
+
+/**
+ * @brief Get ECDH counters
+ * @param stats Filled with the current counters
+ */
+void se05x_ecdh_get_stats(se05x_ecdh_stats_t *stats)
+{
+    *stats = ecdh_stats;
+    stats->host_avg = gen_avg[SE05X_ECDH_HOST] + derive_avg[SE05X_ECDH_HOST];
+    stats->se_avg = gen_avg[SE05X_ECDH_SE] + derive_avg[SE05X_ECDH_SE];
+}
+
+/**
+ * @brief Reset ECDH counters (moving averages are kept)
+ */
+void se05x_ecdh_reset_stats(void)
+{
+    memset(&ecdh_stats, 0, sizeof(ecdh_stats));
+}
+
+/**
+ * @brief Add a sample to a moving average
+ * @param avg Moving average, 0 if there is no sample yet
+ * @param sample New sample
+ */
+static void se05x_ecdh_update_avg(uint32_t *avg, uint32_t sample)
+{
+    if (*avg == 0) {
+        *avg = sample;
+    } else {
+        *avg = *avg - (*avg >> SE05X_ECDH_AVG_SHIFT) + (sample >> SE05X_ECDH_AVG_SHIFT);
+    }
+}
+
+/**
+ * @brief Decide whether a secp256r1 ECDHE runs on the SE05x
+ * @param handshake 1 when called for a handshake, 0 for a pool refill
+ * @retval 1 for the SE05x, 0 for the host
+ */
+static int se05x_ecdh_pick_se(int handshake)
+{
+    uint32_t host_cost;
+    uint32_t se_cost;
+
+    if (ecdh_mode == SE05X_ECDH_MODE_HOST) {
+        return 0;
+    }
+    if (ecdh_mode == SE05X_ECDH_MODE_SE) {
+        return 1;
+    }
+
+    /* Measure each side once before comparing */
+    if (derive_avg[SE05X_ECDH_HOST] == 0) {
+        return 0;
+    }
+    if (derive_avg[SE05X_ECDH_SE] == 0) {
+        return 1;
+    }
+
+    host_cost = gen_avg[SE05X_ECDH_HOST] + derive_avg[SE05X_ECDH_HOST];
+    se_cost = gen_avg[SE05X_ECDH_SE] + derive_avg[SE05X_ECDH_SE];
+
+    /* Periodically re-measure the slower side, e.g. after a bus clock change */
+    if (handshake && ++handshake_count % SE05X_ECDH_PROBE_INTERVAL == 0) {
+        return se_cost >= host_cost;
+    }
+    return se_cost < host_cost;
+}
+
+/**
+ * @brief Key ID of an SE05x ephemeral key, followed by the peer key and the secret
+ * @param key Entry
+ * @retval Key ID
+ */
+static uint32_t se05x_ecdh_key_id(const se05x_ecdh_key_t *key)
+{
+    return SE05X_ECDH_KEY_ID + 3 * (uint32_t)(key - ecdh_keys);
+}
+
+/**
+ * @brief Generate an ephemeral key pair in a transient SE05x object
+ * @param key Free entry, marked on_se
+ * @retval 0 if successful, -1 otherwise
+ */
+static int se05x_ecdh_gen_on_se(se05x_ecdh_key_t *key)
+{
+    sss_status_t status;
+    uint8_t der[128];
+    size_t der_len = sizeof(der);
+    size_t bit_len = 0;
+    uint16_t index = 0;
+    size_t point_len = 0;
+
+    status = sss_key_object_init(&key->key, &g_key_store);
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_object_allocate_handle(&key->key,
+                                              se05x_ecdh_key_id(key),
+                                              kSSS_KeyPart_Pair,
+                                              kSSS_CipherType_EC_NIST_P,
+                                              256,
+                                              kKeyObject_Mode_Transient);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_store_generate_key(&g_key_store, &key->key, 256, NULL);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_store_get_key(&g_key_store, &key->key, der, &der_len, &bit_len);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_util_pkcs8_asn1_get_ec_public_key_index(der, der_len, &index, &point_len);
+    }
+    if (status != kStatus_SSS_Success || point_len != SE05X_ECDH_POINT_LEN) {
+        printf("ERROR: Failed to generate ECDH key in SE05x (status = 0x%X)\n", status);
+        return -1;
+    }
+
+    memcpy(key->point, &der[index], point_len);
+    return 0;
+}
+
+/**
+ * @brief Generate an ephemeral key pair on the host, with the ROM comb table
+ * @param key Free entry
+ * @param f_rng RNG function
+ * @param p_rng RNG context
+ * @retval 0 if successful, an MBEDTLS_ERR_ECP_XXX code otherwise
+ */
+static int se05x_ecdh_gen_on_host(se05x_ecdh_key_t *key,
+                                  int (*f_rng)(void *, unsigned char *, size_t), void *p_rng)
+{
+    int ret;
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_point Q;
+    size_t point_len = 0;
+
+    mbedtls_ecp_group_init(&grp);
+    mbedtls_ecp_point_init(&Q);
+
+    ret = mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_SECP256R1);
+    if (ret == 0) {
+        ret = ecp_p256_comb_gen_keypair(&grp, &key->d, &Q, f_rng, p_rng);
+    }
+    if (ret == 0) {
+        ret = mbedtls_ecp_point_write_binary(&grp, &Q, MBEDTLS_ECP_PF_UNCOMPRESSED,
+                                             &point_len, key->point, SE05X_ECDH_POINT_LEN);
+    }
+
+    mbedtls_ecp_point_free(&Q);
+    mbedtls_ecp_group_free(&grp);
+    return ret;
+}
+
+/**
+ * @brief Generate an ephemeral key pair in a free entry
+ * @param se Generate on the SE05x (1) or on the host (0)
+ * @param f_rng RNG function for host keys
+ * @param p_rng RNG context
+ * @retval Entry holding the key and its public point, or NULL on failure
+ */
+static se05x_ecdh_key_t *se05x_ecdh_generate(int se,
+                                             int (*f_rng)(void *, unsigned char *, size_t),
+                                             void *p_rng)
+{
+    se05x_ecdh_key_t *key = NULL;
+    uint32_t start = board_timing_cycles();
+    int ret;
+    size_t i;
+
+    for (i = 0; i < SE05X_ECDH_MAX_KEYS; i++) {
+        if (!ecdh_keys[i].in_use) {
+            key = &ecdh_keys[i];
+            break;
+        }
+    }
+    if (key == NULL) {
+        return NULL;
+    }
+
+    key->in_use = 1;
+    key->on_se = (uint8_t) se;
+    mbedtls_mpi_init(&key->d);
+
+    if (se) {
+        ret = se05x_ecdh_gen_on_se(key);
+    } else {
+        ret = se05x_ecdh_gen_on_host(key, f_rng, p_rng);
+        if (ret != 0) {
+            printf("ERROR: Failed to generate ECDH key (ret = -0x%04X)\n", -ret);
+        }
+    }
+    if (ret != 0) {
+        se05x_ecdh_free_key(key);
+        return NULL;
+    }
+
+    se05x_ecdh_update_avg(&gen_avg[se ? SE05X_ECDH_SE : SE05X_ECDH_HOST],
+                          board_timing_cycles() - start);
+    return key;
+}
+
+/**
+ * @brief Generate one pooled key for the side the next handshake would use
+ * @param f_rng RNG function for host keys
+ * @param p_rng RNG context
+ * @retval 1 if a key was added, 0 if the pool is full, negative on error
+ */
+int se05x_ecdh_pool_refill(int (*f_rng)(void *, unsigned char *, size_t), void *p_rng)
+{
+    int se = se05x_ecdh_pick_se(0);
+    se05x_ecdh_key_t *key;
+    size_t pooled = 0;
+    size_t i;
+
+    for (i = 0; i < SE05X_ECDH_MAX_KEYS; i++) {
+        pooled += (ecdh_keys[i].in_use && ecdh_keys[i].pooled && ecdh_keys[i].on_se == se);
+    }
+    if (pooled >= pool_depth) {
+        return 0;
+    }
+
+    key = se05x_ecdh_generate(se, f_rng, p_rng);
+    if (key == NULL) {
+        return -1;
+    }
+    key->pooled = 1;
+    ecdh_stats.pool_refills++;
+    return 1;
+}
+
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+/**
+ * @brief RNG for host keys generated during a handshake and for blinding
+ * @param p_rng Unused
+ * @param output Filled with random bytes
+ * @param len Number of bytes
+ * @retval 0 if successful, MBEDTLS_ERR_ECP_RANDOM_FAILED otherwise
+ */
+static int se05x_ecdh_rng(void *p_rng, unsigned char *output, size_t len)
+{
+    (void) p_rng;
+    return psa_generate_random(output, len) == PSA_SUCCESS ? 0 : MBEDTLS_ERR_ECP_RANDOM_FAILED;
+}
+
+/**
+ * @brief Take a pooled key pair, removing it from the pool
+ * @param se Take an SE05x key (1) or a host key (0)
+ * @retval Entry, or NULL if the pool holds no key for that side
+ */
+static se05x_ecdh_key_t *se05x_ecdh_pool_take(int se)
+{
+    size_t i;
+
+    for (i = 0; i < SE05X_ECDH_MAX_KEYS; i++) {
+        se05x_ecdh_key_t *key = &ecdh_keys[i];
+
+        if (key->in_use && key->pooled && key->on_se == se) {
+            key->pooled = 0;
+            return key;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Parse and check the peer's public point
+ * @param grp secp256r1 group
+ * @param Q Filled with the peer point
+ * @param peer Uncompressed point from the handshake
+ * @param peer_len Length of @p peer
+ * @retval 0 if the point is on the curve, an MBEDTLS_ERR_ECP_XXX code otherwise
+ */
+static int se05x_ecdh_read_peer(mbedtls_ecp_group *grp, mbedtls_ecp_point *Q,
+                                const unsigned char *peer, size_t peer_len)
+{
+    int ret;
+
+    if (peer_len != SE05X_ECDH_POINT_LEN) {
+        return MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
+    }
+
+    ret = mbedtls_ecp_group_load(grp, MBEDTLS_ECP_DP_SECP256R1);
+    if (ret == 0) {
+        ret = mbedtls_ecp_point_read_binary(grp, Q, peer, peer_len);
+    }
+    if (ret == 0) {
+        ret = mbedtls_ecp_check_pubkey(grp, Q);
+    }
+    return ret;
+}
+
+/**
+ * @brief Derive the shared secret with an SE05x ephemeral key
+ * @param key Entry holding the SE05x key
+ * @param peer Peer point, already checked
+ * @param secret Filled with the SE05X_ECDH_SECRET_LEN byte shared secret
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+static int se05x_ecdh_derive_on_se(se05x_ecdh_key_t *key, const unsigned char *peer,
+                                   unsigned char *secret)
+{
+    sss_status_t status;
+    sss_derive_key_t ctx;
+    sss_object_t peer_key;
+    sss_object_t secret_key;
+    uint8_t spki[sizeof(p256_spki_header) + SE05X_ECDH_POINT_LEN];
+    uint8_t buf[SE05X_ECDH_SECRET_LEN];
+    size_t buf_len = sizeof(buf);
+    size_t bit_len = 0;
+    uint32_t key_id = se05x_ecdh_key_id(key);
+    int ret = MBEDTLS_ERR_SSL_HW_ACCEL_FAILED;
+
+    memcpy(spki, p256_spki_header, sizeof(p256_spki_header));
+    memcpy(spki + sizeof(p256_spki_header), peer, SE05X_ECDH_POINT_LEN);
+
+    memset(&ctx, 0, sizeof(ctx));
+    memset(&peer_key, 0, sizeof(peer_key));
+    memset(&secret_key, 0, sizeof(secret_key));
+
+    status = sss_key_object_init(&peer_key, &g_key_store);
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_object_allocate_handle(&peer_key, key_id + 1, kSSS_KeyPart_Public,
+                                              kSSS_CipherType_EC_NIST_P, sizeof(spki),
+                                              kKeyObject_Mode_Transient);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_store_set_key(&g_key_store, &peer_key, spki, sizeof(spki), 256, NULL, 0);
+    }
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: Failed to import ECDH peer key (status = 0x%X)\n", status);
+        goto cleanup;
+    }
+
+    status = sss_key_object_init(&secret_key, &g_key_store);
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_object_allocate_handle(&secret_key, key_id + 2, kSSS_KeyPart_Default,
+                                              kSSS_CipherType_HMAC, SE05X_ECDH_SECRET_LEN,
+                                              kKeyObject_Mode_Transient);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_derive_key_context_init(&ctx, &g_session, &key->key,
+                                           kAlgorithm_SSS_ECDH, kMode_SSS_ComputeSharedSecret);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_derive_key_dh(&ctx, &peer_key, &secret_key);
+        sss_derive_key_context_free(&ctx);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_store_get_key(&g_key_store, &secret_key, buf, &buf_len, &bit_len);
+    }
+    if (status != kStatus_SSS_Success || buf_len != SE05X_ECDH_SECRET_LEN) {
+        printf("ERROR: ECDH derivation in SE05x failed (status = 0x%X)\n", status);
+        goto cleanup;
+    }
+
+    memcpy(secret, buf, SE05X_ECDH_SECRET_LEN);
+    ret = 0;
+
+cleanup:
+    memset(buf, 0, sizeof(buf));
+    if (secret_key.keyStore != NULL) {
+        sss_key_store_erase_key(&g_key_store, &secret_key);
+        sss_key_object_free(&secret_key);
+    }
+    if (peer_key.keyStore != NULL) {
+        sss_key_store_erase_key(&g_key_store, &peer_key);
+        sss_key_object_free(&peer_key);
+    }
+    return ret;
+}
+
+/**
+ * @brief Derive the shared secret with a host ephemeral key
+ * @param key Entry holding the host key
+ * @param grp secp256r1 group
+ * @param Q Peer point, already checked
+ * @param secret Filled with the SE05X_ECDH_SECRET_LEN byte shared secret
+ * @retval 0 if successful, an MBEDTLS_ERR_ECP_XXX code otherwise
+ */
+static int se05x_ecdh_derive_on_host(se05x_ecdh_key_t *key, mbedtls_ecp_group *grp,
+                                     const mbedtls_ecp_point *Q, unsigned char *secret)
+{
+    int ret;
+    mbedtls_ecp_point P;
+
+    mbedtls_ecp_point_init(&P);
+    ret = mbedtls_ecp_mul(grp, &P, &key->d, Q, se05x_ecdh_rng, NULL);
+    if (ret == 0 && mbedtls_ecp_is_zero(&P)) {
+        ret = MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
+    }
+    if (ret == 0) {
+        ret = mbedtls_mpi_write_binary(&P.MBEDTLS_PRIVATE(X), secret, SE05X_ECDH_SECRET_LEN);
+    }
+    mbedtls_ecp_point_free(&P);
+    return ret;
+}
+
+/**
+ * @brief mbedtls_ssl_ecdhe_gen_t callback
+ * @param p_ecdhe Unused
+ * @param key_type PSA key type of the key pair
+ * @param key_bits Key size in bits
+ * @param key Filled with the entry holding the new key
+ * @param pub Filled with the public point
+ * @param pub_size Size of @p pub
+ * @param pub_len Filled with the length of the public point
+ * @retval 0 if successful, MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH for curves
+ *         other than secp256r1, another mbedTLS error code otherwise
+ */
+static int se05x_ecdh_gen_cb(void *p_ecdhe, psa_key_type_t key_type, size_t key_bits,
+                             void **key, unsigned char *pub, size_t pub_size, size_t *pub_len)
+{
+    se05x_ecdh_key_t *entry = NULL;
+    uint32_t start = board_timing_cycles();
+    int se;
+
+    (void) p_ecdhe;
+
+    /* Other groups stay with PSA */
+    if (key_type != PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_SECP_R1) || key_bits != 256) {
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH;
+    }
+    if (pub_size < SE05X_ECDH_POINT_LEN) {
+        return MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+    }
+
+    se = se05x_ecdh_pick_se(1);
+
+    if (pool_depth > 0) {
+        /* In auto mode a pooled key from the other side still beats an inline keygen */
+        entry = se05x_ecdh_pool_take(se);
+        if (entry == NULL && ecdh_mode == SE05X_ECDH_MODE_AUTO) {
+            entry = se05x_ecdh_pool_take(!se);
+        }
+        if (entry != NULL) {
+            ecdh_stats.pool_hits++;
+        } else {
+            ecdh_stats.pool_misses++;
+        }
+    }
+
+    if (entry == NULL && se) {
+        entry = se05x_ecdh_generate(1, NULL, NULL);
+        if (entry == NULL) {
+            printf("WARNING: Falling back to host ECDH key generation\n");
+        }
+    }
+    if (entry == NULL) {
+        entry = se05x_ecdh_generate(0, se05x_ecdh_rng, NULL);
+    }
+    if (entry == NULL) {
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FAILED;
+    }
+
+    if (entry->on_se) {
+        ecdh_stats.se_cycles += board_timing_cycles() - start;
+    } else {
+        ecdh_stats.host_cycles += board_timing_cycles() - start;
+    }
+
+    memcpy(pub, entry->point, SE05X_ECDH_POINT_LEN);
+    *pub_len = SE05X_ECDH_POINT_LEN;
+    *key = entry;
+    return 0;
+}
+
+/**
+ * @brief mbedtls_ssl_ecdhe_derive_t callback, erases the key in all cases
+ * @param p_ecdhe Unused
+ * @param key Entry returned by se05x_ecdh_gen_cb()
+ * @param peer Peer public point
+ * @param peer_len Length of @p peer
+ * @param secret Filled with the shared secret
+ * @param secret_size Size of @p secret
+ * @param secret_len Filled with the length of the shared secret
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+static int se05x_ecdh_derive_cb(void *p_ecdhe, void *key,
+                                const unsigned char *peer, size_t peer_len,
+                                unsigned char *secret, size_t secret_size, size_t *secret_len)
+{
+    se05x_ecdh_key_t *entry = key;
+    int se = entry->on_se;
+    uint32_t start = board_timing_cycles();
+    uint32_t cycles;
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_point Q;
+    int ret;
+
+    (void) p_ecdhe;
+
+    mbedtls_ecp_group_init(&grp);
+    mbedtls_ecp_point_init(&Q);
+
+    if (secret_size < SE05X_ECDH_SECRET_LEN) {
+        ret = MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+    } else {
+        ret = se05x_ecdh_read_peer(&grp, &Q, peer, peer_len);
+    }
+    if (ret == 0) {
+        if (se) {
+            ret = se05x_ecdh_derive_on_se(entry, peer, secret);
+        } else {
+            ret = se05x_ecdh_derive_on_host(entry, &grp, &Q, secret);
+        }
+    }
+
+    mbedtls_ecp_point_free(&Q);
+    mbedtls_ecp_group_free(&grp);
+
+    /* Ephemeral keys are used for a single derivation */
+    se05x_ecdh_free_key(entry);
+
+    cycles = board_timing_cycles() - start;
+    if (ret == 0) {
+        se05x_ecdh_update_avg(&derive_avg[se ? SE05X_ECDH_SE : SE05X_ECDH_HOST], cycles);
+        *secret_len = SE05X_ECDH_SECRET_LEN;
+    }
+    if (se) {
+        ecdh_stats.se_count++;
+        ecdh_stats.se_cycles += cycles;
+    } else {
+        ecdh_stats.host_count++;
+        ecdh_stats.host_cycles += cycles;
+    }
+    return ret;
+}
+
+/**
+ * @brief mbedtls_ssl_ecdhe_free_t callback, for keys of aborted handshakes
+ *        and key shares replaced after a HelloRetryRequest
+ * @param p_ecdhe Unused
+ * @param key Entry returned by se05x_ecdh_gen_cb()
+ */
+static void se05x_ecdh_free_cb(void *p_ecdhe, void *key)
+{
+    (void) p_ecdhe;
+    se05x_ecdh_free_key(key);
+}
+
+/**
+ * @brief Register the ECDHE callbacks on a configuration
+ * @param conf SSL configuration
+ */
+void se05x_ecdh_conf(mbedtls_ssl_config *conf)
+{
+    mbedtls_ssl_conf_ecdhe_cb(conf, se05x_ecdh_gen_cb, se05x_ecdh_derive_cb,
+                              se05x_ecdh_free_cb, NULL);
+}
+
+#endif /* MBEDTLS_SSL_ECDHE_CB */
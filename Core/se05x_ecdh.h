@@ -0,0 +1,119 @@
+/**
+ * @file se05x_ecdh.h
+ * @brief ECDHE ephemeral key generation and shared secret derivation on the
+ *        host or on the SE05x
+ */
+
+#ifndef SE05X_ECDH_H
+#define SE05X_ECDH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mbedtls/ssl.h"
+
+/* Maximum number of pre-generated ephemeral keys per side (host / SE05x) */
+#ifndef SE05X_ECDH_POOL_DEPTH
+#define SE05X_ECDH_POOL_DEPTH 2
+#endif
+
+/* Number of ephemeral keys that can exist at the same time, pooled keys of
+ * both sides included */
+#ifndef SE05X_ECDH_MAX_KEYS
+#define SE05X_ECDH_MAX_KEYS (2 + 2 * SE05X_ECDH_POOL_DEPTH)
+#endif
+
+/* First key ID used for transient ECDH objects (3 per ephemeral key) */
+#ifndef SE05X_ECDH_KEY_ID
+#define SE05X_ECDH_KEY_ID 0x7D000200
+#endif
+
+/* In auto mode, run one handshake on the slower side every N handshakes
+ * so its latency estimate stays current */
+#ifndef SE05X_ECDH_PROBE_INTERVAL
+#define SE05X_ECDH_PROBE_INTERVAL 16
+#endif
+
+/**
+ * @brief Where the ECDHE key pair and shared secret are computed
+ */
+typedef enum {
+    /* Per handshake, on whichever side has the lower measured latency */
+    SE05X_ECDH_MODE_AUTO = 0,
+    /* Always on the host */
+    SE05X_ECDH_MODE_HOST,
+    /* Always on the SE05x (secp256r1 only, other curves stay on the host) */
+    SE05X_ECDH_MODE_SE,
+} se05x_ecdh_mode_t;
+
+/**
+ * @brief ECDH counters, cycle values are from board_timing_cycles()
+ */
+typedef struct {
+    uint32_t host_count;
+    uint32_t host_cycles;
+    uint32_t se_count;
+    uint32_t se_cycles;
+    /* Moving averages of key generation + derivation used by auto mode */
+    uint32_t host_avg;
+    uint32_t se_avg;
+    /* Key generations served from / missing the pool, keys added to it */
+    uint32_t pool_hits;
+    uint32_t pool_misses;
+    uint32_t pool_refills;
+} se05x_ecdh_stats_t;
+
+/**
+ * @brief Select where ECDHE runs
+ * @param mode New mode
+ */
+void se05x_ecdh_set_mode(se05x_ecdh_mode_t mode);
+
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+/**
+ * @brief Register the ECDHE callbacks on a configuration
+ *
+ * The secp256r1 key exchange of handshakes using @p conf then runs on the
+ * side chosen by se05x_ecdh_set_mode() and takes pooled keys; other groups
+ * stay with PSA. Keys of aborted handshakes are erased when the SSL context
+ * is reset or freed.
+ *
+ * @param conf SSL configuration
+ */
+void se05x_ecdh_conf(mbedtls_ssl_config *conf);
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
+/**
+ * @brief Set the number of keys the pool keeps ready per side
+ * @param depth Pool depth, at most SE05X_ECDH_POOL_DEPTH, 0 disables the pool
+ */
+void se05x_ecdh_pool_set_depth(size_t depth);
+
+/**
+ * @brief Generate one pooled key for the side the next handshake would use
+ *
+ * Meant to be called from the idle loop or a low-priority task until it
+ * returns 0. Each pooled key is handed to exactly one handshake.
+ *
+ * @param f_rng RNG function for host keys
+ * @param p_rng RNG context
+ * @retval 1 if a key was added, 0 if the pool is full, negative on error
+ */
+int se05x_ecdh_pool_refill(int (*f_rng)(void *, unsigned char *, size_t), void *p_rng);
+
+/**
+ * @brief Erase all pooled keys
+ */
+void se05x_ecdh_pool_flush(void);
+
+/**
+ * @brief Get ECDH counters
+ * @param stats Filled with the current counters
+ */
+void se05x_ecdh_get_stats(se05x_ecdh_stats_t *stats);
+
+/**
+ * @brief Reset ECDH counters (moving averages are kept)
+ */
+void se05x_ecdh_reset_stats(void);
+
+#endif /* SE05X_ECDH_H */
@@ -7,10 +7,16 @@
 #define SE05X_INIT_H
 
 #include <stdint.h>
+#include "fsl_sss_api.h"
 
 /* Default key ID for TLS key */
 #define TLS_KEY_ID 0xF0000001
 
+/* SE05x contexts shared with the TLS client and the mbedTLS ALT glue */
+extern sss_session_t g_session;
+extern sss_key_store_t g_key_store;
+extern sss_object_t g_tls_key;
+
 /**
  * @brief Initialize SE05x secure element
  * @retval 0 if successful, non-zero otherwise
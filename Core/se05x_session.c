@@ -0,0 +1,418 @@
+/**
+ * @file se05x_session.c
+ * @brief TLS session persistence across resets, sealed by the SE05x
+ *
+ * Stored object layout:
+ *   iv(12) | encrypted serialized session | tag(16)
+ * with the server name as additional data. A fresh random IV is drawn from
+ * the SE05x for every write.
+ *
+ * TLS 1.3 servers send a new ticket on every connection. While the stored
+ * ticket still resumes, is younger than SE05X_SESSION_RENEW_PERCENT of its
+ * lifetime and allows early data whenever the new one does, the new ticket
+ * is dropped: a device that reports every few minutes then writes the object
+ * about once per half ticket lifetime instead of once per report.
+ */
+
+#include "se05x_session.h"
+#include "se05x_init.h"
+#include "board_timing.h"
+#include "mbedtls/platform_time.h"
+#include "mbedtls/platform_util.h"
+#include "psa/crypto.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SE05X_SESSION_KEY_LEN 32
+#define SE05X_SESSION_IV_LEN 12
+#define SE05X_SESSION_TAG_LEN 16
+#define SE05X_SESSION_BLOB_LEN \
+    (SE05X_SESSION_IV_LEN + SE05X_SESSION_MAX_LEN + SE05X_SESSION_TAG_LEN)
+
+static sss_object_t seal_key;
+static int seal_ready;
+
+/* Digest of each stored session and its server name, to skip identical
+ * writes */
+static uint8_t stored_digest[SE05X_SESSION_SLOTS][32];
+static int stored_known[SE05X_SESSION_SLOTS];
+
+/* When the stored TLS 1.3 ticket is due for replacement, in mbedtls_ms_time()
+ * milliseconds, 0 if the stored session has none, and whether it allows
+ * early data */
+static mbedtls_ms_time_t stored_renew[SE05X_SESSION_SLOTS];
+static uint8_t stored_early_data[SE05X_SESSION_SLOTS];
+
+static se05x_session_stats_t session_stats;
+
+/**
+ * @brief Digest a serialized session together with its server name
+ * @param session Serialized session
+ * @param len Length of @p session
+ * @param server Server name
+ * @param digest 32-byte SHA-256 output
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int se05x_session_digest(const uint8_t *session, size_t len, const char *server,
+                                uint8_t *digest)
+{
+    psa_hash_operation_t op = psa_hash_operation_init();
+    size_t digest_len;
+
+    if (psa_hash_setup(&op, PSA_ALG_SHA_256) != PSA_SUCCESS ||
+        psa_hash_update(&op, session, len) != PSA_SUCCESS ||
+        psa_hash_update(&op, (const uint8_t *)server, strlen(server)) != PSA_SUCCESS ||
+        psa_hash_finish(&op, digest, 32, &digest_len) != PSA_SUCCESS) {
+        psa_hash_abort(&op);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Get when the TLS 1.3 ticket of a session is due for replacement
+ * @param session Session holding the ticket
+ * @param renew Replacement time in mbedtls_ms_time() milliseconds, 0 if the
+ *        session holds no TLS 1.3 ticket
+ * @param early_data Set to 1 if the ticket allows early data
+ */
+static void se05x_session_ticket_renew(const mbedtls_ssl_session *session,
+                                       mbedtls_ms_time_t *renew, uint8_t *early_data)
+{
+    *renew = 0;
+    *early_data = 0;
+#if defined(MBEDTLS_HAVE_TIME) && defined(MBEDTLS_SSL_PROTO_TLS1_3) && \
+    defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+    if (session->MBEDTLS_PRIVATE(tls_version) != MBEDTLS_SSL_VERSION_TLS1_3 ||
+        session->MBEDTLS_PRIVATE(ticket_len) == 0) {
+        return;
+    }
+    /* Lifetime in seconds, times 1000 ms, times the percentage / 100 */
+    *renew = session->MBEDTLS_PRIVATE(ticket_reception_time) +
+             (mbedtls_ms_time_t)session->MBEDTLS_PRIVATE(ticket_lifetime) * 10 *
+             SE05X_SESSION_RENEW_PERCENT;
+#if defined(MBEDTLS_SSL_EARLY_DATA)
+    *early_data = session->MBEDTLS_PRIVATE(max_early_data_size) > 0;
+#endif
+#else
+    (void) session;
+#endif
+}
+
+/**
+ * @brief Check whether the stored ticket is still good enough to keep
+ * @param slot Storage slot
+ * @param ssl Context whose handshake is over
+ * @param early_data Whether the new ticket allows early data
+ * @retval 1 if the new ticket need not be written, 0 otherwise
+ */
+static int se05x_session_fresh(int slot, const mbedtls_ssl_context *ssl, uint8_t early_data)
+{
+#if defined(MBEDTLS_HAVE_TIME)
+    /* A full handshake means the server no longer takes the stored ticket */
+    return stored_renew[slot] != 0 && mbedtls_ssl_session_resumed(ssl) &&
+           mbedtls_ms_time() < stored_renew[slot] &&
+           (stored_early_data[slot] || !early_data);
+#else
+    (void) slot;
+    (void) ssl;
+    (void) early_data;
+    return 0;
+#endif
+}
+
+/**
+ * @brief AES-GCM with the sealing key on the SE05x
+ * @param encrypt 1 to encrypt and write @p tag, 0 to decrypt and check it
+ * @param iv 12-byte IV
+ * @param server Server name, authenticated as additional data
+ * @param buf Data, en- or decrypted in place
+ * @param len Length of @p buf
+ * @param tag 16-byte tag
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int se05x_session_gcm(int encrypt, const uint8_t *iv, const char *server,
+                             uint8_t *buf, size_t len, uint8_t *tag)
+{
+    sss_status_t status;
+    sss_aead_t ctx;
+    uint8_t nonce[SE05X_SESSION_IV_LEN];
+    size_t tag_len = SE05X_SESSION_TAG_LEN;
+
+    memcpy(nonce, iv, sizeof(nonce));
+
+    status = sss_aead_context_init(&ctx, &g_session, &seal_key, kAlgorithm_SSS_AES_GCM,
+                                   encrypt ? kMode_SSS_Encrypt : kMode_SSS_Decrypt);
+    if (status == kStatus_SSS_Success) {
+        status = sss_aead_one_go(&ctx, buf, buf, len, nonce, sizeof(nonce),
+                                 (const uint8_t *)server, strlen(server), tag, &tag_len);
+        sss_aead_context_free(&ctx);
+    }
+
+    if (status != kStatus_SSS_Success || tag_len != SE05X_SESSION_TAG_LEN) {
+        if (!encrypt) {
+            memset(buf, 0, len);
+        }
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Provision the sealing key on first boot
+ * @retval 0 if successful, non-zero otherwise
+ */
+int se05x_session_setup(void)
+{
+    sss_status_t status;
+    sss_rng_context_t rng;
+    uint8_t key[SE05X_SESSION_KEY_LEN];
+
+    if (seal_ready) {
+        return 0;
+    }
+
+    status = sss_key_object_init(&seal_key, &g_key_store);
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: Failed to initialize key object (status = 0x%X)\n", status);
+        return -1;
+    }
+
+    if (sss_key_object_get_handle(&seal_key, SE05X_SESSION_SEAL_KEY_ID) != kStatus_SSS_Success) {
+        /* First boot: the key passes through host RAM once here */
+        status = sss_key_object_allocate_handle(&seal_key, SE05X_SESSION_SEAL_KEY_ID,
+                                              kSSS_KeyPart_Default, kSSS_CipherType_AES,
+                                              SE05X_SESSION_KEY_LEN, kKeyObject_Mode_Persistent);
+        if (status == kStatus_SSS_Success) {
+            status = sss_rng_context_init(&rng, &g_session);
+            if (status == kStatus_SSS_Success) {
+                status = sss_rng_get_random(&rng, key, sizeof(key));
+                sss_rng_context_free(&rng);
+            }
+        }
+        if (status == kStatus_SSS_Success) {
+            status = sss_key_store_set_key(&g_key_store, &seal_key, key, sizeof(key),
+                                           SE05X_SESSION_KEY_LEN * 8, NULL, 0);
+        }
+        memset(key, 0, sizeof(key));
+        if (status != kStatus_SSS_Success) {
+            printf("ERROR: Failed to provision session sealing key (status = 0x%X)\n", status);
+            sss_key_object_free(&seal_key);
+            return -1;
+        }
+        printf("Provisioned session sealing key in SE05x (ID: 0x%08X)\n",
+               SE05X_SESSION_SEAL_KEY_ID);
+    }
+
+    seal_ready = 1;
+    return 0;
+}
+
+/**
+ * @brief Seal and store the session of a completed handshake
+ * @param slot Storage slot
+ * @param ssl Context whose handshake is over
+ * @param server Server name the session belongs to
+ * @retval 0 if stored or already stored, non-zero otherwise
+ */
+int se05x_session_save(int slot, const mbedtls_ssl_context *ssl, const char *server)
+{
+    static uint8_t blob[SE05X_SESSION_BLOB_LEN];
+    mbedtls_ssl_session session;
+    sss_status_t status;
+    sss_rng_context_t rng;
+    sss_object_t object;
+    uint8_t digest[32];
+    uint8_t *data = blob + SE05X_SESSION_IV_LEN;
+    uint32_t start = board_timing_cycles();
+    mbedtls_ms_time_t renew = 0;
+    uint8_t early_data = 0;
+    size_t len = 0;
+    int ret;
+
+    if (!seal_ready || slot < 0 || slot >= SE05X_SESSION_SLOTS) {
+        return -1;
+    }
+
+    mbedtls_ssl_session_init(&session);
+    ret = mbedtls_ssl_get_session(ssl, &session);
+    if (ret == 0) {
+        se05x_session_ticket_renew(&session, &renew, &early_data);
+        if (renew != 0 && se05x_session_fresh(slot, ssl, early_data)) {
+            mbedtls_ssl_session_free(&session);
+            session_stats.fresh++;
+            return 0;
+        }
+        ret = mbedtls_ssl_session_save(&session, data, SE05X_SESSION_MAX_LEN, &len);
+    }
+    mbedtls_ssl_session_free(&session);
+    if (ret != 0) {
+        printf("ERROR: Failed to serialize session (-0x%04X)\n", (unsigned int)-ret);
+        return -1;
+    }
+
+    if (se05x_session_digest(data, len, server, digest) != 0) {
+        mbedtls_platform_zeroize(data, len);
+        return -1;
+    }
+    if (stored_known[slot] && memcmp(digest, stored_digest[slot], sizeof(digest)) == 0) {
+        mbedtls_platform_zeroize(data, len);
+        session_stats.unchanged++;
+        return 0;
+    }
+
+    status = sss_rng_context_init(&rng, &g_session);
+    if (status == kStatus_SSS_Success) {
+        status = sss_rng_get_random(&rng, blob, SE05X_SESSION_IV_LEN);
+        sss_rng_context_free(&rng);
+    }
+    ret = status == kStatus_SSS_Success ?
+          se05x_session_gcm(1, blob, server, data, len, data + len) : -1;
+    if (ret != 0) {
+        mbedtls_platform_zeroize(data, len);
+        printf("ERROR: Failed to seal session\n");
+        return -1;
+    }
+    len += SE05X_SESSION_IV_LEN + SE05X_SESSION_TAG_LEN;
+
+    /* Binary objects have a fixed size, replace the previous one */
+    stored_known[slot] = 0;
+    stored_renew[slot] = 0;
+    status = sss_key_object_init(&object, &g_key_store);
+    if (status == kStatus_SSS_Success &&
+        sss_key_object_get_handle(&object, SE05X_SESSION_OBJECT_ID + slot) == kStatus_SSS_Success) {
+        status = sss_key_store_erase_key(&g_key_store, &object);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_object_allocate_handle(&object, SE05X_SESSION_OBJECT_ID + slot,
+                                              kSSS_KeyPart_Default, kSSS_CipherType_Binary,
+                                              len, kKeyObject_Mode_Persistent);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_store_set_key(&g_key_store, &object, blob, len, len * 8, NULL, 0);
+    }
+    sss_key_object_free(&object);
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: Failed to store session (status = 0x%X)\n", status);
+        return -1;
+    }
+
+    memcpy(stored_digest[slot], digest, sizeof(digest));
+    stored_known[slot] = 1;
+    stored_renew[slot] = renew;
+    stored_early_data[slot] = early_data;
+    session_stats.saved++;
+    session_stats.save_cycles += board_timing_cycles() - start;
+    return 0;
+}
+
+/**
+ * @brief Restore the stored session into a new connection
+ * @param slot Storage slot the session was saved to
+ * @param ssl Context set up with mbedtls_ssl_setup()
+ * @param server Server name the connection is for
+ * @retval 0 if a session was restored, non-zero otherwise
+ */
+int se05x_session_load(int slot, mbedtls_ssl_context *ssl, const char *server)
+{
+    static uint8_t blob[SE05X_SESSION_BLOB_LEN];
+    mbedtls_ssl_session session;
+    sss_status_t status;
+    sss_object_t object;
+    uint8_t *data = blob + SE05X_SESSION_IV_LEN;
+    uint32_t start = board_timing_cycles();
+    size_t len = sizeof(blob);
+    size_t bit_len = 0;
+    int ret;
+
+    if (!seal_ready || slot < 0 || slot >= SE05X_SESSION_SLOTS) {
+        return -1;
+    }
+    stored_renew[slot] = 0;
+
+    status = sss_key_object_init(&object, &g_key_store);
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_object_get_handle(&object, SE05X_SESSION_OBJECT_ID + slot);
+        if (status == kStatus_SSS_Success) {
+            status = sss_key_store_get_key(&g_key_store, &object, blob, &len, &bit_len);
+        }
+        sss_key_object_free(&object);
+    }
+    if (status != kStatus_SSS_Success) {
+        /* Nothing stored yet */
+        return -1;
+    }
+
+    if (len < SE05X_SESSION_IV_LEN + SE05X_SESSION_TAG_LEN ||
+        se05x_session_gcm(0, blob, server, data,
+                          len - SE05X_SESSION_IV_LEN - SE05X_SESSION_TAG_LEN,
+                          blob + len - SE05X_SESSION_TAG_LEN) != 0) {
+        printf("WARNING: Stored session rejected for %s\n", server);
+        session_stats.rejected++;
+        return -1;
+    }
+    len -= SE05X_SESSION_IV_LEN + SE05X_SESSION_TAG_LEN;
+
+    mbedtls_ssl_session_init(&session);
+    ret = mbedtls_ssl_session_load(&session, data, len);
+    if (ret == 0) {
+        ret = mbedtls_ssl_set_session(ssl, &session);
+    }
+    if (ret == 0) {
+        se05x_session_ticket_renew(&session, &stored_renew[slot], &stored_early_data[slot]);
+    }
+    mbedtls_ssl_session_free(&session);
+
+    /* A session from another mbedTLS build or configuration is dropped */
+    if (ret != 0) {
+        printf("WARNING: Stored session not usable (-0x%04X)\n", (unsigned int)-ret);
+        mbedtls_platform_zeroize(data, len);
+        session_stats.rejected++;
+        return -1;
+    }
+
+    stored_known[slot] = se05x_session_digest(data, len, server, stored_digest[slot]) == 0;
+    mbedtls_platform_zeroize(data, len);
+    session_stats.loaded++;
+    session_stats.load_cycles += board_timing_cycles() - start;
+    return 0;
+}
+
+/**
+ * @brief Delete a stored session
+ * @param slot Storage slot to clear
+ */
+void se05x_session_erase(int slot)
+{
+    sss_object_t object;
+
+    if (slot < 0 || slot >= SE05X_SESSION_SLOTS) {
+        return;
+    }
+    stored_known[slot] = 0;
+    stored_renew[slot] = 0;
+    if (sss_key_object_init(&object, &g_key_store) != kStatus_SSS_Success) {
+        return;
+    }
+    if (sss_key_object_get_handle(&object, SE05X_SESSION_OBJECT_ID + slot) == kStatus_SSS_Success) {
+        sss_key_store_erase_key(&g_key_store, &object);
+    }
+    sss_key_object_free(&object);
+}
+
+/**
+ * @brief Get persistence counters
+ * @param stats Filled with the current counters
+ */
+void se05x_session_get_stats(se05x_session_stats_t *stats)
+{
+    *stats = session_stats;
+}
+
+/**
+ * @brief Reset persistence counters
+ */
+void se05x_session_reset_stats(void)
+{
+    memset(&session_stats, 0, sizeof(session_stats));
+}
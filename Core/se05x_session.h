@@ -0,0 +1,122 @@
+/**
+ * @file se05x_session.h
+ * @brief TLS session persistence across resets, sealed by the SE05x
+ *
+ * The resumable session of the last full handshake (master secret, session
+ * ID or ticket, peer certificate digest) is serialized with
+ * mbedtls_ssl_session_save(), encrypted with AES-GCM under a persistent
+ * SE05x key that never leaves it, and kept in an SE05x binary object. After a
+ * reset it is decrypted and handed to mbedtls_ssl_set_session(), so the
+ * first connection is an abbreviated handshake: no client signature, no
+ * ECDHE and no chain verification.
+ *
+ * The I2C link runs without SCP03, so the session is sealed before it
+ * crosses the bus. The server name is authenticated with it. To spare SE05x
+ * flash and APDUs, the object is only rewritten when the session changed
+ * and, for TLS 1.3, when the stored ticket has used up
+ * SE05X_SESSION_RENEW_PERCENT of its lifetime or a new ticket allows early
+ * data where the stored one does not.
+ */
+
+#ifndef SE05X_SESSION_H
+#define SE05X_SESSION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fsl_sss_api.h"
+#include "mbedtls/ssl.h"
+
+/* Persistent AES-256 key sealing the stored session */
+#ifndef SE05X_SESSION_SEAL_KEY_ID
+#define SE05X_SESSION_SEAL_KEY_ID 0xF0000020
+#endif
+
+/* Persistent binary object holding the sealed session of slot 0, the
+ * following slots use the following IDs */
+#ifndef SE05X_SESSION_OBJECT_ID
+#define SE05X_SESSION_OBJECT_ID 0xF0000021
+#endif
+
+/* A TLS 1.3 ticket is replaced once this share of its lifetime has passed,
+ * later tickets from the server are dropped until then */
+#ifndef SE05X_SESSION_RENEW_PERCENT
+#define SE05X_SESSION_RENEW_PERCENT 50
+#endif
+
+/* Sessions kept at the same time, one per client */
+#define SE05X_SESSION_SLOT_TLS 0
+#define SE05X_SESSION_SLOT_DTLS 1
+#define SE05X_SESSION_SLOTS 2
+
+/* Largest serialized session, a session ticket included. TLS 1.2 sessions
+ * carry the whole server certificate when it is kept for TLS 1.3. */
+#ifndef SE05X_SESSION_MAX_LEN
+#if defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+#define SE05X_SESSION_MAX_LEN 2048
+#else
+#define SE05X_SESSION_MAX_LEN 512
+#endif
+#endif
+
+/**
+ * @brief Persistence counters, cycle totals are from board_timing_cycles()
+ */
+typedef struct {
+    uint32_t saved;
+    uint32_t save_cycles;
+    uint32_t unchanged;
+    /* New tickets not written because the stored one is still fresh */
+    uint32_t fresh;
+    uint32_t loaded;
+    uint32_t load_cycles;
+    uint32_t rejected;
+} se05x_session_stats_t;
+
+/**
+ * @brief Provision the sealing key on first boot
+ * @retval 0 if successful, non-zero otherwise
+ */
+int se05x_session_setup(void);
+
+/**
+ * @brief Seal and store the session of a completed handshake
+ * @param slot Storage slot, e.g. SE05X_SESSION_SLOT_TLS
+ * @param ssl Context whose handshake is over
+ * @param server Server name the session belongs to
+ * @retval 0 if stored, already stored or the stored ticket is still fresh,
+ *         non-zero otherwise
+ */
+int se05x_session_save(int slot, const mbedtls_ssl_context *ssl, const char *server);
+
+/**
+ * @brief Restore the stored session into a new connection
+ *
+ * Call after mbedtls_ssl_setup() and before the handshake. If the server no
+ * longer knows the session, the handshake falls back to a full one.
+ *
+ * @param slot Storage slot the session was saved to
+ * @param ssl Context set up with mbedtls_ssl_setup()
+ * @param server Server name the connection is for
+ * @retval 0 if a session was restored, non-zero if none is stored, it was
+ *         stored for another server or it fails authentication
+ */
+int se05x_session_load(int slot, mbedtls_ssl_context *ssl, const char *server);
+
+/**
+ * @brief Delete a stored session, e.g. when the server rejects it
+ * @param slot Storage slot to clear
+ */
+void se05x_session_erase(int slot);
+
+/**
+ * @brief Get persistence counters
+ * @param stats Filled with the current counters
+ */
+void se05x_session_get_stats(se05x_session_stats_t *stats);
+
+/**
+ * @brief Reset persistence counters
+ */
+void se05x_session_reset_stats(void);
+
+#endif /* SE05X_SESSION_H */
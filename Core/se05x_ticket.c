@@ -0,0 +1,517 @@
+/**
+ * @file se05x_ticket.c
+ * @brief Session ticket protection with keys derived on the SE05x
+ *
+ * A persistent HMAC master key in the SE05x never leaves it. Time is cut
+ * into epochs of one ticket lifetime, and the AES-256 key of an epoch is
+ * HKDF-Expand(master, "se05x ticket" || epoch), computed by
+ * sss_derive_key_one_go(). In SE05X_TICKET_MODE_SE the epoch key is derived
+ * into a transient AES object and every ticket goes through sss_aead_one_go();
+ * in SE05X_TICKET_MODE_HOST it is read back once per epoch and tickets are
+ * sealed with PSA AES-GCM on the host under a volatile key. The keys of the
+ * current and the previous epoch are kept, the key name of a ticket is its
+ * epoch number.
+ *
+ * Ticket layout matches library/ssl_ticket.c:
+ *   key_name(4) | iv(12) | state_len(2) | encrypted state | tag(16)
+ * The session is serialized and encrypted in place in the caller's buffer.
+ */
+
+#include "se05x_ticket.h"
+#include "se05x_init.h"
+#include "board_timing.h"
+#include "psa/crypto.h"
+#include "mbedtls/platform_time.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SE05X_TICKET_KEY_LEN 32
+#define SE05X_TICKET_NAME_LEN 4
+#define SE05X_TICKET_IV_LEN 12
+#define SE05X_TICKET_LEN_LEN 2
+#define SE05X_TICKET_TAG_LEN 16
+#define SE05X_TICKET_HDR_LEN (SE05X_TICKET_NAME_LEN + SE05X_TICKET_IV_LEN + SE05X_TICKET_LEN_LEN)
+
+static const uint8_t ticket_label[] = "se05x ticket";
+
+/* Key of one epoch: a transient SE05x object, or a volatile PSA key */
+typedef struct {
+    uint32_t epoch;
+    uint8_t valid;
+    sss_object_t key;
+    mbedtls_svc_key_id_t psa_key;
+} se05x_ticket_key_t;
+
+static se05x_ticket_mode_t ticket_mode = SE05X_TICKET_MODE_SE;
+static uint32_t ticket_lifetime;
+static sss_object_t ticket_master;
+static uint8_t ticket_ready;
+static se05x_ticket_key_t ticket_keys[2];
+static uint8_t iv_prefix[SE05X_TICKET_IV_LEN - 4];
+static uint32_t iv_counter;
+static se05x_ticket_stats_t ticket_stats;
+
+/**
+ * @brief AES-GCM with a 96-bit IV on the host, in place
+ * @param k Epoch key
+ * @param encrypt 1 to encrypt and write @p tag, 0 to decrypt and check it
+ * @param iv 12-byte IV
+ * @param aad Additional data
+ * @param aad_len Length of @p aad
+ * @param buf Data, en- or decrypted in place
+ * @param len Length of @p buf
+ * @param tag 16-byte tag, must follow @p buf directly
+ * @retval 0 if successful, MBEDTLS_ERR_SSL_INVALID_MAC otherwise
+ */
+static int se05x_ticket_gcm_host(const se05x_ticket_key_t *k, int encrypt, const uint8_t *iv,
+                                 const uint8_t *aad, size_t aad_len,
+                                 uint8_t *buf, size_t len, uint8_t *tag)
+{
+    psa_status_t status;
+    size_t out_len = 0;
+
+    /* PSA AEAD works on ciphertext || tag, which is the ticket layout */
+    if (tag != buf + len) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (encrypt) {
+        status = psa_aead_encrypt(k->psa_key, PSA_ALG_GCM, iv, SE05X_TICKET_IV_LEN,
+                                  aad, aad_len, buf, len,
+                                  buf, len + SE05X_TICKET_TAG_LEN, &out_len);
+        if (status == PSA_SUCCESS && out_len != len + SE05X_TICKET_TAG_LEN) {
+            status = PSA_ERROR_CORRUPTION_DETECTED;
+        }
+    } else {
+        status = psa_aead_decrypt(k->psa_key, PSA_ALG_GCM, iv, SE05X_TICKET_IV_LEN,
+                                  aad, aad_len, buf, len + SE05X_TICKET_TAG_LEN,
+                                  buf, len, &out_len);
+        if (status == PSA_SUCCESS && out_len != len) {
+            status = PSA_ERROR_CORRUPTION_DETECTED;
+        }
+    }
+
+    if (status != PSA_SUCCESS) {
+        /* Do not hand back unauthenticated plaintext */
+        if (!encrypt) {
+            memset(buf, 0, len);
+        }
+        return MBEDTLS_ERR_SSL_INVALID_MAC;
+    }
+    return 0;
+}
+
+/**
+ * @brief Import a host copy of an epoch key as a volatile PSA key
+ * @param k Epoch key
+ * @param key Raw AES-256 key
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int se05x_ticket_host_setkey(se05x_ticket_key_t *k, const uint8_t *key)
+{
+    psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+    psa_status_t status;
+
+    psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT);
+    psa_set_key_algorithm(&attributes, PSA_ALG_GCM);
+    psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
+    psa_set_key_bits(&attributes, SE05X_TICKET_KEY_LEN * 8);
+
+    status = psa_import_key(&attributes, key, SE05X_TICKET_KEY_LEN, &k->psa_key);
+    psa_reset_key_attributes(&attributes);
+    if (status != PSA_SUCCESS) {
+        printf("ERROR: Failed to import ticket key (status = %d)\n", (int)status);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief AES-GCM on the SE05x, in place
+ * @param k Epoch key
+ * @param encrypt 1 to encrypt and write @p tag, 0 to decrypt and check it
+ * @param iv 12-byte IV
+ * @param aad Additional data
+ * @param aad_len Length of @p aad
+ * @param buf Data, en- or decrypted in place
+ * @param len Length of @p buf
+ * @param tag 16-byte tag
+ * @retval 0 if successful, MBEDTLS_ERR_SSL_INVALID_MAC otherwise
+ */
+static int se05x_ticket_gcm_se(se05x_ticket_key_t *k, int encrypt, const uint8_t *iv,
+                               const uint8_t *aad, size_t aad_len,
+                               uint8_t *buf, size_t len, uint8_t *tag)
+{
+    sss_status_t status;
+    sss_aead_t ctx;
+    uint8_t nonce[SE05X_TICKET_IV_LEN];
+    size_t tag_len = SE05X_TICKET_TAG_LEN;
+
+    memcpy(nonce, iv, sizeof(nonce));
+
+    status = sss_aead_context_init(&ctx, &g_session, &k->key, kAlgorithm_SSS_AES_GCM,
+                                   encrypt ? kMode_SSS_Encrypt : kMode_SSS_Decrypt);
+    if (status == kStatus_SSS_Success) {
+        status = sss_aead_one_go(&ctx, buf, buf, len, nonce, sizeof(nonce),
+                                 aad, aad_len, tag, &tag_len);
+        sss_aead_context_free(&ctx);
+    }
+
+    if (status != kStatus_SSS_Success || tag_len != SE05X_TICKET_TAG_LEN) {
+        if (!encrypt) {
+            memset(buf, 0, len);
+        }
+        return MBEDTLS_ERR_SSL_INVALID_MAC;
+    }
+    return 0;
+}
+
+/**
+ * @brief Erase an epoch key
+ * @param k Epoch key
+ */
+static void se05x_ticket_key_clear(se05x_ticket_key_t *k)
+{
+    if (k->key.keyStore != NULL) {
+        sss_key_store_erase_key(&g_key_store, &k->key);
+        sss_key_object_free(&k->key);
+    }
+    psa_destroy_key(k->psa_key);
+    memset(k, 0, sizeof(*k));
+}
+
+/**
+ * @brief Derive the key of an epoch into its slot
+ * @param epoch Epoch number
+ * @retval Epoch key, or NULL on failure
+ */
+static se05x_ticket_key_t *se05x_ticket_key_get(uint32_t epoch)
+{
+    se05x_ticket_key_t *k = &ticket_keys[epoch & 1];
+    sss_status_t status;
+    sss_derive_key_t ctx;
+    uint8_t info[sizeof(ticket_label) - 1 + 4];
+    uint8_t raw[SE05X_TICKET_KEY_LEN];
+    size_t raw_len = sizeof(raw);
+    size_t bit_len = 0;
+    int ret = 0;
+
+    if (k->valid && k->epoch == epoch) {
+        return k;
+    }
+
+    se05x_ticket_key_clear(k);
+
+    memcpy(info, ticket_label, sizeof(ticket_label) - 1);
+    info[sizeof(info) - 4] = (uint8_t)(epoch >> 24);
+    info[sizeof(info) - 3] = (uint8_t)(epoch >> 16);
+    info[sizeof(info) - 2] = (uint8_t)(epoch >> 8);
+    info[sizeof(info) - 1] = (uint8_t)epoch;
+
+    status = sss_key_object_init(&k->key, &g_key_store);
+    if (status == kStatus_SSS_Success) {
+        /* An AES object can only be used inside the SE05x, an HMAC object
+         * can be read back */
+        status = sss_key_object_allocate_handle(&k->key, SE05X_TICKET_KEY_ID + (epoch & 1),
+                                              kSSS_KeyPart_Default,
+                                              ticket_mode == SE05X_TICKET_MODE_SE ?
+                                                  kSSS_CipherType_AES : kSSS_CipherType_HMAC,
+                                              SE05X_TICKET_KEY_LEN, kKeyObject_Mode_Transient);
+    }
+    if (status == kStatus_SSS_Success) {
+        status = sss_derive_key_context_init(&ctx, &g_session, &ticket_master,
+                                           kAlgorithm_SSS_HMAC_SHA256, kMode_SSS_HKDF_ExpandOnly);
+        if (status == kStatus_SSS_Success) {
+            status = sss_derive_key_one_go(&ctx, NULL, 0, info, sizeof(info),
+                                           &k->key, SE05X_TICKET_KEY_LEN);
+            sss_derive_key_context_free(&ctx);
+        }
+    }
+    if (status == kStatus_SSS_Success && ticket_mode == SE05X_TICKET_MODE_HOST) {
+        status = sss_key_store_get_key(&g_key_store, &k->key, raw, &raw_len, &bit_len);
+        if (status == kStatus_SSS_Success) {
+            ret = raw_len == SE05X_TICKET_KEY_LEN ? se05x_ticket_host_setkey(k, raw) : -1;
+        }
+        memset(raw, 0, sizeof(raw));
+        /* The host copy is all that is needed from now on */
+        sss_key_store_erase_key(&g_key_store, &k->key);
+        sss_key_object_free(&k->key);
+        memset(&k->key, 0, sizeof(k->key));
+    }
+
+    if (status != kStatus_SSS_Success || ret != 0) {
+        printf("ERROR: Ticket key derivation in SE05x failed (status = 0x%X)\n", status);
+        se05x_ticket_key_clear(k);
+        return NULL;
+    }
+
+    k->epoch = epoch;
+    k->valid = 1;
+    ticket_stats.derivations++;
+    return k;
+}
+
+/**
+ * @brief Current epoch number
+ */
+static uint32_t se05x_ticket_epoch(void)
+{
+#if defined(MBEDTLS_HAVE_TIME)
+    return (uint32_t)((uint64_t)mbedtls_time(NULL) / ticket_lifetime);
+#else
+    /* Without a clock, keys are only replaced by se05x_ticket_setup() */
+    return 0;
+#endif
+}
+
+/**
+ * @brief Provision the master key if needed and select the ticket mode
+ * @param mode Where ticket encryption runs
+ * @param lifetime Epoch length and advertised ticket lifetime in seconds
+ * @retval 0 if successful, non-zero otherwise
+ */
+int se05x_ticket_setup(se05x_ticket_mode_t mode, uint32_t lifetime)
+{
+    sss_status_t status;
+    sss_rng_context_t rng;
+    uint8_t master[SE05X_TICKET_KEY_LEN];
+
+    if (lifetime == 0) {
+        return -1;
+    }
+
+    se05x_ticket_free();
+    ticket_mode = mode;
+    ticket_lifetime = lifetime;
+
+    status = sss_rng_context_init(&rng, &g_session);
+    if (status == kStatus_SSS_Success) {
+        status = sss_rng_get_random(&rng, iv_prefix, sizeof(iv_prefix));
+    }
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: Failed to get random IV prefix (status = 0x%X)\n", status);
+        sss_rng_context_free(&rng);
+        return -1;
+    }
+    iv_counter = 0;
+
+    status = sss_key_object_init(&ticket_master, &g_key_store);
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: Failed to initialize key object (status = 0x%X)\n", status);
+        sss_rng_context_free(&rng);
+        return -1;
+    }
+
+    if (sss_key_object_get_handle(&ticket_master, SE05X_TICKET_MASTER_KEY_ID) != kStatus_SSS_Success) {
+        /* First boot: the master key passes through host RAM once here */
+        status = sss_key_object_allocate_handle(&ticket_master, SE05X_TICKET_MASTER_KEY_ID,
+                                              kSSS_KeyPart_Default, kSSS_CipherType_HMAC,
+                                              SE05X_TICKET_KEY_LEN, kKeyObject_Mode_Persistent);
+        if (status == kStatus_SSS_Success) {
+            status = sss_rng_get_random(&rng, master, sizeof(master));
+        }
+        if (status == kStatus_SSS_Success) {
+            status = sss_key_store_set_key(&g_key_store, &ticket_master, master, sizeof(master),
+                                           SE05X_TICKET_KEY_LEN * 8, NULL, 0);
+        }
+        memset(master, 0, sizeof(master));
+        if (status != kStatus_SSS_Success) {
+            printf("ERROR: Failed to provision ticket master key (status = 0x%X)\n", status);
+            sss_key_object_free(&ticket_master);
+            sss_rng_context_free(&rng);
+            return -1;
+        }
+        printf("Provisioned ticket master key in SE05x (ID: 0x%08X)\n", SE05X_TICKET_MASTER_KEY_ID);
+    }
+
+    sss_rng_context_free(&rng);
+    ticket_ready = 1;
+    return 0;
+}
+
+/**
+ * @brief Ticket write callback, see mbedtls_ssl_ticket_write_t
+ */
+int se05x_ticket_write(void *p_ticket, const mbedtls_ssl_session *session,
+                       unsigned char *start, const unsigned char *end,
+                       size_t *tlen, uint32_t *lifetime)
+{
+    unsigned char *name = start;
+    unsigned char *iv = name + SE05X_TICKET_NAME_LEN;
+    unsigned char *len_bytes = iv + SE05X_TICKET_IV_LEN;
+    unsigned char *state = start + SE05X_TICKET_HDR_LEN;
+    se05x_ticket_key_t *k;
+    uint32_t start_cycles = board_timing_cycles();
+    uint32_t epoch;
+    size_t clear_len;
+    int ret;
+
+    (void) p_ticket;
+    *tlen = 0;
+
+    if (!ticket_ready) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    if (end - start < SE05X_TICKET_HDR_LEN + SE05X_TICKET_TAG_LEN) {
+        return MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+    }
+
+    epoch = se05x_ticket_epoch();
+    k = se05x_ticket_key_get(epoch);
+    if (k == NULL) {
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FAILED;
+    }
+
+    name[0] = (uint8_t)(epoch >> 24);
+    name[1] = (uint8_t)(epoch >> 16);
+    name[2] = (uint8_t)(epoch >> 8);
+    name[3] = (uint8_t)epoch;
+
+    /* Random per-boot prefix and a counter: unique without an RNG call */
+    memcpy(iv, iv_prefix, sizeof(iv_prefix));
+    iv[8] = (uint8_t)(iv_counter >> 24);
+    iv[9] = (uint8_t)(iv_counter >> 16);
+    iv[10] = (uint8_t)(iv_counter >> 8);
+    iv[11] = (uint8_t)iv_counter;
+    iv_counter++;
+
+    ret = mbedtls_ssl_session_save(session, state,
+                                   (size_t)(end - state) - SE05X_TICKET_TAG_LEN, &clear_len);
+    if (ret != 0) {
+        return ret;
+    }
+    if (clear_len > 0xFFFF) {
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+    len_bytes[0] = (uint8_t)(clear_len >> 8);
+    len_bytes[1] = (uint8_t)clear_len;
+
+    if (ticket_mode == SE05X_TICKET_MODE_SE) {
+        ret = se05x_ticket_gcm_se(k, 1, iv, start, SE05X_TICKET_HDR_LEN,
+                                  state, clear_len, state + clear_len);
+    } else {
+        ret = se05x_ticket_gcm_host(k, 1, iv, start, SE05X_TICKET_HDR_LEN,
+                                    state, clear_len, state + clear_len);
+    }
+    if (ret != 0) {
+        memset(state, 0, clear_len);
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FAILED;
+    }
+
+    *tlen = SE05X_TICKET_HDR_LEN + clear_len + SE05X_TICKET_TAG_LEN;
+    *lifetime = ticket_lifetime;
+
+    ticket_stats.written++;
+    ticket_stats.write_cycles += board_timing_cycles() - start_cycles;
+    return 0;
+}
+
+/**
+ * @brief Ticket parse callback, see mbedtls_ssl_ticket_parse_t
+ */
+int se05x_ticket_parse(void *p_ticket, mbedtls_ssl_session *session,
+                       unsigned char *buf, size_t len)
+{
+    unsigned char *iv = buf + SE05X_TICKET_NAME_LEN;
+    unsigned char *state = buf + SE05X_TICKET_HDR_LEN;
+    se05x_ticket_key_t *k;
+    uint32_t start_cycles = board_timing_cycles();
+    uint32_t epoch;
+    uint32_t current;
+    size_t enc_len;
+    int ret;
+
+    (void) p_ticket;
+
+    if (!ticket_ready || len < SE05X_TICKET_HDR_LEN + SE05X_TICKET_TAG_LEN) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    enc_len = ((size_t)buf[16] << 8) | buf[17];
+    if (len != SE05X_TICKET_HDR_LEN + enc_len + SE05X_TICKET_TAG_LEN) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    epoch = ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
+            ((uint32_t)buf[2] << 8) | buf[3];
+    current = se05x_ticket_epoch();
+    if (epoch != current && epoch + 1 != current) {
+        ticket_stats.rejected++;
+        return MBEDTLS_ERR_SSL_SESSION_TICKET_EXPIRED;
+    }
+
+    k = se05x_ticket_key_get(epoch);
+    if (k == NULL) {
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FAILED;
+    }
+
+    if (ticket_mode == SE05X_TICKET_MODE_SE) {
+        ret = se05x_ticket_gcm_se(k, 0, iv, buf, SE05X_TICKET_HDR_LEN,
+                                  state, enc_len, state + enc_len);
+    } else {
+        ret = se05x_ticket_gcm_host(k, 0, iv, buf, SE05X_TICKET_HDR_LEN,
+                                    state, enc_len, state + enc_len);
+    }
+    if (ret != 0) {
+        ticket_stats.rejected++;
+        return ret;
+    }
+
+    ret = mbedtls_ssl_session_load(session, state, enc_len);
+    memset(state, 0, enc_len);
+    if (ret != 0) {
+        return ret;
+    }
+
+#if defined(MBEDTLS_HAVE_TIME) && defined(MBEDTLS_SSL_SESSION_TICKETS) && \
+    defined(MBEDTLS_SSL_SRV_C)
+    {
+        mbedtls_ms_time_t created;
+        mbedtls_ms_time_t age;
+
+        ret = mbedtls_ssl_session_get_ticket_creation_time(session, &created);
+        if (ret != 0) {
+            return ret;
+        }
+        age = mbedtls_ms_time() - created;
+        if (age < 0 || age > (mbedtls_ms_time_t)ticket_lifetime * 1000) {
+            ticket_stats.rejected++;
+            return MBEDTLS_ERR_SSL_SESSION_TICKET_EXPIRED;
+        }
+    }
+#endif
+
+    ticket_stats.parsed++;
+    ticket_stats.parse_cycles += board_timing_cycles() - start_cycles;
+    return 0;
+}
+
+/**
+ * @brief Erase the cached epoch keys and their transient SE objects
+ */
+void se05x_ticket_free(void)
+{
+    se05x_ticket_key_clear(&ticket_keys[0]);
+    se05x_ticket_key_clear(&ticket_keys[1]);
+    if (ticket_ready) {
+        sss_key_object_free(&ticket_master);
+        ticket_ready = 0;
+    }
+}
+
+/**
+ * @brief Get ticket counters
+ * @param stats Filled with the current counters
+ */
+void se05x_ticket_get_stats(se05x_ticket_stats_t *stats)
+{
+    *stats = ticket_stats;
+}
+
+/**
+ * @brief Reset ticket counters
+ */
+void se05x_ticket_reset_stats(void)
+{
+    memset(&ticket_stats, 0, sizeof(ticket_stats));
+}
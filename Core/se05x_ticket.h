@@ -0,0 +1,95 @@
+/**
+ * @file se05x_ticket.h
+ * @brief Session ticket protection with keys derived on the SE05x
+ */
+
+#ifndef SE05X_TICKET_H
+#define SE05X_TICKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fsl_sss_api.h"
+#include "mbedtls/ssl.h"
+
+/* Persistent HMAC master key the per-epoch ticket keys are derived from */
+#ifndef SE05X_TICKET_MASTER_KEY_ID
+#define SE05X_TICKET_MASTER_KEY_ID 0xF0000010
+#endif
+
+/* First of the two transient key IDs holding epoch keys (current, previous) */
+#ifndef SE05X_TICKET_KEY_ID
+#define SE05X_TICKET_KEY_ID 0x7D000300
+#endif
+
+/**
+ * @brief Where ticket encryption runs
+ */
+typedef enum {
+    /* Epoch keys are AES objects that never leave the SE05x, AES-GCM runs
+     * on the SE05x for every ticket */
+    SE05X_TICKET_MODE_SE = 0,
+    /* Epoch keys are derived on the SE05x once per epoch and cached on the
+     * host as volatile PSA keys, PSA AES-GCM runs for every ticket */
+    SE05X_TICKET_MODE_HOST,
+} se05x_ticket_mode_t;
+
+/**
+ * @brief Ticket counters, cycle totals are from board_timing_cycles()
+ */
+typedef struct {
+    uint32_t written;
+    uint32_t write_cycles;
+    uint32_t parsed;
+    uint32_t parse_cycles;
+    uint32_t rejected;
+    uint32_t derivations;
+} se05x_ticket_stats_t;
+
+/**
+ * @brief Provision the master key if needed and select the ticket mode
+ *
+ * Tickets are accepted for the epoch they were written in and the next one,
+ * so their lifetime is between @p lifetime and twice @p lifetime.
+ *
+ * @param mode Where ticket encryption runs
+ * @param lifetime Epoch length and advertised ticket lifetime in seconds
+ * @retval 0 if successful, non-zero otherwise
+ */
+int se05x_ticket_setup(se05x_ticket_mode_t mode, uint32_t lifetime);
+
+/**
+ * @brief Ticket write callback, see mbedtls_ssl_ticket_write_t
+ *
+ * Register with mbedtls_ssl_conf_session_tickets_cb() together with
+ * se05x_ticket_parse(). The session is serialized and encrypted in place in
+ * the output buffer; no heap memory is used.
+ */
+int se05x_ticket_write(void *p_ticket, const mbedtls_ssl_session *session,
+                       unsigned char *start, const unsigned char *end,
+                       size_t *tlen, uint32_t *lifetime);
+
+/**
+ * @brief Ticket parse callback, see mbedtls_ssl_ticket_parse_t
+ *
+ * The ticket is decrypted in place in @p buf.
+ */
+int se05x_ticket_parse(void *p_ticket, mbedtls_ssl_session *session,
+                       unsigned char *buf, size_t len);
+
+/**
+ * @brief Erase the cached epoch keys and their transient SE objects
+ */
+void se05x_ticket_free(void);
+
+/**
+ * @brief Get ticket counters
+ * @param stats Filled with the current counters
+ */
+void se05x_ticket_get_stats(se05x_ticket_stats_t *stats);
+
+/**
+ * @brief Reset ticket counters
+ */
+void se05x_ticket_reset_stats(void);
+
+#endif /* SE05X_TICKET_H */
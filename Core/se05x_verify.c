@@ -0,0 +1,421 @@
+/**
+ * @file se05x_verify.c
+ * @brief ECDSA verification routing between host mbedTLS and SE05x
+ *
+ * With MBEDTLS_ECDSA_VERIFY_ALT every mbedtls_ecdsa_verify() call lands here.
+ * Signatures against keys that live in the SE05x are checked by the SE05x,
+ * public-only keys (peer certificates, CA keys) are checked on the host with
+ * the original mbedTLS code, which saves one APDU round trip per signature in
+ * the certificate chain.
+ */
+
+#include "se05x_verify.h"
+#include "se05x_init.h"
+#include "board_timing.h"
+#include "ecp_p256_comb.h"
+#include "fsl_sss_util_asn1_der.h"
+#include "fsl_sss_mbedtls_apis.h"
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/asn1write.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Uncompressed NIST P-256 point: 0x04 || X || Y */
+#define SE05X_VERIFY_POINT_LEN 65
+
+/* SubjectPublicKeyInfo header for an uncompressed NIST P-256 point */
+static const uint8_t p256_spki_header[] = {
+    0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01,
+    0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00,
+};
+
+/* SE-resident key and its public point, read once at registration */
+typedef struct {
+    sss_object_t *key;
+    uint8_t point[SE05X_VERIFY_POINT_LEN];
+} se05x_verify_se_key_t;
+
+/* Peer public key imported into a transient SE object */
+typedef struct {
+    sss_object_t obj;
+    uint8_t point[SE05X_VERIFY_POINT_LEN];
+    uint32_t last_use;
+    uint8_t in_use;
+} se05x_verify_cache_entry_t;
+
+static se05x_verify_route_t verify_route = SE05X_VERIFY_ROUTE_AUTO;
+static se05x_verify_se_key_t se_keys[SE05X_VERIFY_MAX_SE_KEYS];
+static size_t se_key_count;
+static se05x_verify_cache_entry_t peer_cache[SE05X_VERIFY_CACHE_SIZE];
+static uint32_t cache_clock;
+static se05x_verify_stats_t verify_stats;
+
+/**
+ * @brief Select the verification routing policy
+ * @param route New routing policy
+ */
+void se05x_verify_set_route(se05x_verify_route_t route)
+{
+    verify_route = route;
+}
+
+/**
+ * @brief Register an SE-resident key so verifications against its public
+ *        point stay on the SE05x
+ * @param key Key object already allocated in the SE05x key store
+ * @retval 0 if successful, non-zero otherwise
+ */
+int se05x_verify_register_key(sss_object_t *key)
+{
+    sss_status_t status;
+    uint8_t der[128];
+    size_t der_len = sizeof(der);
+    size_t bit_len = 0;
+    uint16_t index = 0;
+    size_t point_len = 0;
+
+    if (se_key_count >= SE05X_VERIFY_MAX_SE_KEYS) {
+        printf("ERROR: No free slot to register verify key 0x%08X\n", key->keyId);
+        return -1;
+    }
+
+    /* Reading a key pair returns its public part as SubjectPublicKeyInfo */
+    status = sss_key_store_get_key(key->keyStore, key, der, &der_len, &bit_len);
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: Failed to read public key 0x%08X (status = 0x%X)\n", key->keyId, status);
+        return -1;
+    }
+
+    status = sss_util_pkcs8_asn1_get_ec_public_key_index(der, der_len, &index, &point_len);
+    if (status != kStatus_SSS_Success || point_len != SE05X_VERIFY_POINT_LEN) {
+        printf("ERROR: Unsupported public key format for 0x%08X\n", key->keyId);
+        return -1;
+    }
+
+    se_keys[se_key_count].key = key;
+    memcpy(se_keys[se_key_count].point, &der[index], point_len);
+    se_key_count++;
+    return 0;
+}
+
+/**
+ * @brief Drop all cached peer keys and erase their transient SE objects
+ */
+void se05x_verify_cache_flush(void)
+{
+    size_t i;
+
+    for (i = 0; i < SE05X_VERIFY_CACHE_SIZE; i++) {
+        if (peer_cache[i].in_use) {
+            sss_key_store_erase_key(&g_key_store, &peer_cache[i].obj);
+            sss_key_object_free(&peer_cache[i].obj);
+        }
+    }
+    memset(peer_cache, 0, sizeof(peer_cache));
+    cache_clock = 0;
+}
+
+/**
+ * @brief Get verification counters
+ * @param stats Filled with the current counters
+ */
+void se05x_verify_get_stats(se05x_verify_stats_t *stats)
+{
+    *stats = verify_stats;
+}
+
+/**
+ * @brief Reset verification counters
+ */
+void se05x_verify_reset_stats(void)
+{
+    memset(&verify_stats, 0, sizeof(verify_stats));
+}
+
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+/* Every deferred link of the longest chain must fit in one batch */
+#if SSS_MBEDTLS_VERIFY_BATCH_MAX < MBEDTLS_X509_MAX_VERIFY_CHAIN_SIZE
+#error "SSS_MBEDTLS_VERIFY_BATCH_MAX must cover MBEDTLS_X509_MAX_VERIFY_CHAIN_SIZE"
+#endif
+
+/**
+ * @brief Certificate chain batch eligibility callback
+ * @param p_ctx Unused
+ * @param pk Signer key
+ * @param sig_pk Signature algorithm
+ * @param md_alg Hash algorithm
+ * @retval 0 for ECDSA P-256 signatures over SHA-2, non-zero otherwise
+ */
+int se05x_verify_chain_batch_check(void *p_ctx, const mbedtls_pk_context *pk,
+                                   mbedtls_pk_sigalg_t sig_pk, mbedtls_md_type_t md_alg)
+{
+    (void) p_ctx;
+
+    if (sig_pk != MBEDTLS_PK_SIGALG_ECDSA || !mbedtls_pk_can_do(pk, MBEDTLS_PK_ECDSA) ||
+        mbedtls_pk_get_bitlen(pk) != 256) {
+        return -1;
+    }
+
+    switch (md_alg) {
+    case MBEDTLS_MD_SHA256:
+    case MBEDTLS_MD_SHA384:
+    case MBEDTLS_MD_SHA512:
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief Certificate chain batch verification callback
+ * @param p_ctx Unused
+ * @param items Signatures of the chain, leaf first
+ * @param count Number of signatures
+ * @retval 0 if all signatures are valid, non-zero otherwise
+ */
+int se05x_verify_chain_batch(void *p_ctx, const mbedtls_x509_crt_sig_item *items, size_t count)
+{
+    sss_mbedtls_object_t keys[SSS_MBEDTLS_VERIFY_BATCH_MAX];
+    sss_mbedtls_asymmetric_t contexts[SSS_MBEDTLS_VERIFY_BATCH_MAX];
+    sss_mbedtls_verify_item_t batch[SSS_MBEDTLS_VERIFY_BATCH_MAX];
+    sss_status_t status;
+    uint32_t start = board_timing_cycles();
+    size_t i;
+
+    (void) p_ctx;
+
+    if (count > SSS_MBEDTLS_VERIFY_BATCH_MAX) {
+        return -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        sss_algorithm_t algorithm;
+
+        /* se05x_verify_chain_batch_check() let only these through */
+        switch (items[i].md_alg) {
+        case MBEDTLS_MD_SHA256: algorithm = kAlgorithm_SSS_ECDSA_SHA256; break;
+        case MBEDTLS_MD_SHA384: algorithm = kAlgorithm_SSS_ECDSA_SHA384; break;
+        case MBEDTLS_MD_SHA512: algorithm = kAlgorithm_SSS_ECDSA_SHA512; break;
+        default:
+            return -1;
+        }
+
+        /* Wrap the certificate key so the SSS mbedTLS backend can use it */
+        memset(&keys[i], 0, sizeof(keys[i]));
+        keys[i].objectType = kSSS_KeyPart_Public;
+        keys[i].cipherType = kSSS_CipherType_EC_NIST_P;
+        keys[i].accessRights = kAccessPermission_SSS_Use;
+        keys[i].contents = items[i].pk;
+
+        contexts[i].session = NULL;
+        contexts[i].keyObject = &keys[i];
+        contexts[i].algorithm = algorithm;
+        contexts[i].mode = kMode_SSS_Verify;
+
+        batch[i].context = &contexts[i];
+        batch[i].digest = items[i].hash;
+        batch[i].digestLen = items[i].hash_len;
+        batch[i].signature = items[i].sig;
+        batch[i].signatureLen = items[i].sig_len;
+    }
+
+    status = sss_mbedtls_asymmetric_verify_digest_batch(batch, count);
+
+    verify_stats.batch_count++;
+    verify_stats.batch_signatures += count;
+    verify_stats.batch_cycles += board_timing_cycles() - start;
+
+    return (status == kStatus_SSS_Success) ? 0 : -1;
+}
+#endif /* MBEDTLS_X509_CRT_BATCH_VERIFY */
+
+#if defined(MBEDTLS_ECDSA_VERIFY_ALT)
+
+/* Original software verify, renamed by the NXP mbedTLS patch when the ALT is enabled */
+int mbedtls_ecdsa_verify_o(mbedtls_ecp_group *grp,
+                           const unsigned char *buf, size_t blen,
+                           const mbedtls_ecp_point *Q,
+                           const mbedtls_mpi *r, const mbedtls_mpi *s);
+
+/**
+ * @brief Find a registered SE-resident key by public point
+ * @param point Uncompressed public point
+ * @retval Key object, or NULL if the key is not held by the SE05x
+ */
+static sss_object_t *se05x_verify_find_se_key(const uint8_t *point)
+{
+    size_t i;
+
+    for (i = 0; i < se_key_count; i++) {
+        if (memcmp(se_keys[i].point, point, SE05X_VERIFY_POINT_LEN) == 0) {
+            return se_keys[i].key;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get a transient SE object for a peer key, importing it on a miss
+ * @param point Uncompressed public point
+ * @retval Key object, or NULL if the key could not be imported
+ */
+static sss_object_t *se05x_verify_cache_get(const uint8_t *point)
+{
+    sss_status_t status;
+    se05x_verify_cache_entry_t *victim = &peer_cache[0];
+    uint8_t spki[sizeof(p256_spki_header) + SE05X_VERIFY_POINT_LEN];
+    uint32_t key_id;
+    size_t i;
+
+    for (i = 0; i < SE05X_VERIFY_CACHE_SIZE; i++) {
+        se05x_verify_cache_entry_t *entry = &peer_cache[i];
+
+        if (entry->in_use && memcmp(entry->point, point, SE05X_VERIFY_POINT_LEN) == 0) {
+            entry->last_use = ++cache_clock;
+            verify_stats.cache_hits++;
+            return &entry->obj;
+        }
+
+        /* Prefer a free entry, otherwise the least recently used one */
+        if (!entry->in_use) {
+            if (victim->in_use) {
+                victim = entry;
+            }
+        } else if (victim->in_use && entry->last_use < victim->last_use) {
+            victim = entry;
+        }
+    }
+
+    verify_stats.cache_misses++;
+
+    if (victim->in_use) {
+        sss_key_store_erase_key(&g_key_store, &victim->obj);
+        sss_key_object_free(&victim->obj);
+        victim->in_use = 0;
+    }
+
+    key_id = SE05X_VERIFY_CACHE_KEY_ID + (uint32_t)(victim - peer_cache);
+    memcpy(spki, p256_spki_header, sizeof(p256_spki_header));
+    memcpy(spki + sizeof(p256_spki_header), point, SE05X_VERIFY_POINT_LEN);
+
+    status = sss_key_object_init(&victim->obj, &g_key_store);
+    if (status != kStatus_SSS_Success) {
+        return NULL;
+    }
+
+    status = sss_key_object_allocate_handle(&victim->obj,
+                                          key_id,
+                                          kSSS_KeyPart_Public,
+                                          kSSS_CipherType_EC_NIST_P,
+                                          sizeof(spki),
+                                          kKeyObject_Mode_Transient);
+    if (status == kStatus_SSS_Success) {
+        status = sss_key_store_set_key(&g_key_store, &victim->obj, spki, sizeof(spki), 256, NULL, 0);
+    }
+    if (status != kStatus_SSS_Success) {
+        printf("ERROR: Failed to import peer key (status = 0x%X)\n", status);
+        sss_key_object_free(&victim->obj);
+        return NULL;
+    }
+
+    memcpy(victim->point, point, SE05X_VERIFY_POINT_LEN);
+    victim->last_use = ++cache_clock;
+    victim->in_use = 1;
+    return &victim->obj;
+}
+
+/**
+ * @brief Verify an ECDSA signature with a key object held by the SE05x
+ * @retval 0 if the signature is valid, an mbedTLS error code otherwise
+ */
+static int se05x_verify_on_se(sss_object_t *key,
+                              const unsigned char *buf, size_t blen,
+                              const mbedtls_mpi *r, const mbedtls_mpi *s)
+{
+    int ret;
+    sss_status_t status;
+    sss_asymmetric_t ctx;
+    sss_algorithm_t algorithm;
+    uint8_t digest[64];
+    uint8_t sig[MBEDTLS_ECDSA_MAX_LEN];
+    unsigned char *p = sig + sizeof(sig);
+    size_t len = 0;
+
+    switch (blen) {
+    case 20: algorithm = kAlgorithm_SSS_SHA1; break;
+    case 28: algorithm = kAlgorithm_SSS_SHA224; break;
+    case 32: algorithm = kAlgorithm_SSS_SHA256; break;
+    case 48: algorithm = kAlgorithm_SSS_SHA384; break;
+    case 64: algorithm = kAlgorithm_SSS_SHA512; break;
+    default:
+        return MBEDTLS_ERR_ECP_BAD_INPUT_DATA;
+    }
+
+    /* The SE05x expects the DER form mbedTLS uses on the wire */
+    MBEDTLS_ASN1_CHK_ADD(len, mbedtls_asn1_write_mpi(&p, sig, s));
+    MBEDTLS_ASN1_CHK_ADD(len, mbedtls_asn1_write_mpi(&p, sig, r));
+    MBEDTLS_ASN1_CHK_ADD(len, mbedtls_asn1_write_len(&p, sig, len));
+    MBEDTLS_ASN1_CHK_ADD(len, mbedtls_asn1_write_tag(&p, sig,
+                                                     MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE));
+
+    memcpy(digest, buf, blen);
+
+    status = sss_asymmetric_context_init(&ctx, &g_session, key, algorithm, kMode_SSS_Verify);
+    if (status != kStatus_SSS_Success) {
+        return MBEDTLS_ERR_ECP_HW_ACCEL_FAILED;
+    }
+
+    status = sss_asymmetric_verify_digest(&ctx, digest, blen, p, len);
+    sss_asymmetric_context_free(&ctx);
+
+    return (status == kStatus_SSS_Success) ? 0 : MBEDTLS_ERR_ECP_VERIFY_FAILED;
+}
+
+/**
+ * @brief ECDSA verify ALT entry point
+ *
+ * SE-resident keys are always verified by the SE05x. Other keys are verified
+ * on the host unless the route is SE05X_VERIFY_ROUTE_SE, in which case they
+ * are imported once into a transient object and kept in the peer key cache.
+ */
+int mbedtls_ecdsa_verify(mbedtls_ecp_group *grp,
+                         const unsigned char *buf, size_t blen,
+                         const mbedtls_ecp_point *Q,
+                         const mbedtls_mpi *r, const mbedtls_mpi *s)
+{
+    int ret;
+    int comb_attached;
+    uint8_t point[SE05X_VERIFY_POINT_LEN];
+    size_t point_len = 0;
+    sss_object_t *key = NULL;
+    uint32_t start = board_timing_cycles();
+
+    if (verify_route != SE05X_VERIFY_ROUTE_HOST && grp->id == MBEDTLS_ECP_DP_SECP256R1) {
+        ret = mbedtls_ecp_point_write_binary(grp, Q, MBEDTLS_ECP_PF_UNCOMPRESSED,
+                                             &point_len, point, sizeof(point));
+        if (ret == 0) {
+            key = se05x_verify_find_se_key(point);
+            if (key == NULL && verify_route == SE05X_VERIFY_ROUTE_SE) {
+                key = se05x_verify_cache_get(point);
+            }
+        }
+    }
+
+    if (key != NULL) {
+        ret = se05x_verify_on_se(key, buf, blen, r, s);
+        verify_stats.se_count++;
+        verify_stats.se_cycles += board_timing_cycles() - start;
+        return ret;
+    }
+
+    comb_attached = ecp_p256_comb_attach(grp);
+    ret = mbedtls_ecdsa_verify_o(grp, buf, blen, Q, r, s);
+    if (comb_attached) {
+        ecp_p256_comb_detach(grp);
+    }
+    verify_stats.host_count++;
+    verify_stats.host_cycles += board_timing_cycles() - start;
+    return ret;
+}
+
+#endif /* MBEDTLS_ECDSA_VERIFY_ALT */
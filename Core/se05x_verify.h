@@ -0,0 +1,118 @@
+/**
+ * @file se05x_verify.h
+ * @brief ECDSA verification routing between host mbedTLS and SE05x
+ */
+
+#ifndef SE05X_VERIFY_H
+#define SE05X_VERIFY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "fsl_sss_api.h"
+#include "mbedtls/x509_crt.h"
+
+/* Maximum number of SE-resident keys whose public point is recognised */
+#ifndef SE05X_VERIFY_MAX_SE_KEYS
+#define SE05X_VERIFY_MAX_SE_KEYS 4
+#endif
+
+/* Number of peer public keys kept imported in transient SE objects */
+#ifndef SE05X_VERIFY_CACHE_SIZE
+#define SE05X_VERIFY_CACHE_SIZE 4
+#endif
+
+/* First key ID used for transient peer key objects */
+#ifndef SE05X_VERIFY_CACHE_KEY_ID
+#define SE05X_VERIFY_CACHE_KEY_ID 0x7D000100
+#endif
+
+/**
+ * @brief Where an ECDSA verification is executed
+ */
+typedef enum {
+    /* Host for public-only keys, SE05x for SE-resident keys */
+    SE05X_VERIFY_ROUTE_AUTO = 0,
+    /* Always verify on the host */
+    SE05X_VERIFY_ROUTE_HOST,
+    /* Always verify on the SE05x, importing peer keys as needed */
+    SE05X_VERIFY_ROUTE_SE,
+} se05x_verify_route_t;
+
+/**
+ * @brief Verification counters, cycle totals are from board_timing_cycles()
+ */
+typedef struct {
+    uint32_t host_count;
+    uint32_t host_cycles;
+    uint32_t se_count;
+    uint32_t se_cycles;
+    uint32_t cache_hits;
+    uint32_t cache_misses;
+    uint32_t batch_count;
+    uint32_t batch_signatures;
+    uint32_t batch_cycles;
+} se05x_verify_stats_t;
+
+/**
+ * @brief Select the verification routing policy
+ * @param route New routing policy
+ */
+void se05x_verify_set_route(se05x_verify_route_t route);
+
+/**
+ * @brief Register an SE-resident key so verifications against its public
+ *        point stay on the SE05x
+ * @param key Key object already allocated in the SE05x key store
+ * @retval 0 if successful, non-zero otherwise
+ */
+int se05x_verify_register_key(sss_object_t *key);
+
+/**
+ * @brief Drop all cached peer keys and erase their transient SE objects
+ */
+void se05x_verify_cache_flush(void);
+
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+/**
+ * @brief Certificate chain batch eligibility callback
+ *
+ * Register with mbedtls_x509_crt_set_batch_verify_cb(). Only ECDSA P-256
+ * signatures over SHA-256/384/512 are left to the batch, every other link
+ * (RSA for instance) is verified while the chain is built.
+ *
+ * @param p_ctx Unused
+ * @param pk Signer key
+ * @param sig_pk Signature algorithm
+ * @param md_alg Hash algorithm
+ * @retval 0 if the signature can be batched, non-zero otherwise
+ */
+int se05x_verify_chain_batch_check(void *p_ctx, const mbedtls_pk_context *pk,
+                                   mbedtls_pk_sigalg_t sig_pk, mbedtls_md_type_t md_alg);
+
+/**
+ * @brief Certificate chain batch verification callback
+ *
+ * Register with mbedtls_x509_crt_set_batch_verify_cb(). The signatures that
+ * se05x_verify_chain_batch_check() accepted are verified on the host in one
+ * call to sss_mbedtls_asymmetric_verify_digest_batch().
+ *
+ * @param p_ctx Unused
+ * @param items Signatures of the chain, leaf first
+ * @param count Number of signatures
+ * @retval 0 if all signatures are valid, non-zero otherwise
+ */
+int se05x_verify_chain_batch(void *p_ctx, const mbedtls_x509_crt_sig_item *items, size_t count);
+#endif
+
+/**
+ * @brief Get verification counters
+ * @param stats Filled with the current counters
+ */
+void se05x_verify_get_stats(se05x_verify_stats_t *stats);
+
+/**
+ * @brief Reset verification counters
+ */
+void se05x_verify_reset_stats(void);
+
+#endif /* SE05X_VERIFY_H */
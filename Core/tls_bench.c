@@ -0,0 +1,1430 @@
+/**
+ * @file tls_bench.c
+ * @brief On-target micro benchmarks for the TLS client
+ */
+
+#include "tls_bench.h"
+#include "se05x_verify.h"
+#include "board_timing.h"
+#include "ecp_p256_comb.h"
+#include "se05x_ticket.h"
+#include "crl_index.h"
+#include "fw_verify.h"
+#include "se05x_csr.h"
+#include "se05x_init.h"
+#include "mbedtls/ecp.h"
+#include "mbedtls/error.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/psa_util.h"
+#include "mbedtls/x509_crl.h"
+#include "psa/crypto.h"
+#if defined(MBEDTLS_SSL_CACHE_C)
+#include "mbedtls/ssl_cache.h"
+#endif
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C)
+#include "mbedtls/memory_buffer_alloc.h"
+#endif
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Verify a chain a number of times
+ * @param chain Parsed chain, leaf first
+ * @param trust_ca Trusted CA list
+ * @param iterations Number of verifications
+ * @param cycles Total elapsed cycles
+ * @retval 0 if all verifications passed, non-zero otherwise
+ */
+static int tls_bench_verify_loop(mbedtls_x509_crt *chain, mbedtls_x509_crt *trust_ca,
+                                 uint32_t iterations, uint32_t *cycles)
+{
+    int ret;
+    uint32_t flags;
+    uint32_t i;
+    uint32_t start = board_timing_cycles();
+
+    for (i = 0; i < iterations; i++) {
+        ret = mbedtls_x509_crt_verify(chain, trust_ca, NULL, NULL, &flags, NULL, NULL);
+        if (ret != 0) {
+            printf("ERROR: mbedtls_x509_crt_verify returned -0x%04X (flags = 0x%08lX)\n",
+                   -ret, (unsigned long)flags);
+            return -1;
+        }
+    }
+
+    *cycles = board_timing_cycles() - start;
+    return 0;
+}
+
+/**
+ * @brief Time mbedtls_x509_crt_verify() on a certificate chain, with and
+ *        without the batch verification callback
+ * @param chain Parsed chain, leaf first (typically 2 to 4 certificates)
+ * @param trust_ca Trusted CA list
+ * @param iterations Number of verifications per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_chain_verify(mbedtls_x509_crt *chain, mbedtls_x509_crt *trust_ca,
+                           uint32_t iterations)
+{
+    uint32_t single_cycles;
+    uint32_t depth = 0;
+    const mbedtls_x509_crt *crt;
+
+    if (iterations == 0) {
+        return -1;
+    }
+
+    for (crt = chain; crt != NULL && crt->raw.len != 0; crt = crt->next) {
+        depth++;
+    }
+
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+    mbedtls_x509_crt_set_batch_verify_cb(NULL, NULL, NULL);
+#endif
+    if (tls_bench_verify_loop(chain, trust_ca, iterations, &single_cycles) != 0) {
+        return -1;
+    }
+    printf("Chain verify (depth %lu): one-by-one %lu us\n",
+           (unsigned long)depth,
+           (unsigned long)board_timing_cycles_to_us(single_cycles / iterations));
+
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+    {
+        uint32_t batch_cycles;
+        se05x_verify_stats_t stats;
+        int ret;
+
+        se05x_verify_reset_stats();
+        mbedtls_x509_crt_set_batch_verify_cb(se05x_verify_chain_batch_check,
+                                             se05x_verify_chain_batch, NULL);
+        ret = tls_bench_verify_loop(chain, trust_ca, iterations, &batch_cycles);
+        mbedtls_x509_crt_set_batch_verify_cb(NULL, NULL, NULL);
+        if (ret != 0) {
+            return -1;
+        }
+
+        /* A chain that was not batched fell back to the one-by-one path */
+        se05x_verify_get_stats(&stats);
+        printf("Chain verify (depth %lu): batch %lu us, %lu/%lu batched\n",
+               (unsigned long)depth,
+               (unsigned long)board_timing_cycles_to_us(batch_cycles / iterations),
+               (unsigned long)stats.batch_count,
+               (unsigned long)iterations);
+    }
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief Generate key pairs on a freshly loaded group
+ * @param use_rom Attach the ROM comb table before generating
+ * @param f_rng RNG function
+ * @param p_rng RNG context
+ * @param iterations Number of key generations
+ * @param cycles Total elapsed cycles
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int tls_bench_keygen_loop(int use_rom,
+                                 int (*f_rng)(void *, unsigned char *, size_t), void *p_rng,
+                                 uint32_t iterations, uint32_t *cycles)
+{
+    int ret = 0;
+    uint32_t i;
+    uint32_t start = board_timing_cycles();
+    mbedtls_ecp_group grp;
+    mbedtls_mpi d;
+    mbedtls_ecp_point Q;
+
+    for (i = 0; i < iterations && ret == 0; i++) {
+        mbedtls_ecp_group_init(&grp);
+        mbedtls_mpi_init(&d);
+        mbedtls_ecp_point_init(&Q);
+
+        ret = mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_SECP256R1);
+        if (ret == 0) {
+            if (use_rom) {
+                ecp_p256_comb_attach(&grp);
+            }
+            ret = mbedtls_ecp_gen_keypair(&grp, &d, &Q, f_rng, p_rng);
+            ecp_p256_comb_detach(&grp);
+        }
+
+        mbedtls_ecp_point_free(&Q);
+        mbedtls_mpi_free(&d);
+        mbedtls_ecp_group_free(&grp);
+    }
+
+    if (ret != 0) {
+        printf("ERROR: ECDHE key generation returned -0x%04X\n", -ret);
+        return -1;
+    }
+
+    *cycles = board_timing_cycles() - start;
+    return 0;
+}
+
+/**
+ * @brief Time secp256r1 key generation on a freshly loaded group, as in
+ *        host-side ECDHE and verify, and report peak heap usage,
+ *        with the comb table built in RAM and with the ROM comb table
+ * @param f_rng RNG function
+ * @param p_rng RNG context
+ * @param iterations Number of key generations per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_ecdhe_keygen(int (*f_rng)(void *, unsigned char *, size_t), void *p_rng,
+                           uint32_t iterations)
+{
+    static const char *const mode_name[] = { "RAM table", "ROM table" };
+    uint32_t cycles;
+    int use_rom;
+
+    if (iterations == 0) {
+        return -1;
+    }
+
+    for (use_rom = 0; use_rom <= 1; use_rom++) {
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+        size_t max_used = 0;
+        size_t max_blocks = 0;
+
+        mbedtls_memory_buffer_alloc_max_reset();
+#endif
+        if (tls_bench_keygen_loop(use_rom, f_rng, p_rng, iterations, &cycles) != 0) {
+            return -1;
+        }
+        printf("ECDHE keygen (%s): %lu us\n", mode_name[use_rom],
+               (unsigned long)board_timing_cycles_to_us(cycles / iterations));
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+        mbedtls_memory_buffer_alloc_max_get(&max_used, &max_blocks);
+        printf("ECDHE keygen (%s): peak heap %lu bytes in %lu blocks\n", mode_name[use_rom],
+               (unsigned long)max_used, (unsigned long)max_blocks);
+#endif
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Convert a number of operations and their elapsed cycles to a rate
+ * @param ops Number of operations
+ * @param cycles Total elapsed cycles
+ * @retval Operations per second
+ */
+static uint32_t tls_bench_per_second(uint32_t ops, uint32_t cycles)
+{
+    uint32_t us = board_timing_cycles_to_us(cycles);
+
+    if (us == 0) {
+        us = 1;
+    }
+    return (uint32_t)(((uint64_t)ops * 1000000U) / us);
+}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+/**
+ * @brief Build a 32-byte session ID from a number
+ * @param id Output session ID
+ * @param n Entry number
+ */
+static void tls_bench_session_id(unsigned char id[32], uint32_t n)
+{
+    uint32_t i;
+
+    /* Spread the number over the ID like a random server-chosen ID would be */
+    for (i = 0; i < 32; i++) {
+        n = n * 1664525U + 1013904223U;
+        id[i] = (unsigned char)(n >> 24);
+    }
+}
+
+/**
+ * @brief Look up session IDs a number of times
+ * @param cache Filled cache
+ * @param first First entry number to look up
+ * @param entries Number of distinct entry numbers to cycle through
+ * @param lookups Number of lookups
+ * @param expect_hit Whether the lookups should find a session
+ * @param cycles Total elapsed cycles
+ * @retval 0 if all lookups behaved as expected, non-zero otherwise
+ */
+static int tls_bench_cache_lookup_loop(mbedtls_ssl_cache_context *cache, uint32_t first,
+                                       uint32_t entries, uint32_t lookups,
+                                       int expect_hit, uint32_t *cycles)
+{
+    unsigned char id[32];
+    mbedtls_ssl_session session;
+    uint32_t i;
+    uint32_t start;
+    uint32_t total = 0;
+    int ret;
+
+    for (i = 0; i < lookups; i++) {
+        /* ID generation is kept out of the measurement */
+        tls_bench_session_id(id, first + i % entries);
+        mbedtls_ssl_session_init(&session);
+
+        start = board_timing_cycles();
+        ret = mbedtls_ssl_cache_get(cache, id, sizeof(id), &session);
+        total += board_timing_cycles() - start;
+
+        mbedtls_ssl_session_free(&session);
+        if ((ret == 0) != (expect_hit != 0)) {
+            printf("ERROR: mbedtls_ssl_cache_get returned -0x%04X\n", -ret);
+            return -1;
+        }
+    }
+
+    *cycles = total;
+    return 0;
+}
+
+/**
+ * @brief Measure session cache lookups per second at 16 to 4096 entries
+ * @param session Session stored under every ID, e.g. from mbedtls_ssl_get_session()
+ * @param lookups Number of lookups per cache size, for hits and for misses
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_session_cache(const mbedtls_ssl_session *session, uint32_t lookups)
+{
+#if defined(MBEDTLS_SSL_CACHE_HASH_INDEX)
+    static const char impl[] = "hash index";
+#else
+    static const char impl[] = "linked list";
+#endif
+    static const uint32_t sizes[] = { 16, 64, 256, 1024, 4096 };
+    mbedtls_ssl_cache_context cache;
+    unsigned char id[32];
+    uint32_t hit_cycles;
+    uint32_t miss_cycles;
+    uint32_t n;
+    uint32_t i;
+    size_t s;
+    int ret = 0;
+
+    if (session == NULL || lookups == 0) {
+        return -1;
+    }
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && ret == 0; s++) {
+        n = sizes[s];
+
+        mbedtls_ssl_cache_init(&cache);
+        mbedtls_ssl_cache_set_max_entries(&cache, (int)n);
+
+        for (i = 0; i < n; i++) {
+            tls_bench_session_id(id, i);
+            ret = mbedtls_ssl_cache_set(&cache, id, sizeof(id), session);
+            if (ret != 0) {
+                break;
+            }
+        }
+
+        if (ret == MBEDTLS_ERR_SSL_ALLOC_FAILED) {
+            /* Larger sizes will not fit either */
+            printf("WARNING: session cache of %lu entries does not fit in the heap\n",
+                   (unsigned long)n);
+            mbedtls_ssl_cache_free(&cache);
+            ret = 0;
+            break;
+        }
+
+        if (ret != 0) {
+            printf("ERROR: mbedtls_ssl_cache_set returned -0x%04X\n", -ret);
+        } else if (tls_bench_cache_lookup_loop(&cache, 0, n, lookups, 1, &hit_cycles) != 0 ||
+                   tls_bench_cache_lookup_loop(&cache, n, n, lookups, 0, &miss_cycles) != 0) {
+            ret = -1;
+        } else {
+            printf("Session cache (%s, %lu entries): %lu hits/s, %lu misses/s\n", impl,
+                   (unsigned long)n,
+                   (unsigned long)tls_bench_per_second(lookups, hit_cycles),
+                   (unsigned long)tls_bench_per_second(lookups, miss_cycles));
+        }
+
+        mbedtls_ssl_cache_free(&cache);
+    }
+
+    return ret == 0 ? 0 : -1;
+}
+#endif /* MBEDTLS_SSL_CACHE_C */
+
+/* Large enough for a serialized TLS 1.2 session plus the ticket overhead */
+#define TLS_BENCH_TICKET_LEN 1024
+
+/**
+ * @brief Measure session ticket write and parse throughput with the ticket
+ *        key in the SE05x and with the epoch key cached on the host
+ * @param session Session to put in the tickets, e.g. from mbedtls_ssl_get_session()
+ * @param iterations Number of tickets written and parsed per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_ticket(const mbedtls_ssl_session *session, uint32_t iterations)
+{
+    static const char *const mode_name[] = { "SE05x AES-GCM", "host AES-GCM" };
+    static unsigned char ticket[TLS_BENCH_TICKET_LEN];
+    mbedtls_ssl_session parsed;
+    se05x_ticket_stats_t stats;
+    uint32_t lifetime;
+    uint32_t i;
+    size_t len;
+    int mode;
+    int ret = 0;
+
+    if (session == NULL || iterations == 0) {
+        return -1;
+    }
+
+    for (mode = SE05X_TICKET_MODE_SE; mode <= SE05X_TICKET_MODE_HOST && ret == 0; mode++) {
+        if (se05x_ticket_setup((se05x_ticket_mode_t)mode, 86400) != 0) {
+            return -1;
+        }
+
+        /* Derive the epoch key outside the measurement */
+        ret = se05x_ticket_write(NULL, session, ticket, ticket + sizeof(ticket), &len, &lifetime);
+        se05x_ticket_reset_stats();
+
+        for (i = 0; i < iterations && ret == 0; i++) {
+            ret = se05x_ticket_write(NULL, session, ticket, ticket + sizeof(ticket),
+                                     &len, &lifetime);
+            if (ret == 0) {
+                mbedtls_ssl_session_init(&parsed);
+                ret = se05x_ticket_parse(NULL, &parsed, ticket, len);
+                mbedtls_ssl_session_free(&parsed);
+            }
+        }
+
+        if (ret != 0) {
+            printf("ERROR: Ticket round trip (%s) returned -0x%04X\n", mode_name[mode], -ret);
+        } else {
+            se05x_ticket_get_stats(&stats);
+            printf("Session ticket (%s, %lu bytes): write %lu us, parse %lu us\n",
+                   mode_name[mode], (unsigned long)len,
+                   (unsigned long)board_timing_cycles_to_us(stats.write_cycles / iterations),
+                   (unsigned long)board_timing_cycles_to_us(stats.parse_cycles / iterations));
+        }
+        se05x_ticket_free();
+    }
+
+    return ret == 0 ? 0 : -1;
+}
+
+#if defined(MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK)
+/**
+ * @brief Time chain verification against an indexed trust store and against
+ *        the same CAs as a plain trusted CA list
+ * @param chain Parsed chain, leaf first, whose root is in @p store
+ * @param store Store set up with trust_store_load(), build it with
+ *        TRUST_STORE_FILL to compare store sizes
+ * @param iterations Number of verifications per mode
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note The plain list is skipped when its parsed CAs do not fit in the heap.
+ */
+int tls_bench_trust_store(mbedtls_x509_crt *chain, trust_store_t *store, uint32_t iterations)
+{
+    mbedtls_x509_crt trust_ca;
+    trust_store_stats_t stats;
+    uint32_t list_cycles;
+    uint32_t start;
+    uint32_t flags;
+    uint32_t i;
+    int ret;
+
+    if (chain == NULL || store == NULL || iterations == 0) {
+        return -1;
+    }
+
+    trust_store_reset_stats(store);
+    start = board_timing_cycles();
+    for (i = 0; i < iterations; i++) {
+        ret = mbedtls_x509_crt_verify_with_ca_cb(chain, trust_store_ca_cb, store,
+                                                 &mbedtls_x509_crt_profile_default, NULL,
+                                                 &flags, NULL, NULL);
+        if (ret != 0) {
+            printf("ERROR: mbedtls_x509_crt_verify_with_ca_cb returned -0x%04X (flags = 0x%08lX)\n",
+                   -ret, (unsigned long)flags);
+            return -1;
+        }
+    }
+    trust_store_get_stats(store, &stats);
+    printf("Trust store (%lu CAs): indexed %lu us, %lu candidates per lookup\n",
+           (unsigned long)store->count,
+           (unsigned long)board_timing_cycles_to_us((board_timing_cycles() - start) / iterations),
+           (unsigned long)(stats.lookups != 0 ? stats.candidates / stats.lookups : 0));
+
+    /* The whole store parsed into RAM, as mbedtls_ssl_conf_ca_chain() needs it */
+    mbedtls_x509_crt_init(&trust_ca);
+    ret = trust_store_parse_all(store, &trust_ca);
+    if (ret == MBEDTLS_ERR_X509_ALLOC_FAILED) {
+        printf("WARNING: %lu parsed CAs do not fit in the heap, skipping the plain list\n",
+               (unsigned long)store->count);
+        mbedtls_x509_crt_free(&trust_ca);
+        return 0;
+    }
+    if (ret != 0) {
+        printf("ERROR: trust_store_parse_all returned -0x%04X\n", -ret);
+        mbedtls_x509_crt_free(&trust_ca);
+        return -1;
+    }
+
+    ret = tls_bench_verify_loop(chain, &trust_ca, iterations, &list_cycles);
+    mbedtls_x509_crt_free(&trust_ca);
+    if (ret != 0) {
+        return -1;
+    }
+    printf("Trust store (%lu CAs): plain list %lu us\n",
+           (unsigned long)store->count,
+           (unsigned long)board_timing_cycles_to_us(list_cycles / iterations));
+
+    return 0;
+}
+#endif /* MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK */
+
+/**
+ * @brief Measure boot-time CA loading: parsing every CA with
+ *        mbedtls_x509_crt_parse_der() against loading the pre-parsed store
+ *        and taking a view of every CA
+ * @param blob Blob from scripts/gen_trust_store.py
+ * @param len Length of @p blob
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note Heap figures need MBEDTLS_MEMORY_DEBUG.
+ */
+int tls_bench_trust_store_boot(const uint8_t *blob, size_t len)
+{
+    trust_store_t store;
+    trust_store_view_t view;
+    mbedtls_x509_crt chain;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t i;
+    int ret = 0;
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+    size_t max_used = 0;
+    size_t max_blocks = 0;
+#endif
+
+    /* Pre-parsed: bounds checks only, every view points into flash */
+    start = board_timing_cycles();
+    if (trust_store_load(&store, blob, len) != 0) {
+        return -1;
+    }
+    for (i = 0; i < store.count; i++) {
+        trust_store_view(&store, i, &view);
+    }
+    cycles = board_timing_cycles() - start;
+    printf("CA load (%lu CAs): pre-parsed %lu us, no heap\n",
+           (unsigned long)store.count, (unsigned long)board_timing_cycles_to_us(cycles));
+
+    /* Classic: DER parsed and copied to the heap, as a CA bundle is at boot */
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+    mbedtls_memory_buffer_alloc_max_reset();
+#endif
+    mbedtls_x509_crt_init(&chain);
+    start = board_timing_cycles();
+    for (i = 0; i < store.count && ret == 0; i++) {
+        trust_store_view(&store, i, &view);
+        ret = mbedtls_x509_crt_parse_der(&chain, view.raw.p, view.raw.len);
+    }
+    cycles = board_timing_cycles() - start;
+    mbedtls_x509_crt_free(&chain);
+
+    if (ret == MBEDTLS_ERR_X509_ALLOC_FAILED) {
+        printf("WARNING: Heap exhausted after %lu of %lu CAs\n",
+               (unsigned long)(i - 1), (unsigned long)store.count);
+    } else if (ret != 0) {
+        printf("ERROR: mbedtls_x509_crt_parse_der returned -0x%04X\n", -ret);
+        return -1;
+    }
+    printf("CA load (%lu CAs): mbedtls_x509_crt_parse_der %lu us\n",
+           (unsigned long)(ret == 0 ? i : i - 1),
+           (unsigned long)board_timing_cycles_to_us(cycles));
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+    mbedtls_memory_buffer_alloc_max_get(&max_used, &max_blocks);
+    printf("CA load (%lu CAs): mbedtls_x509_crt_parse_der peak heap %lu bytes in %lu blocks\n",
+           (unsigned long)(ret == 0 ? i : i - 1),
+           (unsigned long)max_used, (unsigned long)max_blocks);
+#endif
+
+    return 0;
+}
+
+#if defined(MBEDTLS_SSL_ZERO_COPY) && defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(MBEDTLS_SSL_SRV_C)
+/* Room for one full record with its expansion, or a whole PSK handshake flight */
+#define TLS_BENCH_PIPE_LEN (MBEDTLS_SSL_OUT_CONTENT_LEN + 2048)
+#define TLS_BENCH_HANDSHAKE_STEPS 64
+
+/* One direction of the in-memory connection */
+typedef struct {
+    unsigned char buf[TLS_BENCH_PIPE_LEN];
+    size_t head;
+    size_t tail;
+} tls_bench_pipe_t;
+
+/* One end of the in-memory connection */
+typedef struct {
+    tls_bench_pipe_t *rx;
+    tls_bench_pipe_t *tx;
+} tls_bench_end_t;
+
+static tls_bench_pipe_t tls_bench_to_server;
+static tls_bench_pipe_t tls_bench_to_client;
+static unsigned char tls_bench_app_buf[MBEDTLS_SSL_OUT_CONTENT_LEN];
+
+/**
+ * @brief Send callback writing into the peer's pipe
+ */
+static int tls_bench_pipe_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    tls_bench_pipe_t *pipe = ((tls_bench_end_t *)ctx)->tx;
+    size_t room = sizeof(pipe->buf) - pipe->tail;
+
+    if (room == 0) {
+        return MBEDTLS_ERR_SSL_WANT_WRITE;
+    }
+    if (len > room) {
+        len = room;
+    }
+    memcpy(pipe->buf + pipe->tail, buf, len);
+    pipe->tail += len;
+    return (int)len;
+}
+
+/**
+ * @brief Receive callback reading from our own pipe
+ */
+static int tls_bench_pipe_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    tls_bench_pipe_t *pipe = ((tls_bench_end_t *)ctx)->rx;
+    size_t avail = pipe->tail - pipe->head;
+
+    if (avail == 0) {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+    if (len > avail) {
+        len = avail;
+    }
+    memcpy(buf, pipe->buf + pipe->head, len);
+    pipe->head += len;
+    if (pipe->head == pipe->tail) {
+        pipe->head = 0;
+        pipe->tail = 0;
+    }
+    return (int)len;
+}
+
+/**
+ * @brief Fill application data with a pattern that changes per record
+ */
+static void tls_bench_fill(unsigned char *buf, size_t len, uint32_t record)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        buf[i] = (unsigned char)(record + i);
+    }
+}
+
+/**
+ * @brief Sum application data so that the receiver touches every byte
+ */
+static uint32_t tls_bench_sum(const unsigned char *buf, size_t len)
+{
+    uint32_t sum = 0;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        sum += buf[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Send and receive one record of application data
+ * @param client Sending end
+ * @param server Receiving end
+ * @param zero_copy Use the view API instead of mbedtls_ssl_write()/mbedtls_ssl_read()
+ * @param record Record number, seeds the payload
+ * @param len Payload length
+ * @param write_cycles Incremented by the cycles spent producing and sending
+ * @param read_cycles Incremented by the cycles spent receiving and consuming
+ * @param sum Incremented by the sum of the received bytes
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+static int tls_bench_record(mbedtls_ssl_context *client, mbedtls_ssl_context *server,
+                            int zero_copy, uint32_t record, size_t len,
+                            uint32_t *write_cycles, uint32_t *read_cycles, uint32_t *sum)
+{
+    const unsigned char *in;
+    unsigned char *out;
+    size_t got = 0;
+    uint32_t start;
+    int ret;
+
+    start = board_timing_cycles();
+    if (zero_copy) {
+        ret = mbedtls_ssl_write_view(client, &out);
+        if (ret >= 0 && (size_t)ret < len) {
+            ret = MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+        }
+        if (ret >= 0) {
+            tls_bench_fill(out, len, record);
+            ret = mbedtls_ssl_write_commit(client, len);
+        }
+    } else {
+        tls_bench_fill(tls_bench_app_buf, len, record);
+        ret = mbedtls_ssl_write(client, tls_bench_app_buf, len);
+    }
+    *write_cycles += board_timing_cycles() - start;
+    if (ret < 0) {
+        return ret;
+    }
+
+    start = board_timing_cycles();
+    while (got < len) {
+        if (zero_copy) {
+            ret = mbedtls_ssl_read_view(server, &in);
+        } else {
+            ret = mbedtls_ssl_read(server, tls_bench_app_buf, sizeof(tls_bench_app_buf));
+            in = tls_bench_app_buf;
+        }
+        if (ret == 0) {
+            ret = MBEDTLS_ERR_SSL_CONN_EOF;
+        }
+        if (ret < 0) {
+            break;
+        }
+        *sum += tls_bench_sum(in, (size_t)ret);
+        got += (size_t)ret;
+        if (zero_copy && (ret = mbedtls_ssl_read_consume(server, (size_t)ret)) != 0) {
+            break;
+        }
+        ret = 0;
+    }
+    *read_cycles += board_timing_cycles() - start;
+
+    return ret;
+}
+
+/**
+ * @brief Measure application data throughput with mbedtls_ssl_write() /
+ *        mbedtls_ssl_read() and with the zero-copy view API
+ * @param records Number of records sent per mode
+ * @param len Payload length of every record, at most MBEDTLS_SSL_OUT_CONTENT_LEN
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_record_io(uint32_t records, size_t len)
+{
+    static const char *const mode_name[] = { "copy", "zero-copy" };
+    static const unsigned char psk[16] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+    };
+    static const unsigned char psk_id[] = "tls_bench";
+    static const int ciphersuites[] = { MBEDTLS_TLS_PSK_WITH_AES_128_GCM_SHA256, 0 };
+    static mbedtls_ssl_config client_conf;
+    static mbedtls_ssl_config server_conf;
+    static mbedtls_ssl_context client;
+    static mbedtls_ssl_context server;
+    tls_bench_end_t client_end = { &tls_bench_to_client, &tls_bench_to_server };
+    tls_bench_end_t server_end = { &tls_bench_to_server, &tls_bench_to_client };
+    uint32_t write_cycles;
+    uint32_t read_cycles;
+    uint32_t sum;
+    uint32_t kbytes;
+    uint32_t i;
+    int client_ret;
+    int server_ret;
+    int mode;
+    int ret = 0;
+
+    if (records == 0 || len == 0 || len > sizeof(tls_bench_app_buf)) {
+        return -1;
+    }
+
+    for (mode = 0; mode <= 1 && ret == 0; mode++) {
+        memset(&tls_bench_to_server, 0, sizeof(tls_bench_to_server));
+        memset(&tls_bench_to_client, 0, sizeof(tls_bench_to_client));
+        mbedtls_ssl_config_init(&client_conf);
+        mbedtls_ssl_config_init(&server_conf);
+        mbedtls_ssl_init(&client);
+        mbedtls_ssl_init(&server);
+
+        ret = mbedtls_ssl_config_defaults(&client_conf, MBEDTLS_SSL_IS_CLIENT,
+                                          MBEDTLS_SSL_TRANSPORT_STREAM,
+                                          MBEDTLS_SSL_PRESET_DEFAULT);
+        if (ret == 0) {
+            ret = mbedtls_ssl_config_defaults(&server_conf, MBEDTLS_SSL_IS_SERVER,
+                                              MBEDTLS_SSL_TRANSPORT_STREAM,
+                                              MBEDTLS_SSL_PRESET_DEFAULT);
+        }
+        if (ret == 0) {
+            ret = mbedtls_ssl_conf_psk(&client_conf, psk, sizeof(psk),
+                                       psk_id, sizeof(psk_id) - 1);
+        }
+        if (ret == 0) {
+            ret = mbedtls_ssl_conf_psk(&server_conf, psk, sizeof(psk),
+                                       psk_id, sizeof(psk_id) - 1);
+        }
+        if (ret == 0) {
+            mbedtls_ssl_conf_ciphersuites(&client_conf, ciphersuites);
+            mbedtls_ssl_conf_ciphersuites(&server_conf, ciphersuites);
+            ret = mbedtls_ssl_setup(&client, &client_conf);
+        }
+        if (ret == 0) {
+            ret = mbedtls_ssl_setup(&server, &server_conf);
+        }
+        if (ret != 0) {
+            printf("ERROR: Record I/O bench setup returned -0x%04X\n", -ret);
+            break;
+        }
+        mbedtls_ssl_set_bio(&client, &client_end, tls_bench_pipe_send, tls_bench_pipe_recv, NULL);
+        mbedtls_ssl_set_bio(&server, &server_end, tls_bench_pipe_send, tls_bench_pipe_recv, NULL);
+
+        /* Both ends run in this thread, so step them in turn */
+        client_ret = MBEDTLS_ERR_SSL_WANT_READ;
+        server_ret = MBEDTLS_ERR_SSL_WANT_READ;
+        for (i = 0; i < TLS_BENCH_HANDSHAKE_STEPS && (client_ret != 0 || server_ret != 0); i++) {
+            if (client_ret != 0) {
+                client_ret = mbedtls_ssl_handshake(&client);
+            }
+            if (server_ret != 0) {
+                server_ret = mbedtls_ssl_handshake(&server);
+            }
+            if ((client_ret != 0 && client_ret != MBEDTLS_ERR_SSL_WANT_READ &&
+                 client_ret != MBEDTLS_ERR_SSL_WANT_WRITE) ||
+                (server_ret != 0 && server_ret != MBEDTLS_ERR_SSL_WANT_READ &&
+                 server_ret != MBEDTLS_ERR_SSL_WANT_WRITE)) {
+                break;
+            }
+        }
+        if (client_ret != 0 || server_ret != 0) {
+            printf("ERROR: Record I/O bench handshake returned -0x%04X / -0x%04X\n",
+                   -client_ret, -server_ret);
+            ret = -1;
+        }
+
+        write_cycles = 0;
+        read_cycles = 0;
+        sum = 0;
+        for (i = 0; i < records && ret == 0; i++) {
+            ret = tls_bench_record(&client, &server, mode, i, len,
+                                   &write_cycles, &read_cycles, &sum);
+            if (ret != 0) {
+                printf("ERROR: Record I/O (%s) returned -0x%04X\n", mode_name[mode], -ret);
+            }
+        }
+
+        if (ret == 0) {
+            kbytes = (uint32_t)(((uint64_t)records * len) / 1024U);
+            printf("Record I/O (%s, %lu x %lu bytes): write %lu KB/s, read %lu KB/s, "
+                   "sum %08lx\n", mode_name[mode], (unsigned long)records, (unsigned long)len,
+                   (unsigned long)tls_bench_per_second(kbytes, write_cycles),
+                   (unsigned long)tls_bench_per_second(kbytes, read_cycles),
+                   (unsigned long)sum);
+        }
+
+        mbedtls_ssl_free(&client);
+        mbedtls_ssl_free(&server);
+        mbedtls_ssl_config_free(&client_conf);
+        mbedtls_ssl_config_free(&server_conf);
+    }
+
+    return ret == 0 ? 0 : -1;
+}
+#endif /* MBEDTLS_SSL_ZERO_COPY && MBEDTLS_KEY_EXCHANGE_PSK_ENABLED && MBEDTLS_SSL_SRV_C */
+
+/* Largest record payload measured, plus the tag and room to pick the offset */
+#define TLS_BENCH_PROTECT_MAX 16384
+#define TLS_BENCH_PROTECT_BUF_LEN (TLS_BENCH_PROTECT_MAX + 16 + 32)
+/* Payload offset of a TLS 1.2 GCM record from an aligned buffer without
+ * MBEDTLS_SSL_ALIGNED_RECORDS: sequence number, header and explicit IV */
+#define TLS_BENCH_PROTECT_TLS12_OFFSET (8 + 5 + 8)
+
+/**
+ * @brief Encrypt and decrypt records in place
+ * @param key AES-128-GCM key
+ * @param data Record payload, followed by room for the tag
+ * @param len Payload length
+ * @param iterations Number of records
+ * @param enc_cycles Total cycles spent encrypting
+ * @param dec_cycles Total cycles spent decrypting
+ * @retval 0 if successful, a PSA status otherwise
+ */
+static psa_status_t tls_bench_protect_loop(psa_key_id_t key, uint8_t *data, size_t len,
+                                           uint32_t iterations,
+                                           uint32_t *enc_cycles, uint32_t *dec_cycles)
+{
+    uint8_t nonce[12] = { 0 };
+    uint8_t aad[13] = { 0 };
+    size_t olen;
+    uint32_t start;
+    uint32_t i;
+    psa_status_t status = PSA_SUCCESS;
+
+    *enc_cycles = 0;
+    *dec_cycles = 0;
+
+    for (i = 0; i < iterations && status == PSA_SUCCESS; i++) {
+        /* Sequence number, as in the record nonce and additional data */
+        nonce[8] = aad[4] = (uint8_t)(i >> 24);
+        nonce[9] = aad[5] = (uint8_t)(i >> 16);
+        nonce[10] = aad[6] = (uint8_t)(i >> 8);
+        nonce[11] = aad[7] = (uint8_t)i;
+
+        start = board_timing_cycles();
+        status = psa_aead_encrypt(key, PSA_ALG_GCM, nonce, sizeof(nonce), aad, sizeof(aad),
+                                  data, len, data, len + 16, &olen);
+        *enc_cycles += board_timing_cycles() - start;
+
+        if (status == PSA_SUCCESS) {
+            start = board_timing_cycles();
+            status = psa_aead_decrypt(key, PSA_ALG_GCM, nonce, sizeof(nonce), aad, sizeof(aad),
+                                      data, olen, data, len + 16, &olen);
+            *dec_cycles += board_timing_cycles() - start;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief Measure AES-128-GCM record protection cost for 256 B, 1 KB and
+ *        16 KB records, with the payload 16-byte aligned and at the offset
+ *        of an unaligned TLS 1.2 record
+ * @param iterations Number of records per size and layout
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_record_protect(uint32_t iterations)
+{
+    static const size_t sizes[] = { 256, 1024, TLS_BENCH_PROTECT_MAX };
+    static const size_t offsets[] = { 0, TLS_BENCH_PROTECT_TLS12_OFFSET % 16 };
+    static const char *const layout_name[] = { "aligned", "TLS 1.2 offset" };
+    static const uint8_t key_bytes[16] = { 0 };
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+    psa_key_id_t key = PSA_KEY_ID_NULL;
+    psa_status_t status;
+    uint32_t enc_cycles;
+    uint32_t dec_cycles;
+    uint8_t *buf;
+    uint8_t *base;
+    size_t s;
+    size_t l;
+
+    if (iterations == 0) {
+        return -1;
+    }
+
+    buf = mbedtls_calloc(1, TLS_BENCH_PROTECT_BUF_LEN);
+    if (buf == NULL) {
+        printf("WARNING: record protection buffer does not fit in the heap\n");
+        return -1;
+    }
+    base = buf + ((16U - ((uintptr_t)buf & 15U)) & 15U);
+
+    psa_set_key_usage_flags(&attr, PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT);
+    psa_set_key_algorithm(&attr, PSA_ALG_GCM);
+    psa_set_key_type(&attr, PSA_KEY_TYPE_AES);
+    psa_set_key_bits(&attr, 128);
+    status = psa_import_key(&attr, key_bytes, sizeof(key_bytes), &key);
+
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && status == PSA_SUCCESS; s++) {
+        for (l = 0; l < sizeof(offsets) / sizeof(offsets[0]) && status == PSA_SUCCESS; l++) {
+            status = tls_bench_protect_loop(key, base + offsets[l], sizes[s], iterations,
+                                            &enc_cycles, &dec_cycles);
+            if (status == PSA_SUCCESS) {
+                printf("Record protection (AES-128-GCM, %lu bytes, %s): "
+                       "encrypt %lu us, decrypt %lu us\n",
+                       (unsigned long)sizes[s], layout_name[l],
+                       (unsigned long)board_timing_cycles_to_us(enc_cycles / iterations),
+                       (unsigned long)board_timing_cycles_to_us(dec_cycles / iterations));
+            }
+        }
+    }
+
+    if (status != PSA_SUCCESS) {
+        printf("ERROR: Record protection bench returned %d\n", (int)status);
+    }
+
+    psa_destroy_key(key);
+    mbedtls_free(buf);
+
+    return status == PSA_SUCCESS ? 0 : -1;
+}
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+
+/* Revoked entry: SEQUENCE { 16-byte serial, UTCTime } */
+#define TLS_BENCH_CRL_SERIAL_LEN 16
+#define TLS_BENCH_CRL_ENTRY_LEN (2 + 2 + TLS_BENCH_CRL_SERIAL_LEN + 2 + 13)
+/* Longest DER ECDSA P-256 signature */
+#define TLS_BENCH_CRL_SIG_LEN 72
+/* Download chunk size */
+#define TLS_BENCH_CRL_CHUNK 512
+
+/* Name of the throwaway CA: CN=Bench CRL CA */
+static const uint8_t tls_bench_crl_issuer[] = {
+    0x30, 0x17, 0x31, 0x15, 0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0C, 0x0C,
+    'B', 'e', 'n', 'c', 'h', ' ', 'C', 'R', 'L', ' ', 'C', 'A'
+};
+
+/* Version v2, ecdsa-with-SHA256 */
+static const uint8_t tls_bench_crl_version[] = { 0x02, 0x01, 0x01 };
+static const uint8_t tls_bench_crl_sig_alg[] = {
+    0x30, 0x0A, 0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x04, 0x03, 0x02
+};
+
+/* thisUpdate in the past, nextUpdate far ahead */
+static const uint8_t tls_bench_crl_this_update[] = {
+    0x17, 0x0D, '2', '4', '0', '1', '0', '1', '0', '0', '0', '0', '0', '0', 'Z'
+};
+static const uint8_t tls_bench_crl_next_update[] = {
+    0x18, 0x0F, '2', '0', '9', '9', '1', '2', '3', '1', '2', '3', '5', '9', '5', '9', 'Z'
+};
+
+/* Buffers the generated CRL into download-sized chunks */
+typedef struct {
+    int (*sink)(void *ctx, const uint8_t *data, size_t len);
+    void *ctx;
+    uint8_t buf[TLS_BENCH_CRL_CHUNK];
+    size_t fill;
+    int ret;
+} tls_bench_crl_writer_t;
+
+static void tls_bench_crl_put(tls_bench_crl_writer_t *w, const uint8_t *data, size_t len)
+{
+    size_t n;
+
+    while (len > 0 && w->ret == 0) {
+        n = sizeof(w->buf) - w->fill;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(w->buf + w->fill, data, n);
+        w->fill += n;
+        data += n;
+        len -= n;
+        if (w->fill == sizeof(w->buf)) {
+            w->ret = w->sink(w->ctx, w->buf, w->fill);
+            w->fill = 0;
+        }
+    }
+}
+
+static void tls_bench_crl_hdr(tls_bench_crl_writer_t *w, uint8_t tag, size_t len)
+{
+    uint8_t hdr[5] = { tag };
+    size_t n;
+
+    if (len < 0x80) {
+        hdr[1] = (uint8_t)len;
+        n = 2;
+    } else if (len < 0x100) {
+        hdr[1] = 0x81;
+        hdr[2] = (uint8_t)len;
+        n = 3;
+    } else if (len < 0x10000) {
+        hdr[1] = 0x82;
+        hdr[2] = (uint8_t)(len >> 8);
+        hdr[3] = (uint8_t)len;
+        n = 4;
+    } else {
+        hdr[1] = 0x83;
+        hdr[2] = (uint8_t)(len >> 16);
+        hdr[3] = (uint8_t)(len >> 8);
+        hdr[4] = (uint8_t)len;
+        n = 5;
+    }
+    tls_bench_crl_put(w, hdr, n);
+}
+
+/* Length of a DER element with the given content length */
+static size_t tls_bench_crl_tlv_len(size_t len)
+{
+    return len + (len < 0x80 ? 2 : len < 0x100 ? 3 : len < 0x10000 ? 4 : 5);
+}
+
+/* Serial number of the n-th revoked certificate, positive and 16 bytes long */
+static void tls_bench_crl_serial(uint32_t n, uint8_t serial[TLS_BENCH_CRL_SERIAL_LEN])
+{
+    uint32_t x = n * 2654435761U + 1;
+    size_t i;
+
+    for (i = 0; i < TLS_BENCH_CRL_SERIAL_LEN; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        serial[i] = (uint8_t)x;
+    }
+    serial[0] = 0x40 | (serial[0] & 0x3F);
+}
+
+/**
+ * @brief Generate a CRL with the given number of entries
+ * @param w Output
+ * @param entries Number of revoked certificates
+ * @param sig DER ECDSA signature, or NULL to only generate the TBSCertList
+ * @param sig_len Length of @p sig
+ * @retval 0 if successful, the sink's error otherwise
+ */
+static int tls_bench_crl_generate(tls_bench_crl_writer_t *w, uint32_t entries,
+                                  const uint8_t *sig, size_t sig_len)
+{
+    static const uint8_t unused_bits = 0;
+    static const uint8_t revocation_date[] = {
+        0x17, 0x0D, '2', '5', '0', '1', '0', '1', '0', '0', '0', '0', '0', '0', 'Z'
+    };
+    uint8_t serial[TLS_BENCH_CRL_SERIAL_LEN];
+    size_t revoked_len = (size_t)entries * TLS_BENCH_CRL_ENTRY_LEN;
+    size_t tbs_len;
+    uint32_t i;
+
+    tbs_len = sizeof(tls_bench_crl_version) + sizeof(tls_bench_crl_sig_alg) +
+              sizeof(tls_bench_crl_issuer) + sizeof(tls_bench_crl_this_update) +
+              sizeof(tls_bench_crl_next_update) + tls_bench_crl_tlv_len(revoked_len);
+
+    if (sig != NULL) {
+        tls_bench_crl_hdr(w, 0x30, tls_bench_crl_tlv_len(tbs_len) +
+                          sizeof(tls_bench_crl_sig_alg) + tls_bench_crl_tlv_len(sig_len + 1));
+    }
+    tls_bench_crl_hdr(w, 0x30, tbs_len);
+    tls_bench_crl_put(w, tls_bench_crl_version, sizeof(tls_bench_crl_version));
+    tls_bench_crl_put(w, tls_bench_crl_sig_alg, sizeof(tls_bench_crl_sig_alg));
+    tls_bench_crl_put(w, tls_bench_crl_issuer, sizeof(tls_bench_crl_issuer));
+    tls_bench_crl_put(w, tls_bench_crl_this_update, sizeof(tls_bench_crl_this_update));
+    tls_bench_crl_put(w, tls_bench_crl_next_update, sizeof(tls_bench_crl_next_update));
+
+    tls_bench_crl_hdr(w, 0x30, revoked_len);
+    for (i = 0; i < entries && w->ret == 0; i++) {
+        tls_bench_crl_serial(i, serial);
+        tls_bench_crl_hdr(w, 0x30, TLS_BENCH_CRL_ENTRY_LEN - 2);
+        tls_bench_crl_hdr(w, 0x02, TLS_BENCH_CRL_SERIAL_LEN);
+        tls_bench_crl_put(w, serial, sizeof(serial));
+        tls_bench_crl_put(w, revocation_date, sizeof(revocation_date));
+    }
+
+    if (sig != NULL) {
+        tls_bench_crl_put(w, tls_bench_crl_sig_alg, sizeof(tls_bench_crl_sig_alg));
+        tls_bench_crl_hdr(w, 0x03, sig_len + 1);
+        tls_bench_crl_put(w, &unused_bits, 1);
+        tls_bench_crl_put(w, sig, sig_len);
+    }
+
+    if (w->ret == 0 && w->fill > 0) {
+        w->ret = w->sink(w->ctx, w->buf, w->fill);
+        w->fill = 0;
+    }
+    return w->ret;
+}
+
+static int tls_bench_crl_hash_sink(void *ctx, const uint8_t *data, size_t len)
+{
+    return psa_hash_update(ctx, data, len) == PSA_SUCCESS ? 0 : -1;
+}
+
+static int tls_bench_crl_index_sink(void *ctx, const uint8_t *data, size_t len)
+{
+    return crl_index_update(ctx, data, len);
+}
+
+/**
+ * @brief Generate, sign and load one CRL, then look serial numbers up,
+ *        half of them listed
+ * @param key Signing key of the CA
+ * @param ca CA holding the public half of @p key
+ * @param entries Number of revoked certificates
+ * @param lookups Number of lookups
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int tls_bench_crl_run(psa_key_id_t key, mbedtls_x509_crt *ca, uint32_t entries,
+                             uint32_t lookups)
+{
+    static tls_bench_crl_writer_t writer;
+    static crl_index_parser_t parser;
+    psa_hash_operation_t op = PSA_HASH_OPERATION_INIT;
+    uint8_t hash[32];
+    uint8_t raw[64];
+    uint8_t sig[TLS_BENCH_CRL_SIG_LEN];
+    uint8_t serial[TLS_BENCH_CRL_SERIAL_LEN];
+    crl_index_stats_t stats;
+    crl_index_t index;
+    uint64_t *arena;
+    size_t der_len;
+    size_t len;
+    uint32_t revoked = 0;
+    uint32_t i;
+    int ret;
+
+    arena = mbedtls_calloc(1, CRL_INDEX_ARENA_LEN(entries));
+    if (arena == NULL) {
+        printf("CRL index (%lu entries): skipped, the %lu-byte arena does not fit in the heap\n",
+               (unsigned long)entries, (unsigned long)CRL_INDEX_ARENA_LEN(entries));
+        return 0;
+    }
+
+    /* Sign the TBSCertList, generated once for its hash */
+    memset(&writer, 0, sizeof(writer));
+    writer.sink = tls_bench_crl_hash_sink;
+    writer.ctx = &op;
+    ret = psa_hash_setup(&op, PSA_ALG_SHA_256) == PSA_SUCCESS ? 0 : -1;
+    if (ret == 0) {
+        ret = tls_bench_crl_generate(&writer, entries, NULL, 0);
+    }
+    if (ret == 0 && psa_hash_finish(&op, hash, sizeof(hash), &len) != PSA_SUCCESS) {
+        ret = -1;
+    }
+    if (ret == 0 &&
+        psa_sign_hash(key, PSA_ALG_ECDSA(PSA_ALG_SHA_256), hash, sizeof(hash),
+                      raw, sizeof(raw), &len) != PSA_SUCCESS) {
+        ret = -1;
+    }
+    if (ret == 0) {
+        ret = mbedtls_ecdsa_raw_to_der(256, raw, len, sig, sizeof(sig), &len);
+    }
+    psa_hash_abort(&op);
+
+    /* Stream it again, signed, into the index */
+    crl_index_init(&index, arena, CRL_INDEX_ARENA_LEN(entries));
+    if (ret == 0) {
+        ret = crl_index_begin(&parser, &index, ca, NULL);
+    }
+    if (ret == 0) {
+        memset(&writer, 0, sizeof(writer));
+        writer.sink = tls_bench_crl_index_sink;
+        writer.ctx = &parser;
+        ret = tls_bench_crl_generate(&writer, entries, sig, len);
+        if (ret == 0) {
+            ret = crl_index_finish(&parser);
+        }
+    }
+
+    if (ret == 0) {
+        for (i = 0; i < lookups; i++) {
+            /* Even lookups hit a listed serial number, odd ones miss */
+            tls_bench_crl_serial((i & 1) * entries + (i >> 1) % entries, serial);
+            revoked += (uint32_t)crl_index_lookup(&index, serial, sizeof(serial));
+        }
+        crl_index_get_stats(&index, &stats);
+
+        der_len = tls_bench_crl_tlv_len(
+            tls_bench_crl_tlv_len(sizeof(tls_bench_crl_version) + sizeof(tls_bench_crl_sig_alg) +
+                                  sizeof(tls_bench_crl_issuer) +
+                                  sizeof(tls_bench_crl_this_update) +
+                                  sizeof(tls_bench_crl_next_update) +
+                                  tls_bench_crl_tlv_len((size_t)entries *
+                                                        TLS_BENCH_CRL_ENTRY_LEN)) +
+            sizeof(tls_bench_crl_sig_alg) + tls_bench_crl_tlv_len(len + 1));
+
+        printf("CRL index (%lu entries, %lu KB DER): load %lu ms, %lu lookups/s, "
+               "%lu/%lu revoked\n",
+               (unsigned long)entries, (unsigned long)(der_len / 1024),
+               (unsigned long)(board_timing_cycles_to_us(stats.load_cycles) / 1000),
+               (unsigned long)tls_bench_per_second(stats.lookups, stats.lookup_cycles),
+               (unsigned long)revoked, (unsigned long)lookups);
+        printf("  RAM: arena %lu B, parser %lu B while loading; "
+               "mbedtls_x509_crl_parse_der() %lu B\n",
+               (unsigned long)CRL_INDEX_ARENA_LEN(entries), (unsigned long)sizeof(parser),
+               (unsigned long)(der_len + entries * sizeof(mbedtls_x509_crl_entry)));
+    } else {
+        printf("ERROR: CRL index bench (%lu entries) returned -0x%04X\n",
+               (unsigned long)entries, (unsigned int)-ret);
+    }
+
+    mbedtls_free(arena);
+    return ret;
+}
+
+/**
+ * @brief Measure CRL ingestion and revocation lookups with the streaming
+ *        CRL index, for CRLs of 1k, 10k and 100k entries
+ * @param lookups Number of revocation lookups per size
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_crl_index(uint32_t lookups)
+{
+    static const uint32_t sizes[] = { 1000, 10000, 100000 };
+    psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+    psa_key_id_t key = PSA_KEY_ID_NULL;
+    mbedtls_x509_crt ca;
+    size_t i;
+    int ret = -1;
+
+    if (lookups == 0) {
+        return -1;
+    }
+
+    /* Throwaway CA: only its subject and public key are looked at */
+    mbedtls_x509_crt_init(&ca);
+    psa_set_key_usage_flags(&attr, PSA_KEY_USAGE_SIGN_HASH);
+    psa_set_key_algorithm(&attr, PSA_ALG_ECDSA(PSA_ALG_SHA_256));
+    psa_set_key_type(&attr, PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_SECP_R1));
+    psa_set_key_bits(&attr, 256);
+    if (psa_generate_key(&attr, &key) == PSA_SUCCESS &&
+        mbedtls_pk_copy_public_from_psa(key, &ca.pk) == 0) {
+        ca.subject_raw.p = (unsigned char *)tls_bench_crl_issuer;
+        ca.subject_raw.len = sizeof(tls_bench_crl_issuer);
+        ret = 0;
+    } else {
+        printf("ERROR: CRL index bench could not create its CA key\n");
+    }
+
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && ret == 0; i++) {
+        ret = tls_bench_crl_run(key, &ca, sizes[i], lookups);
+    }
+
+    mbedtls_x509_crt_free(&ca);
+    psa_destroy_key(key);
+
+    return ret;
+}
+
+#endif /* MBEDTLS_X509_CRT_PARSE_C */
+
+#if defined(MBEDTLS_PKCS7_C)
+
+/* Image bytes per fw_verify_update(), as read from external flash */
+#define TLS_BENCH_FW_CHUNK 4096
+
+/**
+ * @brief Measure streaming verification of a signed firmware image with the
+ *        digest on the host and on the SE05x
+ * @param image Image, in memory-mapped flash
+ * @param image_len Length of @p image
+ * @param sig Detached PKCS#7 signature of @p image
+ * @param sig_len Length of @p sig
+ * @param trust_ca CAs the signer carried in @p sig must chain to
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_fw_verify(const uint8_t *image, size_t image_len, const uint8_t *sig,
+                        size_t sig_len, mbedtls_x509_crt *trust_ca)
+{
+    static const char *const where_name[] = { "host", "SE05x" };
+    static uint8_t chunk[TLS_BENCH_FW_CHUNK];
+    fw_verify_t fw;
+    fw_verify_stats_t stats;
+    uint32_t flags;
+    size_t off;
+    size_t n;
+    int where;
+    int ret = 0;
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+    size_t max_used = 0;
+    size_t max_blocks = 0;
+#endif
+
+    for (where = FW_VERIFY_DIGEST_HOST; where <= FW_VERIFY_DIGEST_SE && ret == 0; where++) {
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+        mbedtls_memory_buffer_alloc_max_reset();
+#endif
+        ret = fw_verify_begin(&fw, sig, sig_len, (fw_verify_digest_t)where);
+        /* Each chunk goes through RAM, as it would from external flash */
+        for (off = 0; off < image_len && ret == 0; off += n) {
+            n = image_len - off < sizeof(chunk) ? image_len - off : sizeof(chunk);
+            memcpy(chunk, image + off, n);
+            ret = fw_verify_update(&fw, chunk, n);
+        }
+        if (ret == 0) {
+            ret = fw_verify_finish(&fw, NULL, trust_ca, &flags);
+        }
+        fw_verify_get_stats(&fw, &stats);
+        fw_verify_free(&fw);
+
+        if (ret != 0) {
+            printf("ERROR: Firmware verification (%s digest) returned -0x%04X\n",
+                   where_name[where], (unsigned int)-ret);
+            break;
+        }
+        printf("Firmware verification (%lu KB, %s digest): digest %lu ms (%lu KB/s), "
+               "signature and chain %lu ms\n",
+               (unsigned long)(image_len / 1024), where_name[where],
+               (unsigned long)(board_timing_cycles_to_us(stats.digest_cycles) / 1000),
+               (unsigned long)tls_bench_per_second(stats.bytes / 1024, stats.digest_cycles),
+               (unsigned long)(board_timing_cycles_to_us(stats.verify_cycles) / 1000));
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+        mbedtls_memory_buffer_alloc_max_get(&max_used, &max_blocks);
+        printf("Firmware verification (%s digest): peak heap %lu bytes in %lu blocks\n",
+               where_name[where], (unsigned long)max_used, (unsigned long)max_blocks);
+#endif
+    }
+
+    return ret == 0 ? 0 : -1;
+}
+
+#endif /* MBEDTLS_PKCS7_C */
+
+#if defined(MBEDTLS_X509_CSR_WRITE_SIGN_CB)
+
+/* Most slots measured in one batch */
+#define TLS_BENCH_CSR_MAX_SLOTS 4
+
+/**
+ * @brief Measure CSR generation with SE05x-resident keys
+ * @param key_ids Key IDs of EC key pairs in the SE05x
+ * @param count Number of entries in @p key_ids
+ * @param iterations Number of CSR rebuilds for the first slot
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_csr(const uint32_t *key_ids, size_t count, uint32_t iterations)
+{
+    static uint8_t out[TLS_BENCH_CSR_MAX_SLOTS * SE05X_CSR_MAX_LEN];
+    static const char *const subjects[TLS_BENCH_CSR_MAX_SLOTS] = {
+        "CN=se05x-slot-0,O=Fleet", "CN=se05x-slot-1,O=Fleet",
+        "CN=se05x-slot-2,O=Fleet", "CN=se05x-slot-3,O=Fleet",
+    };
+    size_t csr_len[TLS_BENCH_CSR_MAX_SLOTS];
+    se05x_csr_stats_t stats;
+    se05x_csr_key_t ctx;
+    sss_object_t key;
+    size_t len;
+    size_t done;
+    uint32_t i;
+    int ret = 0;
+
+    if (count == 0 || count > TLS_BENCH_CSR_MAX_SLOTS || iterations == 0) {
+        return -1;
+    }
+
+    if (sss_key_object_init(&key, &g_key_store) != kStatus_SSS_Success ||
+        sss_key_object_get_handle(&key, key_ids[0]) != kStatus_SSS_Success) {
+        printf("ERROR: No key pair 0x%08X in SE05x\n", (unsigned int)key_ids[0]);
+        return -1;
+    }
+
+    se05x_csr_reset_stats();
+    if (se05x_csr_key_setup(&ctx, &key) != 0) {
+        sss_key_object_free(&key);
+        return -1;
+    }
+    for (i = 0; i < iterations && ret == 0; i++) {
+        ret = se05x_csr_write(&ctx, subjects[0], out, SE05X_CSR_MAX_LEN, &len);
+    }
+    se05x_csr_key_free(&ctx);
+    sss_key_object_free(&key);
+    if (ret != 0) {
+        printf("ERROR: CSR bench returned -0x%04X\n", (unsigned int)-ret);
+        return -1;
+    }
+
+    se05x_csr_get_stats(&stats);
+    printf("CSR (%lu bytes): public key read %lu us once, rebuild %lu us "
+           "(SE05x sign %lu us)\n",
+           (unsigned long)len,
+           (unsigned long)board_timing_cycles_to_us(stats.read_cycles),
+           (unsigned long)board_timing_cycles_to_us(stats.write_cycles / iterations),
+           (unsigned long)board_timing_cycles_to_us(stats.sign_cycles / iterations));
+
+    se05x_csr_reset_stats();
+    done = se05x_csr_batch(key_ids, subjects, count, out, sizeof(out), csr_len);
+    se05x_csr_get_stats(&stats);
+    printf("CSR batch: %lu of %lu slots in %lu ms, %lu us per CSR\n",
+           (unsigned long)done, (unsigned long)count,
+           (unsigned long)(board_timing_cycles_to_us(stats.batch_cycles) / 1000),
+           (unsigned long)(done ? board_timing_cycles_to_us(stats.batch_cycles) / done : 0));
+
+    return done == count ? 0 : -1;
+}
+
+#endif /* MBEDTLS_X509_CSR_WRITE_SIGN_CB */
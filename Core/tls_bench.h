@@ -0,0 +1,175 @@
+/**
+ * @file tls_bench.h
+ * @brief On-target micro benchmarks for the TLS client
+ */
+
+#ifndef TLS_BENCH_H
+#define TLS_BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/ssl.h"
+#include "trust_store.h"
+
+/**
+ * @brief Time mbedtls_x509_crt_verify() on a certificate chain, with and
+ *        without the batch verification callback
+ * @param chain Parsed chain, leaf first (typically 2 to 4 certificates)
+ * @param trust_ca Trusted CA list
+ * @param iterations Number of verifications per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_chain_verify(mbedtls_x509_crt *chain, mbedtls_x509_crt *trust_ca,
+                           uint32_t iterations);
+
+/**
+ * @brief Time secp256r1 key generation on a freshly loaded group, as in
+ *        host-side ECDHE and verify, and report peak heap usage,
+ *        with the comb table built in RAM and with the ROM comb table
+ * @param f_rng RNG function
+ * @param p_rng RNG context
+ * @param iterations Number of key generations per mode
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note Peak heap is only reported with MBEDTLS_MEMORY_DEBUG.
+ */
+int tls_bench_ecdhe_keygen(int (*f_rng)(void *, unsigned char *, size_t), void *p_rng,
+                           uint32_t iterations);
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+/**
+ * @brief Measure session cache lookups per second at 16 to 4096 entries
+ * @param session Session stored under every ID, e.g. from mbedtls_ssl_get_session()
+ * @param lookups Number of lookups per cache size, for hits and for misses
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note Sizes whose entries do not fit in the heap are skipped.
+ */
+int tls_bench_session_cache(const mbedtls_ssl_session *session, uint32_t lookups);
+#endif
+
+/**
+ * @brief Measure session ticket write and parse throughput with the ticket
+ *        key in the SE05x and with the epoch key cached on the host
+ * @param session Session to put in the tickets, e.g. from mbedtls_ssl_get_session()
+ * @param iterations Number of tickets written and parsed per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_ticket(const mbedtls_ssl_session *session, uint32_t iterations);
+
+#if defined(MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK)
+/**
+ * @brief Time chain verification against an indexed trust store and against
+ *        the same CAs as a plain trusted CA list
+ * @param chain Parsed chain, leaf first, whose root is in @p store
+ * @param store Store set up with trust_store_load(), build it with
+ *        TRUST_STORE_FILL to compare store sizes
+ * @param iterations Number of verifications per mode
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note The plain list is skipped when its parsed CAs do not fit in the heap.
+ */
+int tls_bench_trust_store(mbedtls_x509_crt *chain, trust_store_t *store, uint32_t iterations);
+#endif
+
+/**
+ * @brief Measure boot-time CA loading: parsing every CA with
+ *        mbedtls_x509_crt_parse_der() against loading the pre-parsed store
+ *        and taking a view of every CA
+ * @param blob Blob from scripts/gen_trust_store.py
+ * @param len Length of @p blob
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note Heap figures need MBEDTLS_MEMORY_DEBUG.
+ */
+int tls_bench_trust_store_boot(const uint8_t *blob, size_t len);
+
+#if defined(MBEDTLS_SSL_ZERO_COPY) && defined(MBEDTLS_KEY_EXCHANGE_PSK_ENABLED) && \
+    defined(MBEDTLS_SSL_SRV_C)
+/**
+ * @brief Measure application data throughput with mbedtls_ssl_write() /
+ *        mbedtls_ssl_read() and with the zero-copy view API
+ *
+ * A client and a server context exchange records over an in-memory pipe after
+ * a PSK handshake. The write side fills every payload byte, the read side sums
+ * every payload byte, so each mode touches the data once on top of what the
+ * API itself copies.
+ *
+ * @param records Number of records sent per mode
+ * @param len Payload length of every record, at most MBEDTLS_SSL_OUT_CONTENT_LEN
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note With MBEDTLS_SSL_BUFFER_POOL both ends take their record buffers
+ *       from the pool, which must have room for two more connections.
+ */
+int tls_bench_record_io(uint32_t records, size_t len);
+#endif
+
+/**
+ * @brief Measure AES-128-GCM record protection cost for 256 B, 1 KB and
+ *        16 KB records, with the payload 16-byte aligned and at the offset
+ *        of an unaligned TLS 1.2 record
+ *
+ * Every record is encrypted and decrypted in place with psa_aead_encrypt()
+ * and psa_aead_decrypt(), as the record layer does, so the figures isolate
+ * the cipher from record I/O.
+ *
+ * @param iterations Number of records per size and layout
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note Needs about 16.5 KB of heap for the largest record.
+ */
+int tls_bench_record_protect(uint32_t iterations);
+
+/**
+ * @brief Measure CRL ingestion and revocation lookups with the streaming
+ *        CRL index, for CRLs of 1k, 10k and 100k entries
+ *
+ * Each CRL is generated on the fly and signed by a throwaway P-256 key,
+ * then streamed into the index in 512-byte chunks as if downloaded, so the
+ * CRL itself is never held in RAM. Only the arena of 8 bytes per entry is
+ * allocated; sizes whose arena does not fit in the heap are skipped. The
+ * memory mbedtls_x509_crl_parse_der() would need for the same CRL is printed
+ * alongside.
+ *
+ * @param lookups Number of revocation lookups per size
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_crl_index(uint32_t lookups);
+
+/**
+ * @brief Measure streaming verification of a signed firmware image with the
+ *        digest on the host and on the SE05x
+ *
+ * The image is fed to fw_verify_update() in 4 KB chunks copied through RAM,
+ * as from external flash or an OTA download, so the heap holds only the
+ * parsed signature whatever the image size.
+ *
+ * @param image Image, in memory-mapped flash
+ * @param image_len Length of @p image
+ * @param sig Detached PKCS#7 signature of @p image, with the signer chain
+ * @param sig_len Length of @p sig
+ * @param trust_ca CAs the signer carried in @p sig must chain to
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note Peak heap is only reported with MBEDTLS_MEMORY_DEBUG.
+ */
+int tls_bench_fw_verify(const uint8_t *image, size_t image_len, const uint8_t *sig,
+                        size_t sig_len, mbedtls_x509_crt *trust_ca);
+
+/**
+ * @brief Measure CSR generation with SE05x-resident keys
+ *
+ * Times reading the public key of the first slot once, rebuilding its CSR
+ * @p iterations times from the cached key, then one batch over all slots
+ * from key lookup to the last CSR.
+ *
+ * @param key_ids Key IDs of EC key pairs in the SE05x
+ * @param count Number of entries in @p key_ids
+ * @param iterations Number of CSR rebuilds for the first slot
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_bench_csr(const uint32_t *key_ids, size_t count, uint32_t iterations);
+
+#endif /* TLS_BENCH_H */
@@ -5,19 +5,44 @@
 
 #include "tls_client.h"
 #include "se05x_init.h"
+#include "se05x_verify.h"
+#include "se05x_ecdh.h"
+#include "se05x_async.h"
+#include "se05x_session.h"
+#include "tls_profile.h"
+#include "trust_store.h"
+#include "chain_cache.h"
+#include "record_pool.h"
+#include "tls_loop.h"
+#include "board_timing.h"
 #include "mbedtls/ssl.h"
 #include "mbedtls/net_sockets.h"
 #include "mbedtls/error.h"
 #include "mbedtls/ctr_drbg.h"
 #include "mbedtls/entropy.h"
 #include "sss_mbedtls.h"
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C)
+#include "mbedtls/memory_buffer_alloc.h"
+#endif
 #include <stdio.h>
 #include <string.h>
 
+#if defined(TRUST_STORE_BUNDLE) && defined(MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK)
+#include "trust_store_blob.h"
+#define TLS_USE_TRUST_STORE
+#endif
+
 /* Server configuration */
 #define SERVER_NAME "httpbin.org"
 #define SERVER_PORT "443"
 
+/* Largest record we ask the server to send; the input buffer starts at this
+ * size and only grows if the server ignores the request */
+#define TLS_MAX_FRAG_LEN MBEDTLS_SSL_MAX_FRAG_LEN_4096
+
+/* Simultaneous connections opened by tls_client_bench_memory() */
+#define TLS_BENCH_MAX_CONNECTIONS 8
+
 /* Global variables for mbed TLS contexts */
 static mbedtls_net_context server_fd;
 static mbedtls_entropy_context entropy;
@@ -25,6 +50,68 @@ static mbedtls_ctr_drbg_context ctr_drbg;
 static mbedtls_ssl_context ssl;
 static mbedtls_ssl_config conf;
 
+/* RNG for pooled ECDHE keys, kept across connections */
+static mbedtls_entropy_context pool_entropy;
+static mbedtls_ctr_drbg_context pool_ctr_drbg;
+static int pool_rng_ready;
+
+#if defined(TLS_USE_TRUST_STORE)
+/* Trusted CAs, indexed in flash and looked up per certificate */
+static trust_store_t trust_store;
+static int trust_store_ready;
+#endif
+
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+/* Skip re-verifying a server chain seen before, toggled by the benchmark */
+static int chain_cache_enabled = 1;
+#endif
+
+/* Keep the session in the SE05x for the first connection after a reset,
+ * turned off by the benchmarks that measure full handshakes */
+static int session_persist = 1;
+
+/* Set once the session of the current connection went to the SE05x: a
+ * server may send several tickets, only the first is written */
+static int session_stored;
+
+/* Offer only this protocol version when set, by the benchmarks */
+static mbedtls_ssl_protocol_version tls_version = MBEDTLS_SSL_VERSION_UNKNOWN;
+
+/* Session resumed from RAM by tls_client_bench_tls13() */
+static mbedtls_ssl_session bench_session;
+static int bench_session_keep;
+static int bench_session_valid;
+
+/* Offer early data on the next connection, set by tls_client_report() */
+static int tls_early_data;
+#if defined(MBEDTLS_SSL_EARLY_DATA)
+static uint32_t early_data_accepted;
+static uint32_t early_data_rejected;
+#endif
+
+/* Time from connect to the first reply byte of the last report, in cycles */
+static uint32_t last_reply_cycles;
+
+/* Duration of the last successful handshake, in cycles */
+static uint32_t last_handshake_cycles;
+
+/* Per-state handshake profile, reported if tls_profile_set_report() was called */
+static tls_profile_t handshake_profile;
+
+/* Handshake configurations compared by tls_client_bench() */
+typedef struct {
+    const char *name;
+    int sign_on_se;
+    se05x_ecdh_mode_t ecdh_mode;
+    se05x_verify_route_t verify_route;
+} tls_bench_config_t;
+
+static const tls_bench_config_t bench_configs[] = {
+    { "all-host",     0, SE05X_ECDH_MODE_HOST, SE05X_VERIFY_ROUTE_HOST },
+    { "sign-only-SE", 1, SE05X_ECDH_MODE_HOST, SE05X_VERIFY_ROUTE_AUTO },
+    { "ECDHE-on-SE",  1, SE05X_ECDH_MODE_SE,   SE05X_VERIFY_ROUTE_AUTO },
+};
+
 /**
  * @brief Initialize mbed TLS contexts
  * @retval 0 if successful, non-zero otherwise
@@ -57,9 +144,10 @@ static int tls_init(void)
 
 /**
  * @brief Configure mbed TLS for TLS connection
+ * @param sign_on_se Use the SE05x key for client authentication
  * @retval 0 if successful, non-zero otherwise
  */
-static int tls_configure(void)
+static int tls_configure(int sign_on_se)
 {
     int ret;
     sss_status_t status;
@@ -78,12 +166,78 @@ static int tls_configure(void)
     /* Set RNG callback */
     mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &ctr_drbg);
     
-    /* Associate SE05x key with mbed TLS */
-    status = sss_mbedtls_associate_keypair(&ssl, &g_tls_key);
-    if (status != kStatus_SSS_Success) {
-        printf("ERROR: Failed to associate SE05x key with mbed TLS (status = 0x%X)\n", status);
+    if (tls_version != MBEDTLS_SSL_VERSION_UNKNOWN) {
+        mbedtls_ssl_conf_min_tls_version(&conf, tls_version);
+        mbedtls_ssl_conf_max_tls_version(&conf, tls_version);
+    }
+    
+#if defined(MBEDTLS_SSL_EARLY_DATA)
+    /* Only used if the resumed session's ticket allows it */
+    mbedtls_ssl_conf_early_data(&conf, tls_early_data ? MBEDTLS_SSL_EARLY_DATA_ENABLED :
+                                                        MBEDTLS_SSL_EARLY_DATA_DISABLED);
+#endif
+    
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    /* Small records keep the per-connection buffers small */
+    if ((ret = mbedtls_ssl_conf_max_frag_len(&conf, TLS_MAX_FRAG_LEN)) != 0) {
+        printf("ERROR: mbedtls_ssl_conf_max_frag_len returned -0x%04X\n", -ret);
         return -1;
     }
+#endif
+    
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+    /* Verify the ECDSA signatures of the server chain in a single batch */
+    mbedtls_x509_crt_set_batch_verify_cb(se05x_verify_chain_batch_check,
+                                         se05x_verify_chain_batch, NULL);
+#endif
+    
+#if defined(TLS_USE_TRUST_STORE)
+    /* Only the CAs whose subject or key identifier match are parsed */
+    if (!trust_store_ready) {
+        if (trust_store_load(&trust_store, trust_store_blob, sizeof(trust_store_blob)) != 0) {
+            return -1;
+        }
+        trust_store_ready = 1;
+    }
+    mbedtls_ssl_conf_ca_cb(&conf, trust_store_ca_cb, &trust_store);
+#endif
+    
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+    /* Cached chains are keyed by the trusted CAs they were verified against;
+     * the trust store version covers what trust_store_ca_cb() returns */
+    if (chain_cache_enabled) {
+#if defined(TLS_USE_TRUST_STORE)
+        chain_cache_setup(trust_store_version(&trust_store));
+#else
+        chain_cache_setup(0);
+#endif
+    } else {
+        chain_cache_free();
+    }
+#endif
+    
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+    /* secp256r1 ECDHE on the host or the SE05x, with pooled keys */
+    se05x_ecdh_conf(&conf);
+#endif
+    
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    /* Idle connections hand their record buffers back to a shared pool */
+    record_pool_setup();
+#endif
+    
+    /* Associate SE05x key with mbed TLS */
+    if (sign_on_se) {
+        status = sss_mbedtls_associate_keypair(&ssl, &g_tls_key);
+        if (status != kStatus_SSS_Success) {
+            printf("ERROR: Failed to associate SE05x key with mbed TLS (status = 0x%X)\n", status);
+            return -1;
+        }
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+        /* Queue the CertificateVerify signature instead of blocking on I2C */
+        se05x_async_conf(&conf, &g_tls_key);
+#endif
+    }
     
     /* Setup SSL context */
     if ((ret = mbedtls_ssl_setup(&ssl, &conf)) != 0) {
@@ -97,6 +251,17 @@ static int tls_configure(void)
         return -1;
     }
     
+    /* Resume the session stored before the last reset, if any */
+    session_stored = 0;
+    if (session_persist && se05x_session_load(SE05X_SESSION_SLOT_TLS, &ssl, SERVER_NAME) == 0) {
+        printf("Restored stored session for %s\n", SERVER_NAME);
+    }
+    if (bench_session_keep && bench_session_valid &&
+        (ret = mbedtls_ssl_set_session(&ssl, &bench_session)) != 0) {
+        printf("ERROR: mbedtls_ssl_set_session returned -0x%04X\n", -ret);
+        return -1;
+    }
+    
     printf("mbed TLS configured successfully\n");
     return 0;
 }
@@ -119,13 +284,36 @@ static int tls_connect(void)
     }
     
     /* Set BIO callbacks */
-    mbedtls_ssl_set_bio(&ssl, &server_fd, 
-                       mbedtls_net_send, mbedtls_net_recv, NULL);
+    tls_profile_set_bio(&handshake_profile, &ssl, &server_fd,
+                        mbedtls_net_send, mbedtls_net_recv, NULL);
     
     printf("Connected to server successfully\n");
     return 0;
 }
 
+/**
+ * @brief Keep the resumable session, in RAM for the benchmark or in the SE05x
+ *
+ * Called at the end of a TLS 1.2 handshake and for each TLS 1.3 ticket, which
+ * only arrives after the handshake.
+ */
+static void tls_keep_session(void)
+{
+    if (bench_session_keep) {
+        mbedtls_ssl_session_free(&bench_session);
+        mbedtls_ssl_session_init(&bench_session);
+        bench_session_valid = mbedtls_ssl_get_session(&ssl, &bench_session) == 0;
+    } else if (session_persist && !session_stored) {
+        /* A resumed session that did not change, or a new ticket while the
+         * stored one is still fresh, is not written */
+        if (se05x_session_save(SE05X_SESSION_SLOT_TLS, &ssl, SERVER_NAME) != 0) {
+            printf("WARNING: Session not stored, next boot will do a full handshake\n");
+        } else {
+            session_stored = 1;
+        }
+    }
+}
+
 /**
  * @brief Perform TLS handshake
  * @retval 0 if successful, non-zero otherwise
@@ -133,11 +321,29 @@ static int tls_connect(void)
 static int tls_handshake(void)
 {
     int ret;
+    uint32_t start;
+    se05x_verify_stats_t stats;
+    se05x_ecdh_stats_t ecdh_stats;
     
     printf("Performing TLS handshake...\n");
     
+    se05x_verify_reset_stats();
+    se05x_ecdh_reset_stats();
+#if defined(TLS_USE_TRUST_STORE)
+    trust_store_reset_stats(&trust_store);
+#endif
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+    chain_cache_reset_stats();
+#endif
+    start = board_timing_cycles();
+    
     /* Perform handshake */
-    while ((ret = mbedtls_ssl_handshake(&ssl)) != 0) {
+    while ((ret = tls_profile_handshake(&handshake_profile, &ssl)) != 0) {
+        if (ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+            /* Other connections could be driven here while the SE05x signs */
+            se05x_async_poll();
+            continue;
+        }
         if (ret != MBEDTLS_ERR_SSL_WANT_READ && 
             ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
             printf("ERROR: mbedtls_ssl_handshake returned -0x%04X\n", -ret);
@@ -145,6 +351,60 @@ static int tls_handshake(void)
         }
     }
     
+    last_handshake_cycles = board_timing_cycles() - start;
+    
+    /* Report where the certificate chain signatures were verified */
+    se05x_verify_get_stats(&stats);
+    printf("Handshake time: %lu us\n",
+           (unsigned long)board_timing_cycles_to_us(last_handshake_cycles));
+    printf("ECDSA verify: host %lu (%lu us), SE %lu (%lu us), peer key cache %lu hit / %lu miss\n",
+           (unsigned long)stats.host_count,
+           (unsigned long)board_timing_cycles_to_us(stats.host_cycles),
+           (unsigned long)stats.se_count,
+           (unsigned long)board_timing_cycles_to_us(stats.se_cycles),
+           (unsigned long)stats.cache_hits,
+           (unsigned long)stats.cache_misses);
+    printf("ECDSA batch verify: %lu chains, %lu signatures (%lu us)\n",
+           (unsigned long)stats.batch_count,
+           (unsigned long)stats.batch_signatures,
+           (unsigned long)board_timing_cycles_to_us(stats.batch_cycles));
+    
+    /* Report where ECDHE ran and the latency estimates behind the choice */
+    se05x_ecdh_get_stats(&ecdh_stats);
+    printf("ECDHE: host %lu (%lu us), SE %lu (%lu us), estimate host %lu us / SE %lu us\n",
+           (unsigned long)ecdh_stats.host_count,
+           (unsigned long)board_timing_cycles_to_us(ecdh_stats.host_cycles),
+           (unsigned long)ecdh_stats.se_count,
+           (unsigned long)board_timing_cycles_to_us(ecdh_stats.se_cycles),
+           (unsigned long)board_timing_cycles_to_us(ecdh_stats.host_avg),
+           (unsigned long)board_timing_cycles_to_us(ecdh_stats.se_avg));
+    printf("ECDHE key pool: %lu hit / %lu miss, %lu refills\n",
+           (unsigned long)ecdh_stats.pool_hits,
+           (unsigned long)ecdh_stats.pool_misses,
+           (unsigned long)ecdh_stats.pool_refills);
+    
+#if defined(TLS_USE_TRUST_STORE)
+    /* Report how many trusted CAs were parsed to find the chain's root */
+    trust_store_stats_t ts_stats;
+    trust_store_get_stats(&trust_store, &ts_stats);
+    printf("Trust store: %lu lookups, %lu candidates (%lu by key id) of %lu CAs (%lu us)\n",
+           (unsigned long)ts_stats.lookups,
+           (unsigned long)ts_stats.candidates,
+           (unsigned long)ts_stats.aki_matches,
+           (unsigned long)trust_store.count,
+           (unsigned long)board_timing_cycles_to_us(ts_stats.lookup_cycles));
+#endif
+    
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+    /* A hit means the server chain was not verified again */
+    chain_cache_stats_t cc_stats;
+    chain_cache_get_stats(&cc_stats);
+    printf("Verified-chain cache: %lu hit / %lu miss (%lu us)\n",
+           (unsigned long)cc_stats.hits,
+           (unsigned long)cc_stats.misses,
+           (unsigned long)board_timing_cycles_to_us(cc_stats.lookup_cycles));
+#endif
+    
     /* Check certificate verification */
     uint32_t flags = mbedtls_ssl_get_verify_result(&ssl);
     if (flags != 0) {
@@ -158,7 +418,12 @@ static int tls_handshake(void)
     }
     
     printf("TLS handshake completed successfully\n");
+    printf("Protocol: %s\n", mbedtls_ssl_get_version(&ssl));
     printf("Cipher suite: %s\n", mbedtls_ssl_get_ciphersuite(&ssl));
+    
+    if (mbedtls_ssl_get_version_number(&ssl) != MBEDTLS_SSL_VERSION_TLS1_3) {
+        tls_keep_session();
+    }
     return 0;
 }
 
@@ -170,7 +435,12 @@ static int tls_exchange_data(void)
 {
     int ret;
     size_t len;
+#if defined(MBEDTLS_SSL_ZERO_COPY)
+    unsigned char *out;
+    const unsigned char *in;
+#else
     unsigned char buf[1024];
+#endif
     
     printf("Exchanging data over TLS connection...\n");
     
@@ -181,6 +451,29 @@ static int tls_exchange_data(void)
                                "\r\n";
     
     printf("Sending HTTP request...\n");
+#if defined(MBEDTLS_SSL_ZERO_COPY)
+    /* Build the request straight into the output record */
+    while ((ret = mbedtls_ssl_write_view(&ssl, &out)) < 0) {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && 
+            ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            printf("ERROR: mbedtls_ssl_write_view returned -0x%04X\n", -ret);
+            return -1;
+        }
+    }
+    len = strlen(http_request);
+    if (len > (size_t)ret) {
+        printf("ERROR: HTTP request does not fit in one record\n");
+        return -1;
+    }
+    memcpy(out, http_request, len);
+    while ((ret = mbedtls_ssl_write_commit(&ssl, len)) <= 0) {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && 
+            ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            printf("ERROR: mbedtls_ssl_write_commit returned -0x%04X\n", -ret);
+            return -1;
+        }
+    }
+#else
     while ((ret = mbedtls_ssl_write(&ssl, (const unsigned char *)http_request, 
                                    strlen(http_request))) <= 0) {
         if (ret != MBEDTLS_ERR_SSL_WANT_READ && 
@@ -189,6 +482,7 @@ static int tls_exchange_data(void)
             return -1;
         }
     }
+#endif
     
     len = ret;
     printf("Sent %d bytes\n", len);
@@ -196,14 +490,24 @@ static int tls_exchange_data(void)
     /* Read HTTP response */
     printf("Receiving HTTP response...\n");
     do {
+#if defined(MBEDTLS_SSL_ZERO_COPY)
+        ret = mbedtls_ssl_read_view(&ssl, &in);
+#else
         memset(buf, 0, sizeof(buf));
         ret = mbedtls_ssl_read(&ssl, buf, sizeof(buf) - 1);
+#endif
         
         if (ret == MBEDTLS_ERR_SSL_WANT_READ || 
             ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
             continue;
         }
         
+        if (ret == MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET) {
+            /* TLS 1.3 session ticket, resumable from now on */
+            tls_keep_session();
+            continue;
+        }
+        
         if (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) {
             printf("Connection was closed gracefully\n");
             break;
@@ -224,8 +528,14 @@ static int tls_exchange_data(void)
         
         /* Print first 256 bytes of response */
         if (len > 256) len = 256;
+#if defined(MBEDTLS_SSL_ZERO_COPY)
+        /* The record is not NUL-terminated, print it in place */
+        printf("Response:\n%.*s\n", (int)len, (const char *)in);
+        mbedtls_ssl_read_consume(&ssl, ret);
+#else
         buf[len] = '\0';
         printf("Response:\n%s\n", buf);
+#endif
         break; /* Just read first chunk for demo */
         
     } while (1);
@@ -233,6 +543,88 @@ static int tls_exchange_data(void)
     return 0;
 }
 
+/**
+ * @brief Connect, send a report and wait for the first byte of the reply
+ * @param report Report payload
+ * @param len Length of @p report
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int tls_report_exchange(const uint8_t *report, size_t len)
+{
+    unsigned char reply[256];
+    uint32_t start = board_timing_cycles();
+    size_t sent = 0;
+    int ret;
+    
+    if (tls_connect() != 0) {
+        return -1;
+    }
+    
+#if defined(MBEDTLS_SSL_EARLY_DATA)
+    /* Leaves right behind the ClientHello if the ticket allows early data */
+    while (tls_early_data && sent < len) {
+        ret = mbedtls_ssl_write_early_data(&ssl, report + sent, len - sent);
+        if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            continue;
+        }
+        if (ret == MBEDTLS_ERR_SSL_CANNOT_WRITE_EARLY_DATA) {
+            /* No suitable ticket or its limit reached, the rest waits */
+            break;
+        }
+        if (ret < 0) {
+            printf("ERROR: mbedtls_ssl_write_early_data returned -0x%04X\n", -ret);
+            return -1;
+        }
+        sent += (size_t)ret;
+    }
+#endif
+    
+    if (tls_handshake() != 0) {
+        return -1;
+    }
+    
+#if defined(MBEDTLS_SSL_EARLY_DATA)
+    if (sent > 0) {
+        if (mbedtls_ssl_get_early_data_status(&ssl) == MBEDTLS_SSL_EARLY_DATA_STATUS_ACCEPTED) {
+            early_data_accepted++;
+        } else {
+            /* The server dropped it unread, send it again */
+            early_data_rejected++;
+            sent = 0;
+        }
+    }
+#endif
+    
+    while (sent < len) {
+        ret = mbedtls_ssl_write(&ssl, report + sent, len - sent);
+        if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            continue;
+        }
+        if (ret < 0) {
+            printf("ERROR: mbedtls_ssl_write returned -0x%04X\n", -ret);
+            return -1;
+        }
+        sent += (size_t)ret;
+    }
+    
+    /* The ticket for the next wake may come before the reply */
+    do {
+        ret = mbedtls_ssl_read(&ssl, reply, sizeof(reply));
+        if (ret == MBEDTLS_ERR_SSL_RECEIVED_NEW_SESSION_TICKET) {
+            tls_keep_session();
+            ret = MBEDTLS_ERR_SSL_WANT_READ;
+        }
+    } while (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+    
+    if (ret <= 0) {
+        printf("ERROR: No reply to the report (-0x%04X)\n", (unsigned int)-ret);
+        return -1;
+    }
+    
+    last_reply_cycles = board_timing_cycles() - start;
+    return 0;
+}
+
 /**
  * @brief Cleanup TLS connection
  */
@@ -241,6 +633,7 @@ static void tls_cleanup(void)
     printf("Cleaning up TLS connection...\n");
     
     mbedtls_ssl_close_notify(&ssl);
+    se05x_verify_cache_flush();
     mbedtls_net_free(&server_fd);
     mbedtls_ssl_free(&ssl);
     mbedtls_ssl_config_free(&conf);
@@ -250,6 +643,760 @@ static void tls_cleanup(void)
     printf("TLS connection cleaned up\n");
 }
 
+/**
+ * @brief Create the TLS key in SE05x and register it for verification, once
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int tls_prepare_key(void)
+{
+    static int key_ready;
+    
+    if (key_ready) {
+        return 0;
+    }
+    
+    /* Create TLS key in SE05x */
+    if (se05x_create_tls_key(TLS_KEY_ID) != 0) {
+        printf("ERROR: Failed to create TLS key\n");
+        return -1;
+    }
+    
+    /* Keep verifications against our own key on the SE, everything else on the host */
+    if (se05x_verify_register_key(&g_tls_key) != 0) {
+        printf("ERROR: Failed to register TLS key for verification\n");
+        return -1;
+    }
+    
+    /* Without it every boot starts with a full handshake */
+    if (se05x_session_setup() != 0) {
+        printf("WARNING: Session persistence unavailable\n");
+        session_persist = 0;
+    }
+    
+    key_ready = 1;
+    return 0;
+}
+
+/**
+ * @brief Background work between connections: refill the ECDHE key pool
+ * @retval 1 if a key was generated, 0 if there is nothing to do, negative on error
+ */
+int tls_client_idle(void)
+{
+    int ret;
+    const char *pers = "ecdhe_pool";
+    
+    if (!pool_rng_ready) {
+        mbedtls_entropy_init(&pool_entropy);
+        mbedtls_ctr_drbg_init(&pool_ctr_drbg);
+        if ((ret = mbedtls_ctr_drbg_seed(&pool_ctr_drbg, mbedtls_entropy_func, &pool_entropy,
+                                        (const unsigned char *) pers,
+                                        strlen(pers))) != 0) {
+            printf("ERROR: mbedtls_ctr_drbg_seed returned -0x%04X\n", -ret);
+            mbedtls_ctr_drbg_free(&pool_ctr_drbg);
+            mbedtls_entropy_free(&pool_entropy);
+            return -1;
+        }
+        pool_rng_ready = 1;
+    }
+    
+    /* One key per call keeps the idle loop responsive */
+    return se05x_ecdh_pool_refill(mbedtls_ctr_drbg_random, &pool_ctr_drbg);
+}
+
+/**
+ * @brief Compare full handshake time with everything on the host, only the
+ *        client signature on the SE05x, and ECDHE on the SE05x as well
+ * @param iterations Number of handshakes per configuration
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note The signature only goes to the SE05x if the server requests a client
+ *       certificate.
+ */
+int tls_client_bench(uint32_t iterations)
+{
+    size_t i;
+    uint32_t n;
+    uint32_t total;
+    int persist;
+    int ret = 0;
+    
+    if (iterations == 0 || tls_prepare_key() != 0) {
+        return -1;
+    }
+    
+    /* Measure inline ECDHE, not the key pool, and full handshakes */
+    se05x_ecdh_pool_set_depth(0);
+    persist = session_persist;
+    session_persist = 0;
+    
+    for (i = 0; i < sizeof(bench_configs) / sizeof(bench_configs[0]) && ret == 0; i++) {
+        const tls_bench_config_t *cfg = &bench_configs[i];
+        
+        se05x_ecdh_set_mode(cfg->ecdh_mode);
+        se05x_verify_set_route(cfg->verify_route);
+        total = 0;
+        
+        for (n = 0; n < iterations; n++) {
+            if (tls_init() != 0 || tls_configure(cfg->sign_on_se) != 0 ||
+                tls_connect() != 0 || tls_handshake() != 0) {
+                printf("ERROR: Handshake benchmark (%s) failed\n", cfg->name);
+                ret = -1;
+                tls_cleanup();
+                break;
+            }
+            total += last_handshake_cycles;
+            tls_cleanup();
+        }
+        
+        if (ret == 0) {
+            printf("Handshake benchmark (%s): %lu us average over %lu handshakes\n",
+                   cfg->name,
+                   (unsigned long)board_timing_cycles_to_us(total / iterations),
+                   (unsigned long)iterations);
+        }
+    }
+    
+    se05x_ecdh_set_mode(SE05X_ECDH_MODE_AUTO);
+    se05x_verify_set_route(SE05X_VERIFY_ROUTE_AUTO);
+    se05x_ecdh_pool_set_depth(SE05X_ECDH_POOL_DEPTH);
+    session_persist = persist;
+    return ret;
+}
+
+/**
+ * @brief Compare reconnect handshake time to the same server with and
+ *        without the verified-chain cache
+ * @param iterations Number of reconnects per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_bench_reconnect(uint32_t iterations)
+{
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+    static const char *const mode_name[] = { "no chain cache", "chain cache" };
+    uint32_t n;
+    uint32_t total;
+    int persist;
+    int mode;
+    int ret = 0;
+    
+    if (iterations == 0 || tls_prepare_key() != 0) {
+        return -1;
+    }
+    
+    /* Measure full handshakes, not resumptions */
+    persist = session_persist;
+    session_persist = 0;
+    
+    for (mode = 0; mode <= 1 && ret == 0; mode++) {
+        chain_cache_enabled = mode;
+        total = 0;
+        
+        /* The first connection fills the cache and is not counted */
+        for (n = 0; n <= iterations; n++) {
+            if (tls_init() != 0 || tls_configure(1) != 0 ||
+                tls_connect() != 0 || tls_handshake() != 0) {
+                printf("ERROR: Reconnect benchmark (%s) failed\n", mode_name[mode]);
+                ret = -1;
+                tls_cleanup();
+                break;
+            }
+            if (n > 0) {
+                total += last_handshake_cycles;
+            }
+            tls_cleanup();
+        }
+        
+        if (ret == 0) {
+            printf("Reconnect benchmark (%s): %lu us average over %lu handshakes\n",
+                   mode_name[mode],
+                   (unsigned long)board_timing_cycles_to_us(total / iterations),
+                   (unsigned long)iterations);
+        }
+    }
+    
+    chain_cache_enabled = 1;
+    session_persist = persist;
+    return ret;
+#else
+    (void)iterations;
+    printf("WARNING: Reconnect benchmark needs MBEDTLS_X509_CRT_VERIFY_CACHE\n");
+    return -1;
+#endif
+}
+
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+/**
+ * @brief Open one more connection to the server on the shared configuration
+ * @param bench_ssl Initialized SSL context
+ * @param bench_fd Initialized network context
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int tls_bench_open(mbedtls_ssl_context *bench_ssl, mbedtls_net_context *bench_fd)
+{
+    int ret;
+    
+    if ((ret = mbedtls_ssl_setup(bench_ssl, &conf)) != 0 ||
+        (ret = mbedtls_ssl_set_hostname(bench_ssl, SERVER_NAME)) != 0 ||
+        (ret = mbedtls_net_connect(bench_fd, SERVER_NAME, SERVER_PORT,
+                                   MBEDTLS_NET_PROTO_TCP)) != 0) {
+        printf("ERROR: Opening connection failed (-0x%04X)\n", -ret);
+        return -1;
+    }
+    mbedtls_ssl_set_bio(bench_ssl, bench_fd, mbedtls_net_send, mbedtls_net_recv, NULL);
+    
+    while ((ret = mbedtls_ssl_handshake(bench_ssl)) != 0) {
+        if (ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+            se05x_async_poll();
+            continue;
+        }
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            printf("ERROR: mbedtls_ssl_handshake returned -0x%04X\n", -ret);
+            return -1;
+        }
+    }
+    return 0;
+}
+#endif
+
+/**
+ * @brief Report memory per connection with 1, 4 and 8 simultaneous idle
+ *        connections to the server, after their handshakes
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note Heap figures need MBEDTLS_MEMORY_DEBUG. With MBEDTLS_SSL_BUFFER_POOL
+ *       record buffers are counted in the pool, not the heap.
+ */
+int tls_client_bench_memory(void)
+{
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+    static const uint32_t counts[] = { 1, 4, TLS_BENCH_MAX_CONNECTIONS };
+    static mbedtls_ssl_context bench_ssl[TLS_BENCH_MAX_CONNECTIONS];
+    static mbedtls_net_context bench_fd[TLS_BENCH_MAX_CONNECTIONS];
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    record_pool_stats_t pool_stats;
+#endif
+    size_t cur_used, cur_blocks;
+    size_t max_used, max_blocks;
+    size_t i;
+    uint32_t n;
+    uint32_t opened;
+    int ret = 0;
+    
+    if (tls_prepare_key() != 0) {
+        return -1;
+    }
+    
+    for (i = 0; i < sizeof(counts) / sizeof(counts[0]) && ret == 0; i++) {
+        /* One shared configuration, the default context is not used */
+        if (tls_init() != 0 || tls_configure(0) != 0) {
+            tls_cleanup();
+            return -1;
+        }
+        mbedtls_ssl_free(&ssl);
+        mbedtls_memory_buffer_alloc_max_reset();
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+        record_pool_reset_stats();
+#endif
+        
+        for (opened = 0; opened < counts[i]; opened++) {
+            mbedtls_ssl_init(&bench_ssl[opened]);
+            mbedtls_net_init(&bench_fd[opened]);
+            if ((ret = tls_bench_open(&bench_ssl[opened], &bench_fd[opened])) != 0) {
+                printf("ERROR: Memory benchmark failed at connection %lu of %lu\n",
+                       (unsigned long)(opened + 1), (unsigned long)counts[i]);
+                opened++;
+                break;
+            }
+        }
+        
+        if (ret == 0) {
+            mbedtls_memory_buffer_alloc_cur_get(&cur_used, &cur_blocks);
+            mbedtls_memory_buffer_alloc_max_get(&max_used, &max_blocks);
+            printf("Connections (%lu): heap %lu bytes in use, peak %lu bytes, per connection %lu / %lu bytes\n",
+                   (unsigned long)counts[i],
+                   (unsigned long)cur_used, (unsigned long)max_used,
+                   (unsigned long)(cur_used / counts[i]),
+                   (unsigned long)(max_used / counts[i]));
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+            record_pool_get_stats(&pool_stats);
+            printf("Connections (%lu): record pool %lu bytes in use, peak %lu of %lu bytes, %lu exhausted\n",
+                   (unsigned long)counts[i],
+                   (unsigned long)pool_stats.bytes_in_use,
+                   (unsigned long)pool_stats.peak_bytes,
+                   (unsigned long)RECORD_POOL_BYTES,
+                   (unsigned long)pool_stats.exhausted);
+#endif
+        }
+        
+        for (n = 0; n < opened; n++) {
+            mbedtls_ssl_close_notify(&bench_ssl[n]);
+            mbedtls_net_free(&bench_fd[n]);
+            mbedtls_ssl_free(&bench_ssl[n]);
+        }
+        tls_cleanup();
+    }
+    
+    return ret == 0 ? 0 : -1;
+#else
+    printf("WARNING: Memory benchmark needs MBEDTLS_MEMORY_DEBUG\n");
+    return -1;
+#endif
+}
+
+/**
+ * @brief Handshake many connections to the server at once from one event
+ *        loop and report handshakes per second and memory per connection
+ * @param connections Number of connections, at most TLS_LOOP_MAX_CONNECTIONS
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note Heap figures need MBEDTLS_MEMORY_DEBUG. With MBEDTLS_SSL_BUFFER_POOL
+ *       every handshake in flight holds two record slots. A connection that
+ *       finds the pool empty waits in the queue, unconnected, until a
+ *       handshake finishes and gives its slots back.
+ */
+int tls_client_bench_loop(uint32_t connections)
+{
+    static mbedtls_ssl_context bench_ssl[TLS_LOOP_MAX_CONNECTIONS];
+    static mbedtls_net_context bench_fd[TLS_LOOP_MAX_CONNECTIONS];
+    static tls_loop_t loop;
+    tls_loop_stats_t stats;
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+    size_t cur_used, cur_blocks;
+    size_t max_used, max_blocks;
+#endif
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    record_pool_stats_t pool_stats;
+#endif
+    uint32_t opened;
+    uint32_t admitted = 0;
+    uint32_t queued = 0;
+    uint32_t start;
+    uint32_t us;
+    uint32_t n;
+    int waiting = 0;
+    int active = 0;
+    int ret = 0;
+    
+    if (connections == 0 || connections > TLS_LOOP_MAX_CONNECTIONS ||
+        tls_prepare_key() != 0) {
+        return -1;
+    }
+    
+    /* One shared configuration, the default context is not used */
+    if (tls_init() != 0 || tls_configure(0) != 0 || tls_loop_init(&loop) != 0) {
+        tls_cleanup();
+        return -1;
+    }
+    mbedtls_ssl_free(&ssl);
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+    mbedtls_memory_buffer_alloc_max_reset();
+#endif
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    record_pool_reset_stats();
+#endif
+    
+    for (opened = 0; opened < connections; opened++) {
+        mbedtls_ssl_init(&bench_ssl[opened]);
+        mbedtls_net_init(&bench_fd[opened]);
+    }
+    
+    /* Connect as many as the record pool admits so that the handshakes
+     * overlap, the rest are admitted as handshakes finish */
+    start = board_timing_cycles();
+    while (ret == 0) {
+        while (admitted < connections) {
+            /* A failed setup leaves the context as initialised */
+            ret = mbedtls_ssl_setup(&bench_ssl[admitted], &conf);
+            if (ret == MBEDTLS_ERR_SSL_ALLOC_FAILED && active > 0) {
+                /* Wait for a handshake in flight to release its slots */
+                if (!waiting) {
+                    queued++;
+                    waiting = 1;
+                }
+                ret = 0;
+                break;
+            }
+            if (ret != 0 ||
+                (ret = mbedtls_ssl_set_hostname(&bench_ssl[admitted], SERVER_NAME)) != 0 ||
+                (ret = mbedtls_net_connect(&bench_fd[admitted], SERVER_NAME, SERVER_PORT,
+                                           MBEDTLS_NET_PROTO_TCP)) != 0) {
+                printf("ERROR: Opening connection %lu failed (-0x%04X)\n",
+                       (unsigned long)(admitted + 1), -ret);
+                break;
+            }
+            mbedtls_ssl_set_bio(&bench_ssl[admitted], &bench_fd[admitted],
+                                mbedtls_net_send, mbedtls_net_recv, NULL);
+            if (tls_loop_add(&loop, &bench_ssl[admitted], &bench_fd[admitted], NULL, NULL) < 0) {
+                printf("ERROR: tls_loop_add failed at connection %lu\n",
+                       (unsigned long)(admitted + 1));
+                ret = -1;
+                break;
+            }
+            admitted++;
+            active++;
+            waiting = 0;
+        }
+        if (ret != 0 || (active = tls_loop_run_once(&loop, 100)) < 0) {
+            break;
+        }
+        if (active == 0 && admitted == connections) {
+            break;
+        }
+    }
+    if (ret == 0 && active < 0) {
+        printf("ERROR: tls_loop_run_once failed\n");
+        ret = -1;
+    }
+    us = board_timing_cycles_to_us(board_timing_cycles() - start);
+    
+    tls_loop_get_stats(&loop, &stats);
+    if (ret == 0) {
+        if (us == 0) {
+            us = 1;
+        }
+        printf("Event loop (%lu connections): %lu handshakes, %lu failed, %lu queued, "
+               "%lu handshakes/s, %lu us average, %lu waits, %lu steps\n",
+               (unsigned long)connections,
+               (unsigned long)stats.handshakes, (unsigned long)stats.failures,
+               (unsigned long)queued,
+               (unsigned long)(((uint64_t)stats.handshakes * 1000000U) / us),
+               (unsigned long)(stats.handshakes != 0 ?
+                               board_timing_cycles_to_us(stats.handshake_cycles / stats.handshakes) : 0),
+               (unsigned long)stats.waits, (unsigned long)stats.steps);
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+        mbedtls_memory_buffer_alloc_cur_get(&cur_used, &cur_blocks);
+        mbedtls_memory_buffer_alloc_max_get(&max_used, &max_blocks);
+        printf("Event loop (%lu connections): heap per connection %lu bytes, peak %lu bytes\n",
+               (unsigned long)connections,
+               (unsigned long)(cur_used / connections),
+               (unsigned long)(max_used / connections));
+#endif
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+        record_pool_get_stats(&pool_stats);
+        printf("Event loop (%lu connections): record pool peak %lu of %lu bytes, %lu exhausted\n",
+               (unsigned long)connections,
+               (unsigned long)pool_stats.peak_bytes,
+               (unsigned long)RECORD_POOL_BYTES,
+               (unsigned long)pool_stats.exhausted);
+#endif
+        if (stats.failures != 0) {
+            ret = -1;
+        }
+    }
+    
+    tls_loop_free(&loop);
+    for (n = 0; n < opened; n++) {
+        mbedtls_ssl_close_notify(&bench_ssl[n]);
+        mbedtls_net_free(&bench_fd[n]);
+        mbedtls_ssl_free(&bench_ssl[n]);
+    }
+    tls_cleanup();
+    
+    return ret == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Compare the first connection after a reset with and without the
+ *        session stored in the SE05x
+ * @param iterations Number of simulated resets per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_bench_reboot(uint32_t iterations)
+{
+    static const char *const mode_name[] = { "no stored session", "stored session" };
+    se05x_session_stats_t stats;
+    uint32_t start;
+    uint32_t n;
+    uint32_t total;
+    int persist;
+    int mode;
+    int ret = 0;
+    
+    if (iterations == 0 || tls_prepare_key() != 0) {
+        return -1;
+    }
+    
+    /* Without a sealing key there is nothing to compare */
+    persist = session_persist;
+    if (!persist) {
+        return -1;
+    }
+    /* Nothing computed before a reset survives it but the SE05x content */
+    se05x_ecdh_pool_set_depth(0);
+    
+    for (mode = 0; mode <= 1 && ret == 0; mode++) {
+        session_persist = mode;
+        total = 0;
+        se05x_session_reset_stats();
+        
+        /* The first connection stores the session and is not counted */
+        for (n = 0; n <= iterations; n++) {
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+            chain_cache_free();
+#endif
+            if (mode == 1 && n == 0) {
+                se05x_session_erase(SE05X_SESSION_SLOT_TLS);
+            }
+            start = board_timing_cycles();
+            if (tls_init() != 0 || tls_configure(1) != 0 ||
+                tls_connect() != 0 || tls_handshake() != 0) {
+                printf("ERROR: Reboot benchmark (%s) failed\n", mode_name[mode]);
+                ret = -1;
+                tls_cleanup();
+                break;
+            }
+            if (n > 0) {
+                total += board_timing_cycles() - start;
+            } else if (mbedtls_ssl_get_version_number(&ssl) == MBEDTLS_SSL_VERSION_TLS1_3 &&
+                       tls_exchange_data() != 0) {
+                /* A TLS 1.3 session is stored once its ticket arrives */
+                printf("ERROR: Reboot benchmark (%s) failed\n", mode_name[mode]);
+                ret = -1;
+                tls_cleanup();
+                break;
+            }
+            tls_cleanup();
+        }
+        
+        if (ret == 0) {
+            se05x_session_get_stats(&stats);
+            printf("Reboot benchmark (%s): %lu us to a connected session average over %lu "
+                   "resets, session restore %lu us, %lu stored / %lu unchanged / "
+                   "%lu fresh\n",
+                   mode_name[mode],
+                   (unsigned long)board_timing_cycles_to_us(total / iterations),
+                   (unsigned long)iterations,
+                   (unsigned long)(stats.loaded ?
+                       board_timing_cycles_to_us(stats.load_cycles / stats.loaded) : 0),
+                   (unsigned long)stats.saved,
+                   (unsigned long)stats.unchanged,
+                   (unsigned long)stats.fresh);
+        }
+    }
+    
+    session_persist = persist;
+    se05x_ecdh_pool_set_depth(SE05X_ECDH_POOL_DEPTH);
+    return ret;
+}
+
+/**
+ * @brief Compare handshake latency and peak heap of a full TLS 1.2
+ *        handshake, a full TLS 1.3 handshake and a TLS 1.3 PSK-DHE
+ *        resumption from a session ticket
+ * @param iterations Number of handshakes per mode
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note The SE05x signature count is only non-zero if the server requests a
+ *       client certificate; a resumed TLS 1.3 handshake never signs. Heap
+ *       figures need MBEDTLS_MEMORY_DEBUG.
+ */
+int tls_client_bench_tls13(uint32_t iterations)
+{
+#if defined(MBEDTLS_SSL_PROTO_TLS1_3) && defined(MBEDTLS_SSL_SESSION_TICKETS)
+    static const struct {
+        const char *name;
+        mbedtls_ssl_protocol_version version;
+        int resume;
+    } modes[] = {
+        { "TLS 1.2 full",    MBEDTLS_SSL_VERSION_TLS1_2, 0 },
+        { "TLS 1.3 1-RTT",   MBEDTLS_SSL_VERSION_TLS1_3, 0 },
+        { "TLS 1.3 resumed", MBEDTLS_SSL_VERSION_TLS1_3, 1 },
+    };
+    se05x_async_stats_t before;
+    se05x_async_stats_t after;
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+    size_t max_used, max_blocks;
+#endif
+    size_t i;
+    uint32_t n;
+    uint32_t total;
+    int persist;
+    int ret = 0;
+    
+    if (iterations == 0 || tls_prepare_key() != 0) {
+        return -1;
+    }
+    
+    /* Resume from RAM, restoring from the SE05x is measured separately */
+    persist = session_persist;
+    session_persist = 0;
+    
+    for (i = 0; i < sizeof(modes) / sizeof(modes[0]) && ret == 0; i++) {
+        tls_version = modes[i].version;
+        bench_session_keep = modes[i].resume;
+        bench_session_valid = 0;
+        total = 0;
+        
+        /* The first connection fetches the ticket and is not counted */
+        for (n = 0; n <= iterations; n++) {
+            if (tls_init() != 0 || tls_configure(1) != 0 ||
+                tls_connect() != 0 || tls_handshake() != 0 ||
+                (modes[i].resume && tls_exchange_data() != 0)) {
+                printf("ERROR: TLS 1.3 benchmark (%s) failed\n", modes[i].name);
+                ret = -1;
+                tls_cleanup();
+                break;
+            }
+            if (n > 0) {
+                total += last_handshake_cycles;
+            }
+            tls_cleanup();
+            
+            if (n == 0) {
+                se05x_async_get_stats(&before);
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+                mbedtls_memory_buffer_alloc_max_reset();
+#endif
+            }
+        }
+        
+        if (ret == 0) {
+            se05x_async_get_stats(&after);
+            printf("TLS 1.3 benchmark (%s): %lu us average over %lu handshakes, "
+                   "%lu SE05x signatures\n",
+                   modes[i].name,
+                   (unsigned long)board_timing_cycles_to_us(total / iterations),
+                   (unsigned long)iterations,
+                   (unsigned long)(after.started - before.started));
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+            mbedtls_memory_buffer_alloc_max_get(&max_used, &max_blocks);
+            printf("TLS 1.3 benchmark (%s): peak heap %lu bytes in %lu blocks\n",
+                   modes[i].name, (unsigned long)max_used, (unsigned long)max_blocks);
+#endif
+        }
+    }
+    
+    mbedtls_ssl_session_free(&bench_session);
+    bench_session_keep = 0;
+    bench_session_valid = 0;
+    tls_version = MBEDTLS_SSL_VERSION_UNKNOWN;
+    session_persist = persist;
+    return ret;
+#else
+    (void)iterations;
+    printf("WARNING: TLS 1.3 benchmark needs MBEDTLS_SSL_PROTO_TLS1_3 and "
+           "MBEDTLS_SSL_SESSION_TICKETS\n");
+    return -1;
+#endif
+}
+
+/**
+ * @brief Wake-and-report: send one report over a resumed session, as early
+ *        data if it is replay-safe
+ * @param report Report payload
+ * @param len Length of @p report
+ * @param early Whether @p report may be sent as early data
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_report(const uint8_t *report, size_t len, tls_early_data_t early)
+{
+    int ret = 0;
+    
+    if (tls_prepare_key() != 0) {
+        return -1;
+    }
+    
+    tls_early_data = early == TLS_EARLY_DATA_REPLAY_SAFE;
+    if (tls_init() != 0 || tls_configure(1) != 0 || tls_report_exchange(report, len) != 0) {
+        printf("ERROR: Report failed\n");
+        ret = -1;
+    }
+    tls_cleanup();
+    tls_early_data = 0;
+    
+    return ret;
+}
+
+/**
+ * @brief Compare the time from connect to the first reply byte with the
+ *        request in TLS 1.3 early data, after a TLS 1.3 resumption and after
+ *        a TLS 1.2 resumption
+ * @param iterations Number of reports per mode
+ * @retval 0 if successful, non-zero otherwise
+ *
+ * @note The server must accept early data, otherwise the first mode falls
+ *       back to sending the request after the handshake.
+ */
+int tls_client_bench_early_data(uint32_t iterations)
+{
+#if defined(MBEDTLS_SSL_EARLY_DATA)
+    static const struct {
+        const char *name;
+        mbedtls_ssl_protocol_version version;
+        int early;
+    } modes[] = {
+        { "TLS 1.3 0-RTT",         MBEDTLS_SSL_VERSION_TLS1_3, 1 },
+        { "TLS 1.3 1-RTT resumed", MBEDTLS_SSL_VERSION_TLS1_3, 0 },
+        { "TLS 1.2 resumed",       MBEDTLS_SSL_VERSION_TLS1_2, 0 },
+    };
+    /* A GET is idempotent, replaying it is harmless */
+    static const char request[] = "GET / HTTP/1.1\r\n"
+                                  "Host: " SERVER_NAME "\r\n"
+                                  "\r\n";
+    size_t i;
+    uint32_t n;
+    uint32_t total;
+    int persist;
+    int ret = 0;
+    
+    if (iterations == 0 || tls_prepare_key() != 0) {
+        return -1;
+    }
+    
+    /* Resume from RAM, restoring from the SE05x is measured separately */
+    persist = session_persist;
+    session_persist = 0;
+    bench_session_keep = 1;
+    
+    for (i = 0; i < sizeof(modes) / sizeof(modes[0]) && ret == 0; i++) {
+        tls_version = modes[i].version;
+        tls_early_data = modes[i].early;
+        bench_session_valid = 0;
+        early_data_accepted = 0;
+        early_data_rejected = 0;
+        total = 0;
+        
+        /* The first connection fetches the ticket and is not counted */
+        for (n = 0; n <= iterations; n++) {
+            if (tls_init() != 0 || tls_configure(1) != 0 ||
+                tls_report_exchange((const uint8_t *)request, sizeof(request) - 1) != 0) {
+                printf("ERROR: Early data benchmark (%s) failed\n", modes[i].name);
+                ret = -1;
+                tls_cleanup();
+                break;
+            }
+            if (n > 0) {
+                total += last_reply_cycles;
+            }
+            tls_cleanup();
+        }
+        
+        if (ret == 0) {
+            printf("Early data benchmark (%s): %lu us to the first reply byte average over "
+                   "%lu resumptions, early data %lu accepted / %lu rejected\n",
+                   modes[i].name,
+                   (unsigned long)board_timing_cycles_to_us(total / iterations),
+                   (unsigned long)iterations,
+                   (unsigned long)early_data_accepted,
+                   (unsigned long)early_data_rejected);
+        }
+    }
+    
+    mbedtls_ssl_session_free(&bench_session);
+    bench_session_keep = 0;
+    bench_session_valid = 0;
+    tls_early_data = 0;
+    tls_version = MBEDTLS_SSL_VERSION_UNKNOWN;
+    session_persist = persist;
+    return ret;
+#else
+    (void)iterations;
+    printf("WARNING: Early data benchmark needs MBEDTLS_SSL_EARLY_DATA\n");
+    return -1;
+#endif
+}
+
 /**
  * @brief Run TLS client example
  * @retval 0 if successful, non-zero otherwise
@@ -278,8 +1425,7 @@ int tls_client_run(void)
     int ret;
     
     /* Create TLS key in SE05x */
-    if (se05x_create_tls_key(TLS_KEY_ID) != 0) {
-        printf("ERROR: Failed to create TLS key\n");
+    if (tls_prepare_key() != 0) {
         return -1;
     }
     
@@ -290,7 +1436,7 @@ int tls_client_run(void)
     }
     
     /* Configure mbed TLS */
-    if (tls_configure() != 0) {
+    if (tls_configure(1) != 0) {
         printf("ERROR: Failed to configure mbed TLS\n");
         tls_cleanup();
         return -1;
@@ -7,6 +7,21 @@
 #define TLS_CLIENT_H
 
 #include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Whether a report may be sent as TLS 1.3 early data (0-RTT)
+ *
+ * Early data leaves with the ClientHello, before the server has proven it is
+ * live, so a captured first flight can be replayed to the server. Only
+ * reports whose repetition is harmless, e.g. readings carrying their own
+ * sequence number or timestamp, should be marked replay-safe; commands and
+ * anything that changes server state should wait for the handshake.
+ */
+typedef enum {
+    TLS_EARLY_DATA_NEVER = 0,
+    TLS_EARLY_DATA_REPLAY_SAFE,
+} tls_early_data_t;
 
 /**
  * @brief Run TLS client example
@@ -14,4 +29,90 @@
  */
 int tls_client_run(void);
 
+/**
+ * @brief Background work between connections: refill the ECDHE key pool
+ *
+ * Call from the idle loop so the next (re)connect finds a ready ephemeral key.
+ *
+ * @retval 1 if a key was generated, 0 if there is nothing to do, negative on error
+ */
+int tls_client_idle(void);
+
+/**
+ * @brief Compare full handshake time with everything on the host, only the
+ *        client signature on the SE05x, and ECDHE on the SE05x as well
+ * @param iterations Number of handshakes per configuration
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_bench(uint32_t iterations);
+
+/**
+ * @brief Compare reconnect handshake time to the same server with and
+ *        without the verified-chain cache
+ * @param iterations Number of reconnects per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_bench_reconnect(uint32_t iterations);
+
+/**
+ * @brief Report memory per connection with 1, 4 and 8 simultaneous idle
+ *        connections to the server, after their handshakes
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_bench_memory(void);
+
+/**
+ * @brief Handshake many connections to the server at once from one event
+ *        loop and report handshakes per second and memory per connection
+ * @param connections Number of connections, at most TLS_LOOP_MAX_CONNECTIONS
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_bench_loop(uint32_t connections);
+
+/**
+ * @brief Compare the time to a connected session after a reset with a full
+ *        handshake and with the session restored from the SE05x
+ *
+ * A reset is simulated by dropping every RAM cache (verified chains, peer
+ * keys, ECDHE key pool) between connections; only SE05x content is kept.
+ *
+ * @param iterations Number of simulated resets per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_bench_reboot(uint32_t iterations);
+
+/**
+ * @brief Compare handshake latency, SE05x signatures and peak heap of a full
+ *        TLS 1.2 handshake, a full TLS 1.3 handshake and a TLS 1.3
+ *        resumption from a session ticket (PSK with ECDHE)
+ * @param iterations Number of handshakes per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_bench_tls13(uint32_t iterations);
+
+/**
+ * @brief Wake-and-report: connect, send one report, wait for the first byte
+ *        of the reply and close
+ *
+ * The session stored in the SE05x is resumed, and a replay-safe report is
+ * sent as early data if its ticket allows it. If the server rejects the
+ * early data, the report is sent again after the handshake. The ticket for
+ * the next wake is stored in the SE05x.
+ *
+ * @param report Report payload
+ * @param len Length of @p report
+ * @param early Whether @p report may be sent as early data
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_report(const uint8_t *report, size_t len, tls_early_data_t early);
+
+/**
+ * @brief Compare the time from connect to the first reply byte for a
+ *        TLS 1.3 resumption with the request in early data, a TLS 1.3
+ *        resumption without it and a TLS 1.2 resumption
+ * @param iterations Number of reports per mode
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_client_bench_early_data(uint32_t iterations);
+
 #endif /* TLS_CLIENT_H */
\ No newline at end of file
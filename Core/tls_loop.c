@@ -0,0 +1,387 @@
+/**
+ * @file tls_loop.c
+ * @brief Event loop driving many non-blocking TLS connections from one thread
+ *
+ * A connection is stepped only when the loop has a reason to expect progress:
+ * its socket is ready for what mbedTLS last asked for, the SE05x queue has
+ * just run, or decrypted data is still pending in its context.
+ */
+
+#include "tls_loop.h"
+#include "se05x_async.h"
+#include "board_timing.h"
+#include <string.h>
+
+#if defined(MBEDTLS_NET_C)
+
+#if TLS_LOOP_BACKEND == TLS_LOOP_BACKEND_EPOLL
+#include <sys/epoll.h>
+#include <errno.h>
+#include <unistd.h>
+#else
+#include <sys/select.h>
+#include <sys/time.h>
+#endif
+
+/**
+ * @brief Tell the readiness backend what a connection now waits for
+ * @param loop Event loop
+ * @param index Connection index
+ * @param want MBEDTLS_NET_POLL_READ and/or MBEDTLS_NET_POLL_WRITE, 0 for nothing
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int tls_loop_watch(tls_loop_t *loop, int index, uint8_t want)
+{
+    tls_loop_conn_t *c = &loop->conns[index];
+#if TLS_LOOP_BACKEND == TLS_LOOP_BACKEND_EPOLL
+    struct epoll_event ev;
+
+    if (want == c->want) {
+        return 0;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.data.u32 = (uint32_t)index;
+    if (want & MBEDTLS_NET_POLL_READ) {
+        ev.events |= EPOLLIN;
+    }
+    if (want & MBEDTLS_NET_POLL_WRITE) {
+        ev.events |= EPOLLOUT;
+    }
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_MOD, c->net->fd, &ev) != 0) {
+        return -1;
+    }
+#else
+    (void)loop;
+#endif
+    c->want = want;
+    return 0;
+}
+
+/**
+ * @brief Step one connection: its handshake, then its callback
+ * @param loop Event loop
+ * @param index Connection index
+ */
+static void tls_loop_step(tls_loop_t *loop, int index)
+{
+    tls_loop_conn_t *c = &loop->conns[index];
+    uint8_t want = 0;
+    int ret;
+
+    c->ready = 0;
+    c->async = 0;
+    loop->stats.steps++;
+
+    if (c->state == TLS_LOOP_HANDSHAKE) {
+        ret = mbedtls_ssl_handshake(c->ssl);
+        if (ret == 0) {
+            c->handshake_cycles = board_timing_cycles() - c->start;
+            loop->stats.handshakes++;
+            loop->stats.handshake_cycles += c->handshake_cycles;
+            c->state = TLS_LOOP_OPEN;
+            if (c->cb == NULL) {
+                (void)tls_loop_watch(loop, index, 0);
+                return;
+            }
+            /* Let the application write first */
+            ret = c->cb(c->arg, c);
+        }
+    } else {
+        ret = c->cb(c->arg, c);
+    }
+
+    switch (ret) {
+    case MBEDTLS_ERR_SSL_WANT_READ:
+        want = MBEDTLS_NET_POLL_READ;
+        /* A record may already be decrypted, the socket will not tell */
+        if (c->state == TLS_LOOP_OPEN && mbedtls_ssl_check_pending(c->ssl)) {
+            c->ready = 1;
+        }
+        break;
+    case MBEDTLS_ERR_SSL_WANT_WRITE:
+        want = MBEDTLS_NET_POLL_WRITE;
+        break;
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+    case MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS:
+        c->async = 1;
+        break;
+#endif
+    case MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS:
+        /* A restartable operation paused, resume it on the next pass */
+        c->ready = 1;
+        break;
+    case 0:
+        c->state = TLS_LOOP_CLOSED;
+        loop->stats.closed++;
+        break;
+    default:
+        c->result = ret;
+        c->state = TLS_LOOP_FAILED;
+        loop->stats.failures++;
+        break;
+    }
+
+    if (tls_loop_watch(loop, index, want) != 0) {
+        c->result = MBEDTLS_ERR_NET_POLL_FAILED;
+        c->state = TLS_LOOP_FAILED;
+        loop->stats.failures++;
+    }
+}
+
+/**
+ * @brief Wait until a watched socket is ready and mark its connection
+ * @param loop Event loop
+ * @param timeout_ms Longest wait
+ * @retval 0 if successful, non-zero otherwise
+ */
+static int tls_loop_wait(tls_loop_t *loop, uint32_t timeout_ms)
+{
+#if TLS_LOOP_BACKEND == TLS_LOOP_BACKEND_EPOLL
+    struct epoll_event events[TLS_LOOP_MAX_CONNECTIONS < 64 ? TLS_LOOP_MAX_CONNECTIONS : 64];
+    int n;
+    int i;
+
+    n = epoll_wait(loop->epfd, events, (int)(sizeof(events) / sizeof(events[0])),
+                   (int)timeout_ms);
+    if (n < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    for (i = 0; i < n; i++) {
+        loop->conns[events[i].data.u32].ready = 1;
+    }
+#else
+    fd_set read_fds;
+    fd_set write_fds;
+    struct timeval tv;
+    tls_loop_conn_t *c;
+    int max_fd = -1;
+    int i;
+
+    FD_ZERO(&read_fds);
+    FD_ZERO(&write_fds);
+    for (i = 0; i < TLS_LOOP_MAX_CONNECTIONS; i++) {
+        c = &loop->conns[i];
+        if (c->want == 0) {
+            continue;
+        }
+        if (c->net->fd >= FD_SETSIZE) {
+            return -1;
+        }
+        if (c->want & MBEDTLS_NET_POLL_READ) {
+            FD_SET(c->net->fd, &read_fds);
+        }
+        if (c->want & MBEDTLS_NET_POLL_WRITE) {
+            FD_SET(c->net->fd, &write_fds);
+        }
+        if (c->net->fd > max_fd) {
+            max_fd = c->net->fd;
+        }
+    }
+    if (max_fd < 0) {
+        return 0;
+    }
+
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    if (select(max_fd + 1, &read_fds, &write_fds, NULL, &tv) < 0) {
+        return -1;
+    }
+    for (i = 0; i < TLS_LOOP_MAX_CONNECTIONS; i++) {
+        c = &loop->conns[i];
+        if (c->want != 0 &&
+            (FD_ISSET(c->net->fd, &read_fds) || FD_ISSET(c->net->fd, &write_fds))) {
+            c->ready = 1;
+        }
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Set up an empty event loop
+ * @param loop Loop to set up
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_loop_init(tls_loop_t *loop)
+{
+    memset(loop, 0, sizeof(*loop));
+#if TLS_LOOP_BACKEND == TLS_LOOP_BACKEND_EPOLL
+    loop->epfd = epoll_create1(0);
+    if (loop->epfd < 0) {
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Hand a connection to the loop, which starts its handshake
+ * @param loop Event loop
+ * @param ssl Context set up with mbedtls_ssl_setup(), handshake not started
+ * @param net Connected socket
+ * @param cb Application callback, or NULL to leave the connection idle
+ *        after its handshake
+ * @param arg Argument for @p cb
+ * @retval Connection index if successful, negative otherwise
+ */
+int tls_loop_add(tls_loop_t *loop, mbedtls_ssl_context *ssl, mbedtls_net_context *net,
+                 tls_loop_cb_t cb, void *arg)
+{
+    tls_loop_conn_t *c;
+    int i;
+
+    for (i = 0; i < TLS_LOOP_MAX_CONNECTIONS; i++) {
+        if (loop->conns[i].state == TLS_LOOP_FREE) {
+            break;
+        }
+    }
+    if (i == TLS_LOOP_MAX_CONNECTIONS || mbedtls_net_set_nonblock(net) != 0) {
+        return -1;
+    }
+
+#if TLS_LOOP_BACKEND == TLS_LOOP_BACKEND_EPOLL
+    struct epoll_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.data.u32 = (uint32_t)i;
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, net->fd, &ev) != 0) {
+        return -1;
+    }
+#endif
+
+    c = &loop->conns[i];
+    memset(c, 0, sizeof(*c));
+    c->ssl = ssl;
+    c->net = net;
+    c->cb = cb;
+    c->arg = arg;
+    c->state = TLS_LOOP_HANDSHAKE;
+    c->start = board_timing_cycles();
+    /* The ClientHello can go out right away */
+    c->ready = 1;
+    return i;
+}
+
+/**
+ * @brief Wait for ready connections and step them
+ * @param loop Event loop
+ * @param timeout_ms Longest wait for a socket to become ready
+ * @retval Number of connections still handshaking or waiting for their
+ *         callback, negative on error
+ */
+int tls_loop_run_once(tls_loop_t *loop, uint32_t timeout_ms)
+{
+    tls_loop_conn_t *c;
+    int pending = 0;
+    int active = 0;
+    int i;
+
+    /* A signature done on the SE05x may unblock any waiting handshake */
+    if (se05x_async_poll()) {
+        for (i = 0; i < TLS_LOOP_MAX_CONNECTIONS; i++) {
+            if (loop->conns[i].async) {
+                loop->conns[i].ready = 1;
+            }
+        }
+    }
+
+    for (i = 0; i < TLS_LOOP_MAX_CONNECTIONS; i++) {
+        c = &loop->conns[i];
+        if (c->ready || c->async) {
+            pending = 1;
+            break;
+        }
+    }
+
+    /* Only block when no connection can make progress without the network */
+    loop->stats.waits++;
+    if (tls_loop_wait(loop, pending ? 0 : timeout_ms) != 0) {
+        return -1;
+    }
+
+    for (i = 0; i < TLS_LOOP_MAX_CONNECTIONS; i++) {
+        c = &loop->conns[i];
+        if (c->ready && (c->state == TLS_LOOP_HANDSHAKE || c->state == TLS_LOOP_OPEN)) {
+            tls_loop_step(loop, i);
+        }
+        if (c->state == TLS_LOOP_HANDSHAKE ||
+            (c->state == TLS_LOOP_OPEN && (c->want != 0 || c->ready || c->async))) {
+            active++;
+        }
+    }
+
+    return active;
+}
+
+/**
+ * @brief Get a connection by index
+ * @param loop Event loop
+ * @param index Index returned by tls_loop_add()
+ * @retval Connection, or NULL if the index is not in use
+ */
+tls_loop_conn_t *tls_loop_get(tls_loop_t *loop, int index)
+{
+    if (index < 0 || index >= TLS_LOOP_MAX_CONNECTIONS ||
+        loop->conns[index].state == TLS_LOOP_FREE) {
+        return NULL;
+    }
+    return &loop->conns[index];
+}
+
+/**
+ * @brief Take a connection out of the loop
+ * @param loop Event loop
+ * @param index Index returned by tls_loop_add()
+ */
+void tls_loop_remove(tls_loop_t *loop, int index)
+{
+    tls_loop_conn_t *c = tls_loop_get(loop, index);
+
+    if (c == NULL) {
+        return;
+    }
+#if TLS_LOOP_BACKEND == TLS_LOOP_BACKEND_EPOLL
+    epoll_ctl(loop->epfd, EPOLL_CTL_DEL, c->net->fd, NULL);
+#endif
+    memset(c, 0, sizeof(*c));
+}
+
+/**
+ * @brief Take every connection out of the loop and release the loop
+ * @param loop Event loop
+ */
+void tls_loop_free(tls_loop_t *loop)
+{
+    int i;
+
+    for (i = 0; i < TLS_LOOP_MAX_CONNECTIONS; i++) {
+        tls_loop_remove(loop, i);
+    }
+#if TLS_LOOP_BACKEND == TLS_LOOP_BACKEND_EPOLL
+    if (loop->epfd >= 0) {
+        close(loop->epfd);
+        loop->epfd = -1;
+    }
+#endif
+}
+
+/**
+ * @brief Get event loop counters
+ * @param loop Event loop
+ * @param stats Filled with the current counters
+ */
+void tls_loop_get_stats(const tls_loop_t *loop, tls_loop_stats_t *stats)
+{
+    *stats = loop->stats;
+}
+
+/**
+ * @brief Reset event loop counters
+ * @param loop Event loop
+ */
+void tls_loop_reset_stats(tls_loop_t *loop)
+{
+    memset(&loop->stats, 0, sizeof(loop->stats));
+}
+
+#endif /* MBEDTLS_NET_C */
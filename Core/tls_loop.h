@@ -0,0 +1,173 @@
+/**
+ * @file tls_loop.h
+ * @brief Event loop driving many non-blocking TLS connections from one thread
+ *
+ * Each connection is an mbedTLS context on a non-blocking socket. The loop
+ * waits once for readiness across all of them, then steps every connection
+ * whose socket is ready: its handshake, then the application callback. A
+ * connection whose signature is queued on the SE05x waits for
+ * se05x_async_poll() instead of its socket, and one with decrypted data left
+ * in its record buffer is stepped again without waiting. Readiness comes from
+ * epoll on Linux and from one select() over every socket elsewhere, instead
+ * of one select() per socket or spinning on MBEDTLS_ERR_SSL_WANT_READ.
+ */
+
+#ifndef TLS_LOOP_H
+#define TLS_LOOP_H
+
+#include <stdint.h>
+#include "mbedtls/ssl.h"
+#include "mbedtls/net_sockets.h"
+
+/* Connections one loop can drive */
+#ifndef TLS_LOOP_MAX_CONNECTIONS
+#define TLS_LOOP_MAX_CONNECTIONS 8
+#endif
+
+/* Readiness backends */
+#define TLS_LOOP_BACKEND_SELECT 0
+#define TLS_LOOP_BACKEND_EPOLL  1
+
+#ifndef TLS_LOOP_BACKEND
+#if defined(__linux__)
+#define TLS_LOOP_BACKEND TLS_LOOP_BACKEND_EPOLL
+#else
+#define TLS_LOOP_BACKEND TLS_LOOP_BACKEND_SELECT
+#endif
+#endif
+
+/**
+ * @brief Connection states
+ */
+typedef enum {
+    TLS_LOOP_FREE = 0,
+    TLS_LOOP_HANDSHAKE,
+    TLS_LOOP_OPEN,
+    TLS_LOOP_CLOSED,
+    TLS_LOOP_FAILED
+} tls_loop_state_t;
+
+typedef struct tls_loop_conn tls_loop_conn_t;
+
+/**
+ * @brief Application callback, run once the handshake is over and then
+ *        whenever the connection is ready again
+ * @param arg Argument given to tls_loop_add()
+ * @param conn Connection, its ssl context is ready for reads and writes
+ * @retval MBEDTLS_ERR_SSL_WANT_READ or MBEDTLS_ERR_SSL_WANT_WRITE to be run
+ *         again once the socket is ready, 0 when done with the connection,
+ *         any other error to fail it
+ */
+typedef int (*tls_loop_cb_t)(void *arg, tls_loop_conn_t *conn);
+
+/**
+ * @brief Connection driven by the loop
+ */
+struct tls_loop_conn {
+    mbedtls_ssl_context *ssl;
+    mbedtls_net_context *net;
+    tls_loop_cb_t cb;
+    void *arg;
+    uint32_t start;
+    uint32_t handshake_cycles;
+    int result;
+    uint8_t state;
+    uint8_t want;
+    uint8_t ready;
+    uint8_t async;
+};
+
+/**
+ * @brief Event loop counters, cycle totals are from board_timing_cycles()
+ */
+typedef struct {
+    uint32_t handshakes;
+    uint32_t failures;
+    uint32_t closed;
+    uint32_t waits;
+    uint32_t steps;
+    uint32_t handshake_cycles;
+} tls_loop_stats_t;
+
+/**
+ * @brief Event loop
+ */
+typedef struct {
+    tls_loop_conn_t conns[TLS_LOOP_MAX_CONNECTIONS];
+#if TLS_LOOP_BACKEND == TLS_LOOP_BACKEND_EPOLL
+    int epfd;
+#endif
+    tls_loop_stats_t stats;
+} tls_loop_t;
+
+/**
+ * @brief Set up an empty event loop
+ * @param loop Loop to set up
+ * @retval 0 if successful, non-zero otherwise
+ */
+int tls_loop_init(tls_loop_t *loop);
+
+/**
+ * @brief Hand a connection to the loop, which starts its handshake
+ *
+ * The socket is switched to non-blocking and @p ssl must use it through
+ * mbedtls_net_send() and mbedtls_net_recv().
+ *
+ * @param loop Event loop
+ * @param ssl Context set up with mbedtls_ssl_setup(), handshake not started
+ * @param net Connected socket
+ * @param cb Application callback, or NULL to leave the connection idle
+ *        after its handshake
+ * @param arg Argument for @p cb
+ * @retval Connection index if successful, negative otherwise
+ */
+int tls_loop_add(tls_loop_t *loop, mbedtls_ssl_context *ssl, mbedtls_net_context *net,
+                 tls_loop_cb_t cb, void *arg);
+
+/**
+ * @brief Wait for ready connections and step them
+ * @param loop Event loop
+ * @param timeout_ms Longest wait for a socket to become ready
+ * @retval Number of connections still handshaking or waiting for their
+ *         callback, negative on error
+ */
+int tls_loop_run_once(tls_loop_t *loop, uint32_t timeout_ms);
+
+/**
+ * @brief Get a connection by index
+ * @param loop Event loop
+ * @param index Index returned by tls_loop_add()
+ * @retval Connection, or NULL if the index is not in use
+ */
+tls_loop_conn_t *tls_loop_get(tls_loop_t *loop, int index);
+
+/**
+ * @brief Take a connection out of the loop
+ *
+ * The ssl context and the socket still belong to the caller.
+ *
+ * @param loop Event loop
+ * @param index Index returned by tls_loop_add()
+ */
+void tls_loop_remove(tls_loop_t *loop, int index);
+
+/**
+ * @brief Take every connection out of the loop and release the loop
+ * @param loop Event loop
+ */
+void tls_loop_free(tls_loop_t *loop);
+
+/**
+ * @brief Get event loop counters
+ * @param loop Event loop
+ * @param stats Filled with the current counters
+ */
+void tls_loop_get_stats(const tls_loop_t *loop, tls_loop_stats_t *stats);
+
+/**
+ * @brief Reset event loop counters
+ * @param loop Event loop
+ */
+void tls_loop_reset_stats(tls_loop_t *loop);
+
+#endif /* TLS_LOOP_H */
@@ -0,0 +1,340 @@
+/**
+ * @file tls_profile.c
+ * @brief Per-state profile of TLS and DTLS handshakes
+ *
+ * SE05x time is the time between the two calls of the smCom hook, so it
+ * covers the I2C transfers, the SE05x processing and any wait for the bus
+ * lock. One handshake at a time is expected to talk to the SE05x; with
+ * several in flight, each is charged for the exchanges made during its own
+ * steps.
+ */
+
+#include "tls_profile.h"
+#include "board_timing.h"
+#include "smCom.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+#include "mbedtls/memory_buffer_alloc.h"
+#define TLS_PROFILE_HEAP
+#endif
+
+static tls_profile_report_cb_t report_cb;
+static void *report_arg;
+
+/* Running total of SE05x exchange time, sampled around each step */
+static uint32_t se_cycles;
+static uint32_t se_start;
+
+static const char *const state_names[TLS_PROFILE_MAX_STATES] = {
+    [MBEDTLS_SSL_HELLO_REQUEST]                           = "HELLO_REQUEST",
+    [MBEDTLS_SSL_CLIENT_HELLO]                            = "CLIENT_HELLO",
+    [MBEDTLS_SSL_SERVER_HELLO]                            = "SERVER_HELLO",
+    [MBEDTLS_SSL_SERVER_CERTIFICATE]                      = "SERVER_CERTIFICATE",
+    [MBEDTLS_SSL_SERVER_KEY_EXCHANGE]                     = "SERVER_KEY_EXCHANGE",
+    [MBEDTLS_SSL_CERTIFICATE_REQUEST]                     = "CERTIFICATE_REQUEST",
+    [MBEDTLS_SSL_SERVER_HELLO_DONE]                       = "SERVER_HELLO_DONE",
+    [MBEDTLS_SSL_CLIENT_CERTIFICATE]                      = "CLIENT_CERTIFICATE",
+    [MBEDTLS_SSL_CLIENT_KEY_EXCHANGE]                     = "CLIENT_KEY_EXCHANGE",
+    [MBEDTLS_SSL_CERTIFICATE_VERIFY]                      = "CERTIFICATE_VERIFY",
+    [MBEDTLS_SSL_CLIENT_CHANGE_CIPHER_SPEC]               = "CLIENT_CHANGE_CIPHER_SPEC",
+    [MBEDTLS_SSL_CLIENT_FINISHED]                         = "CLIENT_FINISHED",
+    [MBEDTLS_SSL_SERVER_CHANGE_CIPHER_SPEC]               = "SERVER_CHANGE_CIPHER_SPEC",
+    [MBEDTLS_SSL_SERVER_FINISHED]                         = "SERVER_FINISHED",
+    [MBEDTLS_SSL_FLUSH_BUFFERS]                           = "FLUSH_BUFFERS",
+    [MBEDTLS_SSL_HANDSHAKE_WRAPUP]                        = "HANDSHAKE_WRAPUP",
+    [MBEDTLS_SSL_NEW_SESSION_TICKET]                      = "NEW_SESSION_TICKET",
+    [MBEDTLS_SSL_SERVER_HELLO_VERIFY_REQUEST_SENT]        = "SERVER_HELLO_VERIFY_REQUEST_SENT",
+    [MBEDTLS_SSL_HELLO_RETRY_REQUEST]                     = "HELLO_RETRY_REQUEST",
+    [MBEDTLS_SSL_ENCRYPTED_EXTENSIONS]                    = "ENCRYPTED_EXTENSIONS",
+    [MBEDTLS_SSL_END_OF_EARLY_DATA]                       = "END_OF_EARLY_DATA",
+    [MBEDTLS_SSL_CLIENT_CERTIFICATE_VERIFY]               = "CLIENT_CERTIFICATE_VERIFY",
+    [MBEDTLS_SSL_CLIENT_CCS_AFTER_SERVER_FINISHED]        = "CLIENT_CCS_AFTER_SERVER_FINISHED",
+    [MBEDTLS_SSL_CLIENT_CCS_BEFORE_2ND_CLIENT_HELLO]      = "CLIENT_CCS_BEFORE_2ND_CLIENT_HELLO",
+    [MBEDTLS_SSL_SERVER_CCS_AFTER_SERVER_HELLO]           = "SERVER_CCS_AFTER_SERVER_HELLO",
+    [MBEDTLS_SSL_CLIENT_CCS_AFTER_CLIENT_HELLO]           = "CLIENT_CCS_AFTER_CLIENT_HELLO",
+    [MBEDTLS_SSL_SERVER_CCS_AFTER_HELLO_RETRY_REQUEST]    = "SERVER_CCS_AFTER_HELLO_RETRY_REQUEST",
+    [MBEDTLS_SSL_HANDSHAKE_OVER]                          = "HANDSHAKE_OVER",
+    [MBEDTLS_SSL_TLS1_3_NEW_SESSION_TICKET]               = "TLS1_3_NEW_SESSION_TICKET",
+    [MBEDTLS_SSL_TLS1_3_NEW_SESSION_TICKET_FLUSH]         = "TLS1_3_NEW_SESSION_TICKET_FLUSH",
+};
+
+/**
+ * @brief smCom hook: time each APDU exchange
+ * @param arg Unused
+ * @param done 0 before the exchange, 1 after it
+ */
+static void tls_profile_se_hook(void *arg, U8 done)
+{
+    (void)arg;
+    if (!done) {
+        se_start = board_timing_cycles();
+    } else {
+        se_cycles += board_timing_cycles() - se_start;
+    }
+}
+
+/**
+ * @brief Set the function receiving handshake reports
+ * @param cb Report callback, NULL to stop profiling
+ * @param arg Argument for @p cb
+ */
+void tls_profile_set_report(tls_profile_report_cb_t cb, void *arg)
+{
+    report_cb = cb;
+    report_arg = arg;
+    smCom_SetTxnHook(cb != NULL ? tls_profile_se_hook : NULL, NULL);
+}
+
+/**
+ * @brief Send callback: forward and count
+ */
+static int tls_profile_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    tls_profile_t *profile = (tls_profile_t *)ctx;
+    uint32_t start = board_timing_cycles();
+    int ret;
+
+    ret = profile->f_send(profile->p_bio, buf, len);
+    profile->net_cycles += board_timing_cycles() - start;
+    if (ret > 0) {
+        profile->bytes_sent += (uint32_t)ret;
+    }
+    return ret;
+}
+
+/**
+ * @brief Receive callback: forward and count
+ */
+static int tls_profile_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    tls_profile_t *profile = (tls_profile_t *)ctx;
+    uint32_t start = board_timing_cycles();
+    int ret;
+
+    ret = profile->f_recv(profile->p_bio, buf, len);
+    profile->net_cycles += board_timing_cycles() - start;
+    if (ret > 0) {
+        profile->bytes_received += (uint32_t)ret;
+    }
+    return ret;
+}
+
+/**
+ * @brief Receive callback with timeout: forward and count
+ */
+static int tls_profile_recv_timeout(void *ctx, unsigned char *buf, size_t len, uint32_t timeout)
+{
+    tls_profile_t *profile = (tls_profile_t *)ctx;
+    uint32_t start = board_timing_cycles();
+    int ret;
+
+    ret = profile->f_recv_timeout(profile->p_bio, buf, len, timeout);
+    profile->net_cycles += board_timing_cycles() - start;
+    if (ret > 0) {
+        profile->bytes_received += (uint32_t)ret;
+    }
+    return ret;
+}
+
+/**
+ * @brief Install BIO callbacks that count bytes and network time
+ * @param profile Profiler of the connection, must outlive @p ssl
+ * @param ssl SSL context
+ * @param p_bio Context for the callbacks
+ * @param f_send Send callback
+ * @param f_recv Receive callback, or NULL
+ * @param f_recv_timeout Receive callback with timeout, or NULL
+ */
+void tls_profile_set_bio(tls_profile_t *profile, mbedtls_ssl_context *ssl, void *p_bio,
+                         mbedtls_ssl_send_t *f_send, mbedtls_ssl_recv_t *f_recv,
+                         mbedtls_ssl_recv_timeout_t *f_recv_timeout)
+{
+    memset(profile, 0, sizeof(*profile));
+    profile->p_bio = p_bio;
+    profile->f_send = f_send;
+    profile->f_recv = f_recv;
+    profile->f_recv_timeout = f_recv_timeout;
+    mbedtls_ssl_set_bio(ssl, profile,
+                        f_send != NULL ? tls_profile_send : NULL,
+                        f_recv != NULL ? tls_profile_recv : NULL,
+                        f_recv_timeout != NULL ? tls_profile_recv_timeout : NULL);
+}
+
+/**
+ * @brief Whether mbedtls_ssl_handshake() wants to be called again
+ * @param ret Handshake result
+ */
+static int tls_profile_pending(int ret)
+{
+    return ret == MBEDTLS_ERR_SSL_WANT_READ ||
+           ret == MBEDTLS_ERR_SSL_WANT_WRITE ||
+           ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS ||
+           ret == MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS;
+}
+
+/**
+ * @brief mbedtls_ssl_handshake() with every step profiled
+ * @param profile Profiler of the connection
+ * @param ssl SSL context
+ * @retval Same as mbedtls_ssl_handshake()
+ */
+int tls_profile_handshake(tls_profile_t *profile, mbedtls_ssl_context *ssl)
+{
+    tls_profile_report_t *report = &profile->report;
+    tls_profile_state_t *entry;
+    uint32_t now;
+    uint32_t gap;
+    uint32_t se;
+    uint32_t net;
+    uint32_t se_mark;
+    uint32_t net_mark;
+    uint32_t sent_mark;
+    uint32_t received_mark;
+    int state;
+    int ret = 0;
+#if defined(TLS_PROFILE_HEAP)
+    size_t heap_used, heap_blocks;
+#endif
+
+    if (report_cb == NULL) {
+        return mbedtls_ssl_handshake(ssl);
+    }
+
+    if (!profile->active) {
+        memset(report, 0, sizeof(*report));
+        profile->active = 1;
+        profile->start = board_timing_cycles();
+        profile->last = profile->start;
+        profile->se_mark = se_cycles;
+        profile->last_ret = 0;
+    }
+
+    while (!mbedtls_ssl_is_handshake_over(ssl)) {
+        state = ssl->MBEDTLS_PRIVATE(state);
+        entry = &report->states[state < TLS_PROFILE_MAX_STATES ? state : 0];
+        now = board_timing_cycles();
+
+        /* Time since the last step: SE05x if the caller polled signatures,
+         * network if the last step waited for the socket */
+        gap = now - profile->last;
+        se = se_cycles - profile->se_mark;
+        if (se > gap) {
+            se = gap;
+        }
+        entry->se_cycles += se;
+        if (profile->last_ret == MBEDTLS_ERR_SSL_WANT_READ ||
+            profile->last_ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            entry->net_cycles += gap - se;
+        } else {
+            entry->cpu_cycles += gap - se;
+        }
+        if (entry->steps == 0) {
+            entry->enter_cycles = now - profile->start;
+        }
+
+        se_mark = se_cycles;
+        net_mark = profile->net_cycles;
+        sent_mark = profile->bytes_sent;
+        received_mark = profile->bytes_received;
+#if defined(TLS_PROFILE_HEAP)
+        mbedtls_memory_buffer_alloc_max_reset();
+#endif
+        now = board_timing_cycles();
+        ret = mbedtls_ssl_handshake_step(ssl);
+        profile->last = board_timing_cycles();
+        profile->last_ret = ret;
+
+        gap = profile->last - now;
+        se = se_cycles - se_mark;
+        net = profile->net_cycles - net_mark;
+        if (se + net > gap) {
+            net = gap > se ? gap - se : 0;
+            se = gap - net;
+        }
+        entry->steps++;
+        entry->se_cycles += se;
+        entry->net_cycles += net;
+        entry->cpu_cycles += gap - se - net;
+        entry->bytes_sent += profile->bytes_sent - sent_mark;
+        entry->bytes_received += profile->bytes_received - received_mark;
+#if defined(TLS_PROFILE_HEAP)
+        mbedtls_memory_buffer_alloc_max_get(&heap_used, &heap_blocks);
+        if (heap_used > entry->heap_peak) {
+            entry->heap_peak = heap_used;
+        }
+        if (heap_used > report->heap_peak) {
+            report->heap_peak = heap_used;
+        }
+#endif
+        profile->se_mark = se_cycles;
+
+        if (ret != 0) {
+            break;
+        }
+    }
+
+    if (tls_profile_pending(ret)) {
+        return ret;
+    }
+    if (ret == 0) {
+        /* Nothing left to step, lets mbedTLS release idle record buffers */
+        ret = mbedtls_ssl_handshake(ssl);
+    }
+
+    report->result = ret;
+    report->version = mbedtls_ssl_get_version_number(ssl);
+    report->total_cycles = profile->last - profile->start;
+    profile->active = 0;
+    report_cb(report, report_arg);
+    return ret;
+}
+
+/**
+ * @brief Name of a handshake state
+ * @param state One of mbedtls_ssl_states
+ * @retval State name without the MBEDTLS_SSL_ prefix
+ */
+const char *tls_profile_state_name(int state)
+{
+    if (state < 0 || state >= TLS_PROFILE_MAX_STATES || state_names[state] == NULL) {
+        return "UNKNOWN";
+    }
+    return state_names[state];
+}
+
+/**
+ * @brief Report callback that prints one line per state visited
+ * @param report Profile of the handshake
+ * @param arg Unused
+ */
+void tls_profile_print(const tls_profile_report_t *report, void *arg)
+{
+    const tls_profile_state_t *entry;
+    int state;
+
+    (void)arg;
+    printf("Handshake profile: %s, result -0x%04X, %lu us, peak heap %lu bytes\n",
+           report->version == MBEDTLS_SSL_VERSION_TLS1_3 ? "TLS 1.3" :
+           report->version == MBEDTLS_SSL_VERSION_TLS1_2 ? "TLS 1.2" : "unknown",
+           (unsigned int)-report->result,
+           (unsigned long)board_timing_cycles_to_us(report->total_cycles),
+           (unsigned long)report->heap_peak);
+    for (state = 0; state < TLS_PROFILE_MAX_STATES; state++) {
+        entry = &report->states[state];
+        if (entry->steps == 0) {
+            continue;
+        }
+        printf("  %-26s at %7lu us: CPU %7lu us, network %7lu us, SE05x %7lu us, "
+               "%5lu bytes out, %5lu in, heap %6lu\n",
+               tls_profile_state_name(state),
+               (unsigned long)board_timing_cycles_to_us(entry->enter_cycles),
+               (unsigned long)board_timing_cycles_to_us(entry->cpu_cycles),
+               (unsigned long)board_timing_cycles_to_us(entry->net_cycles),
+               (unsigned long)board_timing_cycles_to_us(entry->se_cycles),
+               (unsigned long)entry->bytes_sent,
+               (unsigned long)entry->bytes_received,
+               (unsigned long)entry->heap_peak);
+    }
+}
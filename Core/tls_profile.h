@@ -0,0 +1,140 @@
+/**
+ * @file tls_profile.h
+ * @brief Per-state profile of TLS and DTLS handshakes
+ *
+ * tls_profile_handshake() replaces mbedtls_ssl_handshake() and runs the
+ * handshake one mbedtls_ssl_handshake_step() at a time. Every step is
+ * charged to the state it started in, and its time is split into:
+ *  - network: inside the send/receive callbacks installed with
+ *    tls_profile_set_bio(), and between steps after WANT_READ/WANT_WRITE;
+ *  - SE05x: APDU exchanges, timed by a hook in the smCom layer, including
+ *    any wait for the I2C bus lock held by another task;
+ *  - CPU: the rest, e.g. chain verification, host ECDHE or hashing.
+ * Bytes on the wire and, with MBEDTLS_MEMORY_DEBUG, the heap high-water mark
+ * are kept per state as well. When the handshake ends the report goes to the
+ * callback set with tls_profile_set_report(); without a callback the
+ * handshake runs as usual and nothing is recorded.
+ */
+
+#ifndef TLS_PROFILE_H
+#define TLS_PROFILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mbedtls/ssl.h"
+
+/* Handshake states profiled, indexed by mbedtls_ssl_states */
+#define TLS_PROFILE_MAX_STATES (MBEDTLS_SSL_TLS1_3_NEW_SESSION_TICKET_FLUSH + 1)
+
+/**
+ * @brief Time, traffic and heap of one handshake state, cycle values are from
+ *        board_timing_cycles()
+ */
+typedef struct {
+    uint32_t steps;
+    /* First entry into the state, relative to the start of the handshake */
+    uint32_t enter_cycles;
+    uint32_t cpu_cycles;
+    uint32_t net_cycles;
+    uint32_t se_cycles;
+    uint32_t bytes_sent;
+    uint32_t bytes_received;
+    size_t heap_peak;
+} tls_profile_state_t;
+
+/**
+ * @brief Profile of one handshake
+ */
+typedef struct {
+    /* mbedtls_ssl_handshake() result, 0 if the handshake completed */
+    int result;
+    mbedtls_ssl_protocol_version version;
+    uint32_t total_cycles;
+    size_t heap_peak;
+    tls_profile_state_t states[TLS_PROFILE_MAX_STATES];
+} tls_profile_report_t;
+
+/**
+ * @brief Receives the report of each profiled handshake
+ * @param report Profile of the handshake, only valid during the call
+ * @param arg Argument given to tls_profile_set_report()
+ */
+typedef void (*tls_profile_report_cb_t)(const tls_profile_report_t *report, void *arg);
+
+/**
+ * @brief Profiler of one connection, also the context of its BIO callbacks
+ */
+typedef struct {
+    tls_profile_report_t report;
+    void *p_bio;
+    mbedtls_ssl_send_t *f_send;
+    mbedtls_ssl_recv_t *f_recv;
+    mbedtls_ssl_recv_timeout_t *f_recv_timeout;
+    /* Running totals, sampled around each step */
+    uint32_t net_cycles;
+    uint32_t bytes_sent;
+    uint32_t bytes_received;
+    /* Start of the handshake, end of the last step, SE05x time total at
+     * that point and what the step returned */
+    uint32_t start;
+    uint32_t last;
+    uint32_t se_mark;
+    int last_ret;
+    int active;
+} tls_profile_t;
+
+/**
+ * @brief Set the function receiving handshake reports
+ *
+ * Also installs the smCom hook that times SE05x exchanges.
+ *
+ * @param cb Report callback, NULL to stop profiling
+ * @param arg Argument for @p cb
+ */
+void tls_profile_set_report(tls_profile_report_cb_t cb, void *arg);
+
+/**
+ * @brief Install BIO callbacks that count bytes and network time, in place of
+ *        mbedtls_ssl_set_bio()
+ * @param profile Profiler of the connection, must outlive @p ssl
+ * @param ssl SSL context
+ * @param p_bio Context for the callbacks
+ * @param f_send Send callback
+ * @param f_recv Receive callback, or NULL
+ * @param f_recv_timeout Receive callback with timeout, or NULL
+ */
+void tls_profile_set_bio(tls_profile_t *profile, mbedtls_ssl_context *ssl, void *p_bio,
+                         mbedtls_ssl_send_t *f_send, mbedtls_ssl_recv_t *f_recv,
+                         mbedtls_ssl_recv_timeout_t *f_recv_timeout);
+
+/**
+ * @brief mbedtls_ssl_handshake() with every step profiled
+ *
+ * Call again on WANT_READ, WANT_WRITE and the IN_PROGRESS codes like
+ * mbedtls_ssl_handshake(); the profile spans all calls until the handshake
+ * completes or fails, and is then handed to the report callback.
+ *
+ * @param profile Profiler of the connection
+ * @param ssl SSL context
+ * @retval Same as mbedtls_ssl_handshake()
+ *
+ * @note With MBEDTLS_MEMORY_DEBUG the allocator's high-water mark is reset
+ *       before each step.
+ */
+int tls_profile_handshake(tls_profile_t *profile, mbedtls_ssl_context *ssl);
+
+/**
+ * @brief Name of a handshake state
+ * @param state One of mbedtls_ssl_states
+ * @retval State name without the MBEDTLS_SSL_ prefix
+ */
+const char *tls_profile_state_name(int state);
+
+/**
+ * @brief Report callback that prints one line per state visited
+ * @param report Profile of the handshake
+ * @param arg Unused
+ */
+void tls_profile_print(const tls_profile_report_t *report, void *arg);
+
+#endif /* TLS_PROFILE_H */
@@ -0,0 +1,387 @@
+/**
+ * @file trust_store.c
+ * @brief Flash-resident trusted CA store indexed by subject and key identifier
+ *
+ * Blob layout (little-endian uint32, offsets from the start of the blob), see
+ * scripts/gen_trust_store.py:
+ *   header    magic "TSI2", version, count, ski_count,
+ *             entries_off, subject_index_off, ski_index_off, total_len
+ *   entries   count x pre-parsed certificate: (offset, length) of the DER,
+ *             subject, SKI, TBS, serial, issuer, SPKI, extensions, signature
+ *             OID and signature, then not_before, not_after, flags, max_pathlen
+ *   subjects  count x (hash, ca) sorted by hash
+ *   skis      ski_count x (hash, ca) sorted by hash
+ *   DER       the certificates
+ */
+
+#include "trust_store.h"
+#include "board_timing.h"
+#include "mbedtls/platform.h"
+#include "mbedtls/error.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TRUST_STORE_HEADER_LEN 32
+#define TRUST_STORE_ENTRY_LEN 96
+#define TRUST_STORE_INDEX_LEN 8
+
+/* Entry fields, (offset, length) pairs first */
+#define TRUST_STORE_F_DER          0
+#define TRUST_STORE_F_SUBJECT      2
+#define TRUST_STORE_F_SKI          4
+#define TRUST_STORE_F_TBS          6
+#define TRUST_STORE_F_SERIAL       8
+#define TRUST_STORE_F_ISSUER       10
+#define TRUST_STORE_F_SPKI         12
+#define TRUST_STORE_F_EXTENSIONS   14
+#define TRUST_STORE_F_SIG_OID      16
+#define TRUST_STORE_F_SIG          18
+#define TRUST_STORE_F_VIEWS_END    20
+#define TRUST_STORE_F_NOT_BEFORE   20
+#define TRUST_STORE_F_NOT_AFTER    21
+#define TRUST_STORE_F_FLAGS        22
+#define TRUST_STORE_F_MAX_PATHLEN  23
+
+/* Entry flags, keyUsage is in the upper 16 bits */
+#define TRUST_STORE_FLAG_CA        (1U << 0)
+#define TRUST_STORE_FLAG_KEY_USAGE (1U << 1)
+
+static const uint8_t trust_store_magic[4] = { 'T', 'S', 'I', '2' };
+
+static uint32_t trust_store_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* FNV-1a, as computed by the generator */
+static uint32_t trust_store_hash(const uint8_t *p, size_t len)
+{
+    uint32_t h = 0x811C9DC5U;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 0x01000193U;
+    }
+    return h;
+}
+
+/* Field of entry ca, one of TRUST_STORE_F_* */
+static uint32_t trust_store_field(const trust_store_t *store, uint32_t ca, int field)
+{
+    return trust_store_u32(store->entries + ca * TRUST_STORE_ENTRY_LEN + field * 4);
+}
+
+/**
+ * @brief Attach a generated blob and check its layout
+ * @param store Store to set up
+ * @param blob Blob from scripts/gen_trust_store.py, must stay valid
+ * @param len Length of @p blob
+ * @retval 0 if successful, non-zero if the blob is malformed
+ */
+int trust_store_load(trust_store_t *store, const uint8_t *blob, size_t len)
+{
+    uint32_t total, entries_off, subjects_off, skis_off;
+    uint32_t i, off, n;
+    int field;
+
+    memset(store, 0, sizeof(*store));
+
+    if (len < TRUST_STORE_HEADER_LEN || memcmp(blob, trust_store_magic, 4) != 0) {
+        printf("ERROR: Trust store has no valid header\n");
+        return -1;
+    }
+
+    store->version = trust_store_u32(blob + 4);
+    store->count = trust_store_u32(blob + 8);
+    store->ski_count = trust_store_u32(blob + 12);
+    entries_off = trust_store_u32(blob + 16);
+    subjects_off = trust_store_u32(blob + 20);
+    skis_off = trust_store_u32(blob + 24);
+    total = trust_store_u32(blob + 28);
+
+    /* Counts are bounded by the blob size, so the products below cannot wrap */
+    if (total > len || store->count > total / TRUST_STORE_ENTRY_LEN ||
+        store->ski_count > store->count ||
+        entries_off > total - store->count * TRUST_STORE_ENTRY_LEN ||
+        subjects_off > total - store->count * TRUST_STORE_INDEX_LEN ||
+        skis_off > total - store->ski_count * TRUST_STORE_INDEX_LEN) {
+        printf("ERROR: Trust store tables out of bounds\n");
+        return -1;
+    }
+
+    store->blob = blob;
+    store->entries = blob + entries_off;
+    store->subjects = blob + subjects_off;
+    store->skis = blob + skis_off;
+
+    /* Checking the views once here is all the parsing a boot needs */
+    for (i = 0; i < store->count; i++) {
+        for (field = TRUST_STORE_F_DER; field < TRUST_STORE_F_VIEWS_END; field += 2) {
+            off = trust_store_field(store, i, field);
+            n = trust_store_field(store, i, field + 1);
+            if (off > total || n > total - off) {
+                break;
+            }
+        }
+        if (field < TRUST_STORE_F_VIEWS_END ||
+            trust_store_u32(store->subjects + i * TRUST_STORE_INDEX_LEN + 4) >= store->count ||
+            (i < store->ski_count &&
+             trust_store_u32(store->skis + i * TRUST_STORE_INDEX_LEN + 4) >= store->count)) {
+            break;
+        }
+    }
+    if (i != store->count) {
+        printf("ERROR: Trust store entry %lu out of bounds\n", (unsigned long)i);
+        memset(store, 0, sizeof(*store));
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief First position of a hash in a sorted index
+ */
+static uint32_t trust_store_find(const uint8_t *index, uint32_t n, uint32_t hash)
+{
+    uint32_t lo = 0;
+    uint32_t hi = n;
+    uint32_t mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (trust_store_u32(index + mid * TRUST_STORE_INDEX_LEN) < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Add a CA to the candidate list once
+ */
+static void trust_store_add(uint32_t *list, size_t *n, uint32_t ca)
+{
+    size_t i;
+
+    for (i = 0; i < *n; i++) {
+        if (list[i] == ca) {
+            return;
+        }
+    }
+    if (*n < TRUST_STORE_MAX_CANDIDATES) {
+        list[(*n)++] = ca;
+    }
+}
+
+/**
+ * @brief Compare a byte string with a field of an entry
+ */
+static int trust_store_field_equals(const trust_store_t *store, uint32_t ca, int field,
+                                    const unsigned char *p, size_t len)
+{
+    return trust_store_field(store, ca, field + 1) == len &&
+           memcmp(store->blob + trust_store_field(store, ca, field), p, len) == 0;
+}
+
+/**
+ * @brief Append a CA to a certificate list without copying its DER
+ */
+static int trust_store_parse(const trust_store_t *store, uint32_t ca, mbedtls_x509_crt *chain)
+{
+    return mbedtls_x509_crt_parse_der_nocopy(chain,
+                                             store->blob + trust_store_field(store, ca,
+                                                                             TRUST_STORE_F_DER),
+                                             trust_store_field(store, ca, TRUST_STORE_F_DER + 1));
+}
+
+/**
+ * @brief Trusted CA callback, see mbedtls_x509_crt_ca_cb_t
+ * @param p_ctx Store set up with trust_store_load()
+ * @param child Certificate to find a parent for
+ * @param candidate_cas Filled with the candidate list, or NULL
+ * @retval 0 if successful, an mbedTLS error code on a fatal error
+ */
+int trust_store_ca_cb(void *p_ctx, mbedtls_x509_crt const *child,
+                      mbedtls_x509_crt **candidate_cas)
+{
+    trust_store_t *store = (trust_store_t *)p_ctx;
+    const mbedtls_x509_buf *aki = &child->authority_key_id.keyIdentifier;
+    uint32_t list[TRUST_STORE_MAX_CANDIDATES];
+    uint32_t start = board_timing_cycles();
+    uint32_t hash;
+    uint32_t pos;
+    uint32_t ca;
+    mbedtls_x509_crt *head;
+    size_t n = 0;
+    size_t i;
+    int ret;
+
+    *candidate_cas = NULL;
+
+    /* Key identifier matches go first: when a CA was re-keyed under the same
+     * name, they point at the key that actually signed */
+    if (aki->len > 0) {
+        hash = trust_store_hash(aki->p, aki->len);
+        for (pos = trust_store_find(store->skis, store->ski_count, hash);
+             pos < store->ski_count &&
+             trust_store_u32(store->skis + pos * TRUST_STORE_INDEX_LEN) == hash;
+             pos++) {
+            ca = trust_store_u32(store->skis + pos * TRUST_STORE_INDEX_LEN + 4);
+            if (trust_store_field_equals(store, ca, TRUST_STORE_F_SKI, aki->p, aki->len)) {
+                trust_store_add(list, &n, ca);
+                store->stats.aki_matches++;
+            }
+        }
+    }
+
+    hash = trust_store_hash(child->issuer_raw.p, child->issuer_raw.len);
+    for (pos = trust_store_find(store->subjects, store->count, hash);
+         pos < store->count &&
+         trust_store_u32(store->subjects + pos * TRUST_STORE_INDEX_LEN) == hash;
+         pos++) {
+        ca = trust_store_u32(store->subjects + pos * TRUST_STORE_INDEX_LEN + 4);
+        if (trust_store_field_equals(store, ca, TRUST_STORE_F_SUBJECT,
+                                     child->issuer_raw.p, child->issuer_raw.len)) {
+            trust_store_add(list, &n, ca);
+        }
+    }
+
+    store->stats.lookups++;
+    store->stats.candidates += n;
+
+    if (n == 0) {
+        store->stats.lookup_cycles += board_timing_cycles() - start;
+        return 0;
+    }
+
+    /* Ownership of the list goes to mbedTLS, which frees it with
+     * mbedtls_x509_crt_free() and mbedtls_free() */
+    head = mbedtls_calloc(1, sizeof(*head));
+    if (head == NULL) {
+        return MBEDTLS_ERR_X509_ALLOC_FAILED;
+    }
+    mbedtls_x509_crt_init(head);
+
+    for (i = 0; i < n; i++) {
+        ret = trust_store_parse(store, list[i], head);
+        if (ret == MBEDTLS_ERR_X509_ALLOC_FAILED) {
+            mbedtls_x509_crt_free(head);
+            mbedtls_free(head);
+            return ret;
+        }
+        if (ret != 0) {
+            printf("WARNING: Trust store CA %lu does not parse (-0x%04X)\n",
+                   (unsigned long)list[i], -ret);
+        }
+    }
+
+    if (head->raw.p == NULL) {
+        mbedtls_free(head);
+        head = NULL;
+    }
+
+    *candidate_cas = head;
+    store->stats.lookup_cycles += board_timing_cycles() - start;
+    return 0;
+}
+
+/**
+ * @brief Parse every CA of the store into a regular CA list
+ * @param store Store set up with trust_store_load()
+ * @param chain Initialized certificate list to append to
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int trust_store_parse_all(const trust_store_t *store, mbedtls_x509_crt *chain)
+{
+    uint32_t i;
+    int ret;
+
+    for (i = 0; i < store->count; i++) {
+        ret = trust_store_parse(store, i, chain);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Point a buffer at a view of an entry
+ */
+static void trust_store_buf(const trust_store_t *store, uint32_t ca, int field,
+                            mbedtls_x509_buf *buf)
+{
+    buf->len = trust_store_field(store, ca, field + 1);
+    buf->p = buf->len != 0 ? (unsigned char *)store->blob + trust_store_field(store, ca, field)
+                           : NULL;
+}
+
+/**
+ * @brief Get the pre-parsed view of a CA without parsing its DER
+ * @param store Store set up with trust_store_load()
+ * @param ca CA number, below store->count
+ * @param view Filled with pointers into the blob
+ * @retval 0 if successful, non-zero if @p ca is out of range
+ */
+int trust_store_view(const trust_store_t *store, uint32_t ca, trust_store_view_t *view)
+{
+    uint32_t flags;
+
+    if (ca >= store->count) {
+        return -1;
+    }
+
+    trust_store_buf(store, ca, TRUST_STORE_F_DER, &view->raw);
+    trust_store_buf(store, ca, TRUST_STORE_F_TBS, &view->tbs);
+    trust_store_buf(store, ca, TRUST_STORE_F_SERIAL, &view->serial);
+    trust_store_buf(store, ca, TRUST_STORE_F_ISSUER, &view->issuer_raw);
+    trust_store_buf(store, ca, TRUST_STORE_F_SUBJECT, &view->subject_raw);
+    trust_store_buf(store, ca, TRUST_STORE_F_SPKI, &view->pk_raw);
+    trust_store_buf(store, ca, TRUST_STORE_F_EXTENSIONS, &view->v3_ext);
+    trust_store_buf(store, ca, TRUST_STORE_F_SKI, &view->subject_key_id);
+    trust_store_buf(store, ca, TRUST_STORE_F_SIG_OID, &view->sig_oid);
+    trust_store_buf(store, ca, TRUST_STORE_F_SIG, &view->sig);
+
+    view->valid_from = trust_store_field(store, ca, TRUST_STORE_F_NOT_BEFORE);
+    view->valid_to = trust_store_field(store, ca, TRUST_STORE_F_NOT_AFTER);
+    flags = trust_store_field(store, ca, TRUST_STORE_F_FLAGS);
+    view->ca_istrue = (flags & TRUST_STORE_FLAG_CA) != 0;
+    view->has_key_usage = (flags & TRUST_STORE_FLAG_KEY_USAGE) != 0;
+    view->key_usage = flags >> 16;
+    view->max_pathlen = (int)trust_store_field(store, ca, TRUST_STORE_F_MAX_PATHLEN);
+    return 0;
+}
+
+/**
+ * @brief Version of the store content, changes whenever the CAs change
+ * @param store Store set up with trust_store_load()
+ * @retval Content version
+ */
+uint32_t trust_store_version(const trust_store_t *store)
+{
+    return store->version;
+}
+
+/**
+ * @brief Get lookup counters
+ * @param store Store set up with trust_store_load()
+ * @param stats Filled with the current counters
+ */
+void trust_store_get_stats(const trust_store_t *store, trust_store_stats_t *stats)
+{
+    *stats = store->stats;
+}
+
+/**
+ * @brief Reset lookup counters
+ * @param store Store set up with trust_store_load()
+ */
+void trust_store_reset_stats(trust_store_t *store)
+{
+    memset(&store->stats, 0, sizeof(store->stats));
+}
@@ -0,0 +1,139 @@
+/**
+ * @file trust_store.h
+ * @brief Flash-resident trusted CA store indexed by subject and key identifier
+ *
+ * The store is a blob generated offline by scripts/gen_trust_store.py. It
+ * holds the CA certificates in DER together with two sorted indexes: FNV-1a
+ * of the DER subject Name and of the Subject Key Identifier. trust_store_ca_cb()
+ * plugs into mbedtls_ssl_conf_ca_cb() / mbedtls_x509_crt_verify_with_ca_cb()
+ * and hands back only the CAs whose subject matches the child's issuer or
+ * whose key identifier matches the child's Authority Key Identifier, instead
+ * of letting mbedTLS compare names against every trusted CA.
+ *
+ * Each CA is also pre-parsed offline: trust_store_view() returns the offsets
+ * of its subject, issuer, validity, extensions and public key as zero-copy
+ * views into the blob, so nothing has to be parsed or allocated at boot.
+ */
+
+#ifndef TRUST_STORE_H
+#define TRUST_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "mbedtls/x509_crt.h"
+
+/* Maximum number of candidate parents returned for one certificate */
+#ifndef TRUST_STORE_MAX_CANDIDATES
+#define TRUST_STORE_MAX_CANDIDATES 4
+#endif
+
+/**
+ * @brief Trust store lookup counters
+ */
+typedef struct {
+    uint32_t lookups;
+    uint32_t candidates;
+    uint32_t aki_matches;
+    uint32_t lookup_cycles;
+} trust_store_stats_t;
+
+/**
+ * @brief Pre-parsed CA, buffers point into the blob
+ *
+ * Buffer names follow mbedtls_x509_crt. A buffer whose part is absent from
+ * the certificate has a NULL pointer and zero length.
+ */
+typedef struct {
+    mbedtls_x509_buf raw;            /* Whole certificate */
+    mbedtls_x509_buf tbs;            /* TBSCertificate, tag and length included */
+    mbedtls_x509_buf serial;         /* Serial number content */
+    mbedtls_x509_buf issuer_raw;     /* Issuer Name, tag and length included */
+    mbedtls_x509_buf subject_raw;    /* Subject Name, tag and length included */
+    mbedtls_x509_buf pk_raw;         /* SubjectPublicKeyInfo, tag and length included */
+    mbedtls_x509_buf v3_ext;         /* Extensions SEQUENCE */
+    mbedtls_x509_buf subject_key_id; /* Subject Key Identifier content */
+    mbedtls_x509_buf sig_oid;        /* Signature algorithm OID content */
+    mbedtls_x509_buf sig;            /* Signature value */
+    uint32_t valid_from;             /* notBefore, seconds since the Unix epoch */
+    uint32_t valid_to;               /* notAfter, saturated at 0xFFFFFFFF */
+    int ca_istrue;                   /* basicConstraints cA */
+    int max_pathlen;                 /* pathLenConstraint + 1, 0 if none */
+    int has_key_usage;               /* keyUsage extension present */
+    unsigned int key_usage;          /* MBEDTLS_X509_KU_* bits */
+} trust_store_view_t;
+
+/**
+ * @brief Trust store backed by a generated blob, usually in flash
+ */
+typedef struct {
+    const uint8_t *blob;
+    uint32_t version;
+    uint32_t count;
+    uint32_t ski_count;
+    const uint8_t *entries;
+    const uint8_t *subjects;
+    const uint8_t *skis;
+    trust_store_stats_t stats;
+} trust_store_t;
+
+/**
+ * @brief Attach a generated blob and check its layout
+ * @param store Store to set up
+ * @param blob Blob from scripts/gen_trust_store.py, must stay valid
+ * @param len Length of @p blob
+ * @retval 0 if successful, non-zero if the blob is malformed
+ */
+int trust_store_load(trust_store_t *store, const uint8_t *blob, size_t len);
+
+/**
+ * @brief Trusted CA callback, see mbedtls_x509_crt_ca_cb_t
+ *
+ * Candidates are parsed with mbedtls_x509_crt_parse_der_nocopy(), so their
+ * raw DER stays in the blob.
+ *
+ * @param p_ctx Store set up with trust_store_load()
+ * @param child Certificate to find a parent for
+ * @param candidate_cas Filled with the candidate list, or NULL
+ * @retval 0 if successful, an mbedTLS error code on a fatal error
+ */
+int trust_store_ca_cb(void *p_ctx, mbedtls_x509_crt const *child,
+                      mbedtls_x509_crt **candidate_cas);
+
+/**
+ * @brief Parse every CA of the store into a regular CA list
+ * @param store Store set up with trust_store_load()
+ * @param chain Initialized certificate list to append to
+ * @retval 0 if successful, an mbedTLS error code otherwise
+ */
+int trust_store_parse_all(const trust_store_t *store, mbedtls_x509_crt *chain);
+
+/**
+ * @brief Get the pre-parsed view of a CA without parsing its DER
+ * @param store Store set up with trust_store_load()
+ * @param ca CA number, below store->count
+ * @param view Filled with pointers into the blob
+ * @retval 0 if successful, non-zero if @p ca is out of range
+ */
+int trust_store_view(const trust_store_t *store, uint32_t ca, trust_store_view_t *view);
+
+/**
+ * @brief Version of the store content, changes whenever the CAs change
+ * @param store Store set up with trust_store_load()
+ * @retval Content version
+ */
+uint32_t trust_store_version(const trust_store_t *store);
+
+/**
+ * @brief Get lookup counters
+ * @param store Store set up with trust_store_load()
+ * @param stats Filled with the current counters
+ */
+void trust_store_get_stats(const trust_store_t *store, trust_store_stats_t *stats);
+
+/**
+ * @brief Reset lookup counters
+ * @param store Store set up with trust_store_load()
+ */
+void trust_store_reset_stats(trust_store_t *store);
+
+#endif /* TRUST_STORE_H */
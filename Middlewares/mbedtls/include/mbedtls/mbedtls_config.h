@@ -352,12 +352,29 @@
  * Enable asynchronous external private key operations in SSL. This allows
  * you to configure an SSL connection to call an external cryptographic
  * module to perform private key operations instead of performing the
- * operation inside the library.
+ * operation inside the library. The callbacks are used for the TLS 1.2
+ * ServerKeyExchange signature and for the TLS 1.2 and TLS 1.3
+ * CertificateVerify.
  *
  * Requires: MBEDTLS_X509_CRT_PARSE_C
  */
 //#define MBEDTLS_SSL_ASYNC_PRIVATE
 
+/**
+ * \def MBEDTLS_SSL_ECDHE_CB
+ *
+ * Enable mbedtls_ssl_conf_ecdhe_cb(), which lets the application generate
+ * the ephemeral key pair and compute the shared secret of the TLS 1.2
+ * ECDHE key exchange and the TLS 1.3 key share itself, e.g. in a secure
+ * element, instead of through psa_generate_key() and
+ * psa_raw_key_agreement().
+ *
+ * Requires: MBEDTLS_SSL_TLS_C, PSA_WANT_ALG_ECDH
+ *
+ * Uncomment to enable external ephemeral key exchange.
+ */
+//#define MBEDTLS_SSL_ECDHE_CB
+
 /**
  * \def MBEDTLS_SSL_CACHE_C
  *
@@ -370,6 +387,21 @@
  */
 #define MBEDTLS_SSL_CACHE_C
 
+/**
+ * \def MBEDTLS_SSL_CACHE_HASH_INDEX
+ *
+ * Index the SSL session cache by a hash of the session ID instead of
+ * walking a linked list. Lookups, insertions and removals are O(1) on
+ * average, eviction uses a clock (second chance) policy, and
+ * mbedtls_ssl_cache_set_pool() allows running the cache from a fixed
+ * buffer without any heap allocation.
+ *
+ * Module:  library/ssl_cache.c
+ *
+ * Requires: MBEDTLS_SSL_CACHE_C
+ */
+//#define MBEDTLS_SSL_CACHE_HASH_INDEX
+
 /**
  * \def MBEDTLS_SSL_CLI_C
  *
@@ -861,6 +893,55 @@
  */
 //#define MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH
 
+/**
+ * \def MBEDTLS_SSL_IN_BUFFER_ON_DEMAND
+ *
+ * Size the TLS input buffer on demand instead of for the largest record.
+ * The buffer starts at the configured maximum fragment length (see
+ * mbedtls_ssl_conf_max_frag_len()), grows when a larger record arrives, for
+ * example from a peer that ignored the extension, up to
+ * MBEDTLS_SSL_IN_BUFFER_LEN, and shrinks back at the end of every handshake.
+ * DTLS keeps full-size buffers.
+ *
+ * Requires: MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH
+ */
+//#define MBEDTLS_SSL_IN_BUFFER_ON_DEMAND
+
+/**
+ * \def MBEDTLS_SSL_BUFFER_POOL
+ *
+ * Let record buffers come from a pool shared by every SSL context, see
+ * mbedtls_ssl_set_buffer_pool_cb(). Once the handshake is over, a context
+ * hands its buffers back whenever no record is being read or written and
+ * takes them again on the next mbedtls_ssl_read(), mbedtls_ssl_write() or
+ * alert, so idle connections hold no record buffer.
+ *
+ * Requires: MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH
+ *           !MBEDTLS_SSL_RENEGOTIATION
+ */
+//#define MBEDTLS_SSL_BUFFER_POOL
+
+/**
+ * \def MBEDTLS_SSL_ZERO_COPY
+ *
+ * Enable mbedtls_ssl_read_view() / mbedtls_ssl_read_consume() and
+ * mbedtls_ssl_write_view() / mbedtls_ssl_write_commit(), which let the
+ * application read decrypted data from, and write plaintext into, the
+ * record buffers instead of copying it to or from its own buffer.
+ */
+//#define MBEDTLS_SSL_ZERO_COPY
+
+/**
+ * \def MBEDTLS_SSL_ALIGNED_RECORDS
+ *
+ * Place each TLS record in its buffer so that the record payload, after the
+ * header and any explicit IV, starts on a 16-byte boundary. AEAD records are
+ * then encrypted and decrypted in place on aligned data, which lets word-wise
+ * and hardware cipher implementations skip their unaligned paths. Costs up
+ * to 15 bytes per record buffer. DTLS records keep their usual layout.
+ */
+//#define MBEDTLS_SSL_ALIGNED_RECORDS
+
 //#define MBEDTLS_PSK_MAX_LEN               32 /**< Max size of TLS pre-shared keys, in bytes (default 256 or 384 bits) */
 //#define MBEDTLS_SSL_CACHE_DEFAULT_MAX_ENTRIES      50 /**< Maximum entries in cache */
 //#define MBEDTLS_SSL_CACHE_DEFAULT_TIMEOUT       86400 /**< 1 day  */
@@ -1078,6 +1159,47 @@
  */
 #define MBEDTLS_X509_CRL_PARSE_C
 
+/**
+ * \def MBEDTLS_X509_CRT_BATCH_VERIFY
+ *
+ * Enable mbedtls_x509_crt_set_batch_verify_cb(), which lets the application
+ * verify all signatures of a certificate chain in one call once the chain
+ * has been built, instead of one signature per link during chain building.
+ *
+ * Requires: MBEDTLS_X509_CRT_PARSE_C
+ *
+ * Uncomment to enable batch verification of certificate chains.
+ */
+//#define MBEDTLS_X509_CRT_BATCH_VERIFY
+
+/**
+ * \def MBEDTLS_X509_CRT_VERIFY_CACHE
+ *
+ * Enable mbedtls_x509_crt_set_verify_cache_cb(), which lets the application
+ * remember certificate chains that verified successfully. A chain found in
+ * the cache skips chain building and signature verification; only the
+ * validity period, the expected name and the end-entity key are checked.
+ *
+ * Requires: MBEDTLS_X509_CRT_PARSE_C
+ *
+ * Uncomment to enable the verified-chain cache hooks.
+ */
+//#define MBEDTLS_X509_CRT_VERIFY_CACHE
+
+/**
+ * \def MBEDTLS_X509_CSR_WRITE_SIGN_CB
+ *
+ * Enable mbedtls_x509write_csr_set_sign_cb(), which lets the application
+ * sign a CSR with a key that the PK layer cannot reach, e.g. one held in a
+ * secure element. The key set with mbedtls_x509write_csr_set_key() then only
+ * needs its public part.
+ *
+ * Requires: MBEDTLS_X509_CSR_WRITE_C
+ *
+ * Uncomment to enable external CSR signing.
+ */
+//#define MBEDTLS_X509_CSR_WRITE_SIGN_CB
+
 /**
  * \def MBEDTLS_X509_CRT_PARSE_C
  *
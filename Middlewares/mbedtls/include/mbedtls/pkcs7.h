@@ -225,6 +225,34 @@ int mbedtls_pkcs7_signed_hash_verify(mbedtls_pkcs7 *pkcs7,
                                      const mbedtls_x509_crt *cert,
                                      const unsigned char *hash, size_t hashlen);
 
+/**
+ * \brief          Get the digest algorithm of the signed content.
+ *
+ *                 Together with mbedtls_pkcs7_signed_hash_verify(), this
+ *                 lets the caller hash the content incrementally, e.g. while
+ *                 it is received, instead of holding all of it in memory.
+ *
+ * \param pkcs7    PKCS #7 structure parsed with mbedtls_pkcs7_parse_der().
+ * \param md_alg   On success, the digest algorithm of the signers.
+ *
+ * \return         0 if successful, or a negative error code on failure.
+ */
+int mbedtls_pkcs7_get_md_alg(const mbedtls_pkcs7 *pkcs7, mbedtls_md_type_t *md_alg);
+
+/**
+ * \brief          Get the certificates carried in the PKCS #7 structure.
+ *
+ *                 They are not verified: check them against trusted CAs
+ *                 with mbedtls_x509_crt_verify() before trusting a signature
+ *                 made with one of them.
+ *
+ * \param pkcs7    PKCS #7 structure parsed with mbedtls_pkcs7_parse_der().
+ *
+ * \return         The first certificate of the list, or \c NULL if the
+ *                 structure holds none.
+ */
+mbedtls_x509_crt *mbedtls_pkcs7_get_certs(mbedtls_pkcs7 *pkcs7);
+
 /**
  * \brief          Unallocate all PKCS #7 data and zeroize the memory.
  *                 It doesn't free \p pkcs7 itself. This should be done by the caller.
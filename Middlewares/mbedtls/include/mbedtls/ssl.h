@@ -1070,6 +1070,80 @@ typedef int mbedtls_ssl_async_resume_t(mbedtls_ssl_context *ssl,
 typedef void mbedtls_ssl_async_cancel_t(mbedtls_ssl_context *ssl);
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+/**
+ * \brief           Callback type: generate an ephemeral key pair.
+ *
+ *                  This callback is called instead of psa_generate_key()
+ *                  when the handshake needs its (EC)DHE key pair: for the
+ *                  TLS 1.2 ClientKeyExchange and for the TLS 1.3 key share.
+ *
+ * \param p_ecdhe   The context set with mbedtls_ssl_conf_ecdhe_cb().
+ * \param key_type  PSA key type of the key pair, e.g.
+ *                  \c PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_SECP_R1).
+ * \param key_bits  Size of the key in bits.
+ * \param key       On success, a handle to the private key, which must not
+ *                  be \c NULL. The library passes it back to exactly one of
+ *                  the derive and free callbacks.
+ * \param pub       Buffer for the public key, in the format of
+ *                  psa_export_public_key().
+ * \param pub_size  Size of the \p pub buffer in bytes.
+ * \param pub_len   On success, number of bytes written to \p pub.
+ *
+ * \return          0 on success.
+ * \return          #MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH if the callback
+ *                  does not handle this key type. The library then uses
+ *                  PSA for the whole exchange.
+ * \return          Any other error aborts the handshake.
+ */
+typedef int mbedtls_ssl_ecdhe_gen_t(void *p_ecdhe,
+                                    psa_key_type_t key_type,
+                                    size_t key_bits,
+                                    void **key,
+                                    unsigned char *pub,
+                                    size_t pub_size,
+                                    size_t *pub_len);
+
+/**
+ * \brief           Callback type: compute the (EC)DHE shared secret.
+ *
+ *                  This callback is called instead of psa_raw_key_agreement()
+ *                  for keys returned by the generate callback. It releases
+ *                  the key, whether it succeeds or not.
+ *
+ * \param p_ecdhe   The context set with mbedtls_ssl_conf_ecdhe_cb().
+ * \param key       Handle returned by the generate callback.
+ * \param peer      Public key of the peer, as for psa_raw_key_agreement().
+ * \param peer_len  Size of \p peer in bytes.
+ * \param secret    Buffer for the shared secret.
+ * \param secret_size Size of the \p secret buffer in bytes.
+ * \param secret_len On success, number of bytes written to \p secret.
+ *
+ * \return          0 on success, or an error code that aborts the
+ *                  handshake.
+ */
+typedef int mbedtls_ssl_ecdhe_derive_t(void *p_ecdhe,
+                                       void *key,
+                                       const unsigned char *peer,
+                                       size_t peer_len,
+                                       unsigned char *secret,
+                                       size_t secret_size,
+                                       size_t *secret_len);
+
+/**
+ * \brief           Callback type: release an unused ephemeral key.
+ *
+ *                  This callback is called for keys returned by the generate
+ *                  callback that are never passed to the derive callback,
+ *                  e.g. after a HelloRetryRequest or when the handshake is
+ *                  aborted.
+ *
+ * \param p_ecdhe   The context set with mbedtls_ssl_conf_ecdhe_cb().
+ * \param key       Handle returned by the generate callback.
+ */
+typedef void mbedtls_ssl_ecdhe_free_t(void *p_ecdhe, void *key);
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
 #if defined(MBEDTLS_KEY_EXCHANGE_WITH_CERT_ENABLED) &&        \
     !defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
 #define MBEDTLS_SSL_PEER_CERT_DIGEST_MAX_LEN  48
@@ -1477,6 +1551,13 @@ struct mbedtls_ssl_config {
     void *MBEDTLS_PRIVATE(p_async_config_data); /*!< Configuration data set by mbedtls_ssl_conf_async_private_cb(). */
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+    mbedtls_ssl_ecdhe_gen_t *MBEDTLS_PRIVATE(f_ecdhe_gen);       /*!< generate ephemeral key pair */
+    mbedtls_ssl_ecdhe_derive_t *MBEDTLS_PRIVATE(f_ecdhe_derive); /*!< compute shared secret       */
+    mbedtls_ssl_ecdhe_free_t *MBEDTLS_PRIVATE(f_ecdhe_free);     /*!< release unused key          */
+    void *MBEDTLS_PRIVATE(p_ecdhe);                              /*!< context for the callbacks   */
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
 #if defined(MBEDTLS_SSL_HANDSHAKE_WITH_CERT_ENABLED)
     const uint16_t *MBEDTLS_PRIVATE(sig_algs);      /*!< allowed signature algorithms       */
 #endif /* MBEDTLS_SSL_HANDSHAKE_WITH_CERT_ENABLED */
@@ -1776,6 +1857,15 @@ struct mbedtls_ssl_context {
 
     unsigned char MBEDTLS_PRIVATE(cur_out_ctr)[MBEDTLS_SSL_SEQUENCE_NUMBER_LEN]; /*!<  Outgoing record sequence  number. */
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    mbedtls_ssl_buffer_acquire_t *MBEDTLS_PRIVATE(f_buf_acquire); /*!< record buffer pool,
+                                                                     NULL: heap            */
+    mbedtls_ssl_buffer_release_t *MBEDTLS_PRIVATE(f_buf_release); /*!< return to the pool */
+    void *MBEDTLS_PRIVATE(p_buf_pool);           /*!< context for the pool callbacks   */
+    unsigned char MBEDTLS_PRIVATE(in_ctr_saved)[MBEDTLS_SSL_SEQUENCE_NUMBER_LEN]; /*!< TLS incoming
+                                                    counter while in_buf is released */
+#endif /* MBEDTLS_SSL_BUFFER_POOL */
+
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     uint16_t MBEDTLS_PRIVATE(mtu);               /*!< path mtu, used to fragment outgoing messages */
 #endif /* MBEDTLS_SSL_PROTO_DTLS */
@@ -1927,6 +2017,59 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl,
  */
 int mbedtls_ssl_session_reset(mbedtls_ssl_context *ssl);
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+/**
+ * \brief          The type of record buffer acquire callbacks.
+ *
+ * \param p_pool   The opaque context passed to
+ *                 mbedtls_ssl_set_buffer_pool_cb().
+ * \param len      The length of the buffer needed, in bytes.
+ *
+ * \return         A buffer of at least \p len bytes, or \c NULL if none
+ *                 is available right now.
+ */
+typedef unsigned char *mbedtls_ssl_buffer_acquire_t(void *p_pool, size_t len);
+
+/**
+ * \brief          The type of record buffer release callbacks.
+ *
+ * \param p_pool   The opaque context passed to
+ *                 mbedtls_ssl_set_buffer_pool_cb().
+ * \param buf      A buffer returned by the acquire callback, already
+ *                 zeroized.
+ * \param len      The length it was acquired with.
+ */
+typedef void mbedtls_ssl_buffer_release_t(void *p_pool, unsigned char *buf, size_t len);
+
+/**
+ * \brief          Set the pool that record buffers come from.
+ *
+ *                 Contexts set up after this call take their input and
+ *                 output buffers from \p f_acquire instead of the heap.
+ *                 Once the handshake is over, they give both back whenever
+ *                 no record is partially read or written and no data is
+ *                 pending, which is the case between records and while
+ *                 mbedtls_ssl_read() waits for the network, and acquire them
+ *                 again on the next mbedtls_ssl_read(), mbedtls_ssl_write()
+ *                 or alert.
+ *
+ *                 When the pool is empty, these functions return
+ *                 #MBEDTLS_ERR_SSL_ALLOC_FAILED without changing the state
+ *                 of the connection, and can be called again later.
+ *
+ * \note           This is a global setting. Call it once at initialization
+ *                 time, before any context is set up, and keep the pool
+ *                 until every context using it is freed.
+ *
+ * \param f_acquire The acquire callback, or \c NULL to use the heap.
+ * \param f_release The release callback.
+ * \param p_pool   The opaque context to be passed to both callbacks.
+ */
+void mbedtls_ssl_set_buffer_pool_cb(mbedtls_ssl_buffer_acquire_t *f_acquire,
+                                    mbedtls_ssl_buffer_release_t *f_release,
+                                    void *p_pool);
+#endif /* MBEDTLS_SSL_BUFFER_POOL */
+
 /**
  * \brief          Set the current endpoint type
  *
@@ -2850,6 +2993,33 @@ void mbedtls_ssl_set_async_operation_data(mbedtls_ssl_context *ssl,
                                           void *ctx);
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+/**
+ * \brief           Configure callbacks that perform the ephemeral (EC)DH
+ *                  key exchange outside of PSA, e.g. in a secure element.
+ *
+ *                  They serve the TLS 1.2 client key exchange of the
+ *                  ECDHE suites and the TLS 1.3 key share. The generate
+ *                  callback can decline a key type, or one handshake, with
+ *                  #MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH.
+ *
+ * \param conf      SSL configuration context
+ * \param f_gen     Callback to generate a key pair, or \c NULL to use PSA.
+ *                  See ::mbedtls_ssl_ecdhe_gen_t.
+ * \param f_derive  Callback to compute the shared secret. See
+ *                  ::mbedtls_ssl_ecdhe_derive_t.
+ * \param f_free    Callback to release a key that was not used. See
+ *                  ::mbedtls_ssl_ecdhe_free_t.
+ * \param p_ecdhe   Context passed to the callbacks. The library stores
+ *                  this value without dereferencing it.
+ */
+void mbedtls_ssl_conf_ecdhe_cb(mbedtls_ssl_config *conf,
+                               mbedtls_ssl_ecdhe_gen_t *f_gen,
+                               mbedtls_ssl_ecdhe_derive_t *f_derive,
+                               mbedtls_ssl_ecdhe_free_t *f_free,
+                               void *p_ecdhe);
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
 /**
  * \brief          Callback type: generate a cookie
  *
@@ -4582,6 +4752,17 @@ int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl,
                             mbedtls_ssl_session *session);
 #endif /* MBEDTLS_SSL_CLI_C */
 
+/**
+ * \brief          Check whether the last completed handshake resumed a
+ *                 session.
+ *
+ * \param ssl      SSL context
+ *
+ * \return         \c 1 if the handshake resumed a session, for TLS 1.3 if
+ *                 it used a PSK key exchange, \c 0 otherwise.
+ */
+int mbedtls_ssl_session_resumed(const mbedtls_ssl_context *ssl);
+
 /**
  * \brief          Perform the SSL handshake
  *
@@ -4899,6 +5080,77 @@ int mbedtls_ssl_read(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len);
  */
 int mbedtls_ssl_write(mbedtls_ssl_context *ssl, const unsigned char *buf, size_t len);
 
+#if defined(MBEDTLS_SSL_ZERO_COPY)
+/**
+ * \brief          Read application data without copying it
+ *
+ *                 Like mbedtls_ssl_read(), but instead of copying the data
+ *                 out, points \p buf at the unread part of the current
+ *                 record in the input buffer. Call mbedtls_ssl_read_consume()
+ *                 once done with it.
+ *
+ * \param ssl      SSL context
+ * \param buf      On success, the first unread byte
+ *
+ * \return         The number of unread bytes at \p buf, 0 when the
+ *                 connection was closed, or any error code of
+ *                 mbedtls_ssl_read().
+ *
+ * \note           \p buf stays valid until mbedtls_ssl_read_consume() has
+ *                 consumed the whole record; no other function may be called
+ *                 on \p ssl meanwhile. Calling mbedtls_ssl_read_view() again
+ *                 before consuming anything returns the same view.
+ */
+int mbedtls_ssl_read_view(mbedtls_ssl_context *ssl, const unsigned char **buf);
+
+/**
+ * \brief          Consume application data returned by
+ *                 mbedtls_ssl_read_view()
+ *
+ * \param ssl      SSL context
+ * \param len      Number of bytes consumed, at most the value returned by
+ *                 the last mbedtls_ssl_read_view()
+ *
+ * \return         0 if successful, or #MBEDTLS_ERR_SSL_BAD_INPUT_DATA if
+ *                 \p len is larger than the unread data.
+ */
+int mbedtls_ssl_read_consume(mbedtls_ssl_context *ssl, size_t len);
+
+/**
+ * \brief          Get room for application data in the output buffer
+ *
+ *                 Points \p buf at the plaintext area of the next outgoing
+ *                 record, completing the handshake first if needed. Fill it
+ *                 and send it with mbedtls_ssl_write_commit(). The record is
+ *                 encrypted in place.
+ *
+ * \param ssl      SSL context
+ * \param buf      On success, where to write the plaintext
+ *
+ * \return         The number of bytes available at \p buf, or any error
+ *                 code of mbedtls_ssl_write().
+ *
+ * \note           No other function may be called on \p ssl between this
+ *                 function and mbedtls_ssl_write_commit().
+ */
+int mbedtls_ssl_write_view(mbedtls_ssl_context *ssl, unsigned char **buf);
+
+/**
+ * \brief          Send application data written by the application into
+ *                 the view returned by mbedtls_ssl_write_view()
+ *
+ * \param ssl      SSL context
+ * \param len      Number of bytes written, at most the value returned by
+ *                 mbedtls_ssl_write_view()
+ *
+ * \return         \p len if successful, or an error code as for
+ *                 mbedtls_ssl_write(). On #MBEDTLS_ERR_SSL_WANT_WRITE the
+ *                 record is already encrypted: call this function again with
+ *                 the same \p len, without writing to the view.
+ */
+int mbedtls_ssl_write_commit(mbedtls_ssl_context *ssl, size_t len);
+#endif /* MBEDTLS_SSL_ZERO_COPY */
+
 /**
  * \brief           Send an alert message
  *
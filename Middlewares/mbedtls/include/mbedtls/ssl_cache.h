@@ -59,6 +59,12 @@ struct mbedtls_ssl_cache_entry {
     size_t MBEDTLS_PRIVATE(session_len);
 
     mbedtls_ssl_cache_entry *MBEDTLS_PRIVATE(next);      /*!< chain pointer      */
+
+#if defined(MBEDTLS_SSL_CACHE_HASH_INDEX)
+    uint32_t MBEDTLS_PRIVATE(hash);                      /*!< hash of session ID */
+    unsigned char MBEDTLS_PRIVATE(in_use);               /*!< entry holds a session */
+    unsigned char MBEDTLS_PRIVATE(referenced);           /*!< clock reference bit */
+#endif
 };
 
 /**
@@ -68,6 +74,16 @@ struct mbedtls_ssl_cache_context {
     mbedtls_ssl_cache_entry *MBEDTLS_PRIVATE(chain);     /*!< start of the chain     */
     int MBEDTLS_PRIVATE(timeout);                /*!< cache entry timeout    */
     int MBEDTLS_PRIVATE(max_entries);            /*!< maximum entries        */
+#if defined(MBEDTLS_SSL_CACHE_HASH_INDEX)
+    mbedtls_ssl_cache_entry *MBEDTLS_PRIVATE(entries);   /*!< entry array            */
+    mbedtls_ssl_cache_entry **MBEDTLS_PRIVATE(index);    /*!< open-addressing index  */
+    size_t MBEDTLS_PRIVATE(capacity);            /*!< entries in the array   */
+    size_t MBEDTLS_PRIVATE(index_size);          /*!< index slots, power of 2 */
+    size_t MBEDTLS_PRIVATE(count);               /*!< entries in use         */
+    size_t MBEDTLS_PRIVATE(hand);                /*!< clock eviction hand    */
+    unsigned char *MBEDTLS_PRIVATE(pool);        /*!< session storage of a fixed pool, or NULL */
+    size_t MBEDTLS_PRIVATE(pool_session_len);    /*!< session slot size in the pool */
+#endif
 #if defined(MBEDTLS_THREADING_C)
     mbedtls_threading_mutex_t MBEDTLS_PRIVATE(mutex);    /*!< mutex                  */
 #endif
@@ -168,11 +184,42 @@ static inline int mbedtls_ssl_cache_get_timeout(mbedtls_ssl_cache_context *cache
  * \brief          Set the maximum number of cache entries
  *                 (Default: MBEDTLS_SSL_CACHE_DEFAULT_MAX_ENTRIES (50))
  *
+ * \note           With MBEDTLS_SSL_CACHE_HASH_INDEX, changing the maximum
+ *                 of a heap-backed cache in use drops all cached sessions.
+ *                 It has no effect on a cache using a fixed pool.
+ *
  * \param cache    SSL cache context
  * \param max      cache entry maximum
  */
 void mbedtls_ssl_cache_set_max_entries(mbedtls_ssl_cache_context *cache, int max);
 
+#if defined(MBEDTLS_SSL_CACHE_HASH_INDEX)
+/**
+ * \brief          Store cache entries and serialized sessions in a
+ *                 caller-provided buffer instead of the heap
+ *
+ *                 The number of entries is derived from \p buf_len and
+ *                 replaces the maximum set with
+ *                 mbedtls_ssl_cache_set_max_entries(). Sessions whose
+ *                 serialized form exceeds \p session_len are not cached.
+ *
+ * \note           Must be called before the first mbedtls_ssl_cache_set().
+ *                 \p buf must outlive the cache context.
+ *
+ * \param cache        SSL cache context
+ * \param buf          Buffer for entries, index and sessions
+ * \param buf_len      Size of \p buf in bytes
+ * \param session_len  Maximum serialized session size in bytes
+ *
+ * \return         \c 0 on success.
+ * \return         #MBEDTLS_ERR_SSL_BAD_INPUT_DATA if the cache is already in
+ *                 use or \p buf cannot hold a single entry.
+ */
+int mbedtls_ssl_cache_set_pool(mbedtls_ssl_cache_context *cache,
+                               unsigned char *buf, size_t buf_len,
+                               size_t session_len);
+#endif /* MBEDTLS_SSL_CACHE_HASH_INDEX */
+
 /**
  * \brief          Free referenced items in a cache context and clear memory
  *
@@ -812,6 +812,156 @@ int mbedtls_x509_crt_verify_with_ca_cb(mbedtls_x509_crt *crt,
 
 #endif /* MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK */
 
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+/**
+ * One certificate signature of a chain, collected for batch verification.
+ */
+typedef struct mbedtls_x509_crt_sig_item {
+    mbedtls_pk_context *pk;                  /**< Public key of the signer (parent) */
+    mbedtls_pk_sigalg_t sig_pk;              /**< Signature algorithm of the child */
+    mbedtls_md_type_t md_alg;                /**< Hash algorithm of the child signature */
+    unsigned char hash[MBEDTLS_MD_MAX_SIZE]; /**< Hash of the child's TBS part */
+    size_t hash_len;                         /**< Length of \c hash */
+    const unsigned char *sig;                /**< Child signature, as in the certificate */
+    size_t sig_len;                          /**< Length of \c sig */
+} mbedtls_x509_crt_sig_item;
+
+/**
+ * \brief          The type of batch eligibility callbacks.
+ *
+ * \param p_ctx    The opaque context passed to the batch callback.
+ * \param pk       The public key of the signer (parent).
+ * \param sig_pk   The signature algorithm of the child.
+ * \param md_alg   The hash algorithm of the child signature.
+ *
+ * \return         \c 0 if the batch callback can verify this signature, in
+ *                 which case it is left to the batch, or any non-zero value
+ *                 to verify it right away while the chain is built.
+ */
+typedef int (*mbedtls_x509_crt_batch_check_cb_t)(void *p_ctx,
+                                                 const mbedtls_pk_context *pk,
+                                                 mbedtls_pk_sigalg_t sig_pk,
+                                                 mbedtls_md_type_t md_alg);
+
+/**
+ * \brief          The type of batch signature verification callbacks.
+ *
+ * \param p_ctx    An opaque context passed to the callback.
+ * \param items    The signatures of every link of the chain, leaf first.
+ * \param count    The number of entries in \p items.
+ *
+ * \return         \c 0 if every signature is valid, or any non-zero value
+ *                 otherwise. A non-zero return is not fatal: the chain is
+ *                 then verified again one signature at a time so that the
+ *                 flags are reported for the exact certificate at fault.
+ */
+typedef int (*mbedtls_x509_crt_batch_verify_cb_t)(void *p_ctx,
+                                                  const mbedtls_x509_crt_sig_item *items,
+                                                  size_t count);
+
+/**
+ * \brief          Set the callback used to verify all signatures of a chain
+ *                 in one call.
+ *
+ *                 When set, chain building only checks that the parent key
+ *                 can produce the child signature type, and the signatures
+ *                 are verified together once the chain has been built.
+ *                 Signatures that \p f_check rejects are verified right
+ *                 away instead, so a chain \p f_batch cannot handle is not
+ *                 built twice. Restartable verification always uses the
+ *                 regular path.
+ *
+ * \note           This is a global setting. Call it once at initialization
+ *                 time, before any verification takes place.
+ *
+ * \param f_check  The batch eligibility callback, or \c NULL to leave every
+ *                 signature to \p f_batch.
+ * \param f_batch  The batch verification callback, or \c NULL to disable.
+ * \param p_batch  The opaque context to be passed to \p f_check and
+ *                 \p f_batch.
+ */
+void mbedtls_x509_crt_set_batch_verify_cb(mbedtls_x509_crt_batch_check_cb_t f_check,
+                                          mbedtls_x509_crt_batch_verify_cb_t f_batch,
+                                          void *p_batch);
+#endif /* MBEDTLS_X509_CRT_BATCH_VERIFY */
+
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+/**
+ * \brief          The type of verified-chain cache lookup callbacks.
+ *
+ * \param p_ctx    An opaque context passed to the callback.
+ * \param crt      The peer-provided chain, leaf first.
+ * \param trust_ca The trusted CAs of the verification, or \c NULL.
+ * \param f_ca_cb  The trusted CA callback of the verification, or \c NULL.
+ * \param p_ca_cb  The context of \p f_ca_cb.
+ * \param profile  The security profile of the verification.
+ * \param valid_from On a hit, the latest \c valid_from of the verified
+ *                 chain, trust anchor included.
+ * \param valid_to On a hit, the earliest \c valid_to of the verified
+ *                 chain, trust anchor included.
+ *
+ * \return         \c 0 if the chain verified successfully before against
+ *                 the same trusted CAs and \p profile, or any non-zero
+ *                 value to verify it normally.
+ */
+typedef int (*mbedtls_x509_crt_cache_lookup_cb_t)(void *p_ctx,
+                                                  const mbedtls_x509_crt *crt,
+                                                  const mbedtls_x509_crt *trust_ca,
+                                                  mbedtls_x509_crt_ca_cb_t f_ca_cb,
+                                                  const void *p_ca_cb,
+                                                  const mbedtls_x509_crt_profile *profile,
+                                                  mbedtls_x509_time *valid_from,
+                                                  mbedtls_x509_time *valid_to);
+
+/**
+ * \brief          The type of verified-chain cache store callbacks, called
+ *                 after a chain verified without any flag set.
+ *
+ * \param p_ctx    An opaque context passed to the callback.
+ * \param crt      The peer-provided chain, leaf first.
+ * \param trust_ca The trusted CAs of the verification, or \c NULL.
+ * \param f_ca_cb  The trusted CA callback of the verification, or \c NULL.
+ * \param p_ca_cb  The context of \p f_ca_cb.
+ * \param profile  The security profile of the verification.
+ * \param valid_from The latest \c valid_from of the verified chain.
+ * \param valid_to The earliest \c valid_to of the verified chain.
+ */
+typedef void (*mbedtls_x509_crt_cache_store_cb_t)(void *p_ctx,
+                                                  const mbedtls_x509_crt *crt,
+                                                  const mbedtls_x509_crt *trust_ca,
+                                                  mbedtls_x509_crt_ca_cb_t f_ca_cb,
+                                                  const void *p_ca_cb,
+                                                  const mbedtls_x509_crt_profile *profile,
+                                                  const mbedtls_x509_time *valid_from,
+                                                  const mbedtls_x509_time *valid_to);
+
+/**
+ * \brief          Set the callbacks of a verified-chain cache.
+ *
+ *                 On a hit, chain building and every signature check are
+ *                 skipped; the expected name and the end-entity key are
+ *                 still checked, and with MBEDTLS_HAVE_TIME_DATE so is the
+ *                 validity window returned by the cache. Verifications with
+ *                 a CRL, a verification callback or a restart context always
+ *                 take the regular path and are never stored.
+ *
+ * \note           This is a global setting. Call it once at initialization
+ *                 time, before any verification takes place. A chain must
+ *                 only be found again for the same trusted CAs it was
+ *                 stored with: the callbacks receive \c trust_ca, or
+ *                 \c f_ca_cb and \c p_ca_cb, for that purpose. A cache
+ *                 that identifies a CA callback by its context must forget
+ *                 its entries whenever the CAs behind it change.
+ *
+ * \param f_lookup The lookup callback, or \c NULL to disable the cache.
+ * \param f_store  The store callback, or \c NULL to never store.
+ * \param p_cache  The opaque context to be passed to both callbacks.
+ */
+void mbedtls_x509_crt_set_verify_cache_cb(mbedtls_x509_crt_cache_lookup_cb_t f_lookup,
+                                          mbedtls_x509_crt_cache_store_cb_t f_store,
+                                          void *p_cache);
+#endif /* MBEDTLS_X509_CRT_VERIFY_CACHE */
+
 /**
  * \brief          Check usage of certificate against keyUsage extension.
  *
@@ -59,6 +59,33 @@ typedef struct mbedtls_x509_csr {
 }
 mbedtls_x509_csr;
 
+#if defined(MBEDTLS_X509_CSR_WRITE_SIGN_CB)
+/**
+ * \brief          The type of external CSR signing callbacks.
+ *
+ * \param p_sign   An opaque context passed to the callback.
+ * \param sig_alg  The signature algorithm, matching the CSR key type.
+ * \param md_alg   The hash algorithm used to compute \p hash.
+ * \param hash     The hash of the CertificationRequestInfo.
+ * \param hash_len The length of \p hash.
+ * \param sig      The buffer receiving the signature, in the format
+ *                 mbedtls_pk_sign_ext() produces for \p sig_alg.
+ * \param sig_size The size of \p sig.
+ * \param sig_len  On success, the length of the signature.
+ *
+ * \return         \c 0 on success, or an error code that is returned by
+ *                 mbedtls_x509write_csr_der().
+ */
+typedef int (*mbedtls_x509write_csr_sign_cb_t)(void *p_sign,
+                                               mbedtls_pk_sigalg_t sig_alg,
+                                               mbedtls_md_type_t md_alg,
+                                               const unsigned char *hash,
+                                               size_t hash_len,
+                                               unsigned char *sig,
+                                               size_t sig_size,
+                                               size_t *sig_len);
+#endif /* MBEDTLS_X509_CSR_WRITE_SIGN_CB */
+
 /**
  * Container for writing a CSR
  */
@@ -67,6 +94,10 @@ typedef struct mbedtls_x509write_csr {
     mbedtls_asn1_named_data *MBEDTLS_PRIVATE(subject);
     mbedtls_md_type_t MBEDTLS_PRIVATE(md_alg);
     mbedtls_asn1_named_data *MBEDTLS_PRIVATE(extensions);
+#if defined(MBEDTLS_X509_CSR_WRITE_SIGN_CB)
+    mbedtls_x509write_csr_sign_cb_t MBEDTLS_PRIVATE(f_sign);
+    void *MBEDTLS_PRIVATE(p_sign);
+#endif
 }
 mbedtls_x509write_csr;
 
@@ -256,6 +287,23 @@ void mbedtls_x509write_csr_set_key(mbedtls_x509write_csr *ctx, mbedtls_pk_contex
  */
 void mbedtls_x509write_csr_set_md_alg(mbedtls_x509write_csr *ctx, mbedtls_md_type_t md_alg);
 
+#if defined(MBEDTLS_X509_CSR_WRITE_SIGN_CB)
+/**
+ * \brief           Set the callback that signs the CSR instead of the key
+ *
+ *                  The key set with mbedtls_x509write_csr_set_key() still
+ *                  provides the public key written in the CSR and selects the
+ *                  signature algorithm, but it can be public only.
+ *
+ * \param ctx       CSR context to use
+ * \param f_sign    Signing callback, or NULL to sign with the key
+ * \param p_sign    Context for \p f_sign
+ */
+void mbedtls_x509write_csr_set_sign_cb(mbedtls_x509write_csr *ctx,
+                                       mbedtls_x509write_csr_sign_cb_t f_sign,
+                                       void *p_sign);
+#endif /* MBEDTLS_X509_CSR_WRITE_SIGN_CB */
+
 /**
  * \brief           Set the Key Usage Extension flags
  *                  (e.g. MBEDTLS_X509_KU_DIGITAL_SIGNATURE | MBEDTLS_X509_KU_KEY_CERT_SIGN)
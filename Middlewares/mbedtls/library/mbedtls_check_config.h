@@ -292,6 +292,30 @@
 #error "MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK defined, but not all prerequisites"
 #endif
 
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY) && \
+            ( !defined(MBEDTLS_X509_CRT_PARSE_C) )
+#error "MBEDTLS_X509_CRT_BATCH_VERIFY defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE) && \
+            ( !defined(MBEDTLS_X509_CRT_PARSE_C) )
+#error "MBEDTLS_X509_CRT_VERIFY_CACHE defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_X509_CSR_WRITE_SIGN_CB) && \
+            ( !defined(MBEDTLS_X509_CSR_WRITE_C) )
+#error "MBEDTLS_X509_CSR_WRITE_SIGN_CB defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_CACHE_HASH_INDEX) && !defined(MBEDTLS_SSL_CACHE_C)
+#error "MBEDTLS_SSL_CACHE_HASH_INDEX defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_ECDHE_CB) && \
+    ( !defined(MBEDTLS_SSL_TLS_C) || !defined(PSA_WANT_ALG_ECDH) )
+#error "MBEDTLS_SSL_ECDHE_CB defined, but not all prerequisites"
+#endif
+
 #if defined(MBEDTLS_SSL_DTLS_SRTP) && ( !defined(MBEDTLS_SSL_PROTO_DTLS) )
 #error "MBEDTLS_SSL_DTLS_SRTP defined, but not all prerequisites"
 #endif
@@ -300,6 +324,15 @@
 #error "MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH defined, but not all prerequisites"
 #endif
 
+#if defined(MBEDTLS_SSL_IN_BUFFER_ON_DEMAND) && ( !defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH) )
+#error "MBEDTLS_SSL_IN_BUFFER_ON_DEMAND defined, but not all prerequisites"
+#endif
+
+#if defined(MBEDTLS_SSL_BUFFER_POOL) && ( !defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH) || \
+    defined(MBEDTLS_SSL_RENEGOTIATION) )
+#error "MBEDTLS_SSL_BUFFER_POOL defined, but not all prerequisites"
+#endif
+
 #if defined(MBEDTLS_SSL_RECORD_SIZE_LIMIT) && ( !defined(MBEDTLS_SSL_PROTO_TLS1_3) )
 #error "MBEDTLS_SSL_RECORD_SIZE_LIMIT defined, but not all prerequisites"
 #endif
@@ -740,6 +740,28 @@ int mbedtls_pkcs7_signed_hash_verify(mbedtls_pkcs7 *pkcs7,
     return mbedtls_pkcs7_data_or_hash_verify(pkcs7, cert, hash, hashlen, 1);
 }
 
+int mbedtls_pkcs7_get_md_alg(const mbedtls_pkcs7 *pkcs7, mbedtls_md_type_t *md_alg)
+{
+    if (pkcs7 == NULL || md_alg == NULL) {
+        return MBEDTLS_ERR_PKCS7_BAD_INPUT_DATA;
+    }
+    if (pkcs7->signed_data.no_of_signers == 0) {
+        return MBEDTLS_ERR_PKCS7_INVALID_SIGNER_INFO;
+    }
+    if (mbedtls_x509_oid_get_md_alg(&pkcs7->signed_data.digest_alg_identifiers, md_alg) != 0) {
+        return MBEDTLS_ERR_PKCS7_INVALID_ALG;
+    }
+    return 0;
+}
+
+mbedtls_x509_crt *mbedtls_pkcs7_get_certs(mbedtls_pkcs7 *pkcs7)
+{
+    if (pkcs7 == NULL || pkcs7->signed_data.no_of_certs == 0) {
+        return NULL;
+    }
+    return &pkcs7->signed_data.certs;
+}
+
 /*
  * Unallocate all pkcs7 data
  */
@@ -5,8 +5,9 @@
  *  SPDX-License-Identifier: Apache-2.0 OR GPL-2.0-or-later
  */
 /*
- * These session callbacks use a simple chained list
- * to store and retrieve the session information.
+ * These session callbacks use a simple chained list, or a hash-indexed
+ * entry array with MBEDTLS_SSL_CACHE_HASH_INDEX, to store and retrieve
+ * the session information.
  */
 
 #include "ssl_misc.h"
@@ -32,6 +33,220 @@ void mbedtls_ssl_cache_init(mbedtls_ssl_cache_context *cache)
 #endif
 }
 
+#if defined(MBEDTLS_SSL_CACHE_HASH_INDEX)
+/*
+ * Entries live in one array and are found through an open-addressing
+ * (linear probing) index over a hash of the session ID. Unused entries are
+ * linked through `next`, starting at `chain`. When the cache is full, a
+ * clock hand sweeps the array and evicts the first entry that is outdated
+ * or has not been read since the hand last passed it.
+ */
+
+#define SSL_CACHE_POOL_ALIGN 8
+
+/* FNV-1a over the session ID */
+static uint32_t ssl_cache_hash(unsigned char const *session_id,
+                               size_t session_id_len)
+{
+    uint32_t h = 0x811C9DC5u;
+    size_t i;
+
+    for (i = 0; i < session_id_len; i++) {
+        h ^= session_id[i];
+        h *= 0x01000193u;
+    }
+
+    return h;
+}
+
+/* Smallest power of two keeping the index at most half full */
+static size_t ssl_cache_index_size(size_t capacity)
+{
+    size_t size = 2;
+
+    while (size < 2 * capacity) {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+#if defined(MBEDTLS_HAVE_TIME)
+static int ssl_cache_entry_expired(const mbedtls_ssl_cache_context *cache,
+                                   const mbedtls_ssl_cache_entry *entry,
+                                   mbedtls_time_t t)
+{
+    return cache->timeout != 0 &&
+           (int) (t - entry->timestamp) > cache->timeout;
+}
+#endif /* MBEDTLS_HAVE_TIME */
+
+/* Mark all entries unused and clear the index */
+static void ssl_cache_reset(mbedtls_ssl_cache_context *cache)
+{
+    size_t i;
+
+    memset(cache->entries, 0, cache->capacity * sizeof(mbedtls_ssl_cache_entry));
+    memset(cache->index, 0, cache->index_size * sizeof(mbedtls_ssl_cache_entry *));
+
+    cache->chain = NULL;
+    for (i = cache->capacity; i > 0; i--) {
+        cache->entries[i - 1].next = cache->chain;
+        cache->chain = &cache->entries[i - 1];
+    }
+
+    cache->count = 0;
+    cache->hand = 0;
+}
+
+/* Allocate the entry array and the index on first use */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_cache_setup(mbedtls_ssl_cache_context *cache)
+{
+    if (cache->entries != NULL) {
+        return 0;
+    }
+
+    if (cache->max_entries <= 0) {
+        /* Same as an ill-configured chained cache */
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    cache->capacity = (size_t) cache->max_entries;
+    cache->index_size = ssl_cache_index_size(cache->capacity);
+
+    cache->entries = mbedtls_calloc(cache->capacity, sizeof(mbedtls_ssl_cache_entry));
+    cache->index = mbedtls_calloc(cache->index_size, sizeof(mbedtls_ssl_cache_entry *));
+    if (cache->entries == NULL || cache->index == NULL) {
+        mbedtls_free(cache->entries);
+        mbedtls_free(cache->index);
+        cache->entries = NULL;
+        cache->index = NULL;
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    ssl_cache_reset(cache);
+    return 0;
+}
+
+/*
+ * Return the index slot holding the entry for the given session ID, or the
+ * empty slot where it would be inserted. The index is never more than half
+ * full, so the probe always ends.
+ */
+static size_t ssl_cache_index_lookup(const mbedtls_ssl_cache_context *cache,
+                                     unsigned char const *session_id,
+                                     size_t session_id_len,
+                                     uint32_t hash)
+{
+    size_t mask = cache->index_size - 1;
+    size_t slot = hash & mask;
+    const mbedtls_ssl_cache_entry *cur;
+
+    while ((cur = cache->index[slot]) != NULL) {
+        if (cur->hash == hash &&
+            cur->session_id_len == session_id_len &&
+            memcmp(cur->session_id, session_id, session_id_len) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+/*
+ * Empty an index slot, moving later entries of the probe sequence back so
+ * that lookups never need tombstones.
+ */
+static void ssl_cache_index_delete(mbedtls_ssl_cache_context *cache, size_t slot)
+{
+    size_t mask = cache->index_size - 1;
+    size_t next = slot;
+    size_t home;
+    mbedtls_ssl_cache_entry *cur;
+
+    cache->index[slot] = NULL;
+
+    for (;;) {
+        next = (next + 1) & mask;
+        cur = cache->index[next];
+        if (cur == NULL) {
+            break;
+        }
+
+        /* Leave the entry alone if its home slot lies in (slot, next] */
+        home = cur->hash & mask;
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            cache->index[slot] = cur;
+            cache->index[next] = NULL;
+            slot = next;
+        }
+    }
+}
+
+/* Drop an entry from the index, zeroize it and put it on the free list */
+static void ssl_cache_entry_release(mbedtls_ssl_cache_context *cache,
+                                    mbedtls_ssl_cache_entry *entry)
+{
+    size_t slot;
+
+    if (!entry->in_use) {
+        return;
+    }
+
+    slot = ssl_cache_index_lookup(cache, entry->session_id,
+                                  entry->session_id_len, entry->hash);
+    if (cache->index[slot] == entry) {
+        ssl_cache_index_delete(cache, slot);
+    }
+
+    if (entry->session != NULL) {
+        if (cache->pool != NULL) {
+            mbedtls_platform_zeroize(entry->session, entry->session_len);
+        } else {
+            mbedtls_zeroize_and_free(entry->session, entry->session_len);
+        }
+    }
+
+    mbedtls_platform_zeroize(entry, sizeof(mbedtls_ssl_cache_entry));
+    entry->next = cache->chain;
+    cache->chain = entry;
+    cache->count--;
+}
+
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_cache_find_entry(mbedtls_ssl_cache_context *cache,
+                                unsigned char const *session_id,
+                                size_t session_id_len,
+                                mbedtls_ssl_cache_entry **dst)
+{
+    mbedtls_ssl_cache_entry *cur;
+    size_t slot;
+
+    if (cache->entries == NULL || cache->count == 0) {
+        return MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    }
+
+    slot = ssl_cache_index_lookup(cache, session_id, session_id_len,
+                                  ssl_cache_hash(session_id, session_id_len));
+    cur = cache->index[slot];
+    if (cur == NULL) {
+        return MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    }
+
+#if defined(MBEDTLS_HAVE_TIME)
+    if (ssl_cache_entry_expired(cache, cur, mbedtls_time(NULL))) {
+        ssl_cache_entry_release(cache, cur);
+        return MBEDTLS_ERR_SSL_CACHE_ENTRY_NOT_FOUND;
+    }
+#endif
+
+    cur->referenced = 1;
+    *dst = cur;
+    return 0;
+}
+#else /* MBEDTLS_SSL_CACHE_HASH_INDEX */
 MBEDTLS_CHECK_RETURN_CRITICAL
 static int ssl_cache_find_entry(mbedtls_ssl_cache_context *cache,
                                 unsigned char const *session_id,
@@ -68,7 +283,7 @@ static int ssl_cache_find_entry(mbedtls_ssl_cache_context *cache,
 
     return ret;
 }
-
+#endif /* MBEDTLS_SSL_CACHE_HASH_INDEX */
 
 int mbedtls_ssl_cache_get(void *data,
                           unsigned char const *session_id,
@@ -109,6 +324,7 @@ exit:
     return ret;
 }
 
+#if !defined(MBEDTLS_SSL_CACHE_HASH_INDEX)
 /* zeroize a cache entry */
 static void ssl_cache_entry_zeroize(mbedtls_ssl_cache_entry *entry)
 {
@@ -365,6 +581,173 @@ exit:
 
     return ret;
 }
+#else /* !MBEDTLS_SSL_CACHE_HASH_INDEX */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_cache_pick_writing_slot(mbedtls_ssl_cache_context *cache,
+                                       unsigned char const *session_id,
+                                       size_t session_id_len,
+                                       mbedtls_ssl_cache_entry **dst)
+{
+#if defined(MBEDTLS_HAVE_TIME)
+    mbedtls_time_t t = mbedtls_time(NULL);
+#endif
+    mbedtls_ssl_cache_entry *cur;
+    uint32_t hash;
+    size_t slot;
+    int ret;
+
+    if (session_id_len > sizeof(cur->session_id)) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    ret = ssl_cache_setup(cache);
+    if (ret != 0) {
+        return ret;
+    }
+
+    /* An entry with the same session ID is overwritten */
+    hash = ssl_cache_hash(session_id, session_id_len);
+    slot = ssl_cache_index_lookup(cache, session_id, session_id_len, hash);
+    if (cache->index[slot] != NULL) {
+        ssl_cache_entry_release(cache, cache->index[slot]);
+    }
+
+    if (cache->chain == NULL) {
+        /* Cache full: every entry is in use, so the hand stops within two
+         * turns. Outdated entries go first, recently read ones get a
+         * second chance. */
+        for (;;) {
+            cur = &cache->entries[cache->hand];
+            cache->hand = (cache->hand + 1) % cache->capacity;
+
+#if defined(MBEDTLS_HAVE_TIME)
+            if (ssl_cache_entry_expired(cache, cur, t)) {
+                break;
+            }
+#endif
+            if (!cur->referenced) {
+                break;
+            }
+            cur->referenced = 0;
+        }
+
+        ssl_cache_entry_release(cache, cur);
+    }
+
+    cur = cache->chain;
+    cache->chain = cur->next;
+    cur->next = NULL;
+
+    cur->in_use = 1;
+    cur->hash = hash;
+    cur->session_id_len = session_id_len;
+    memcpy(cur->session_id, session_id, session_id_len);
+#if defined(MBEDTLS_HAVE_TIME)
+    cur->timestamp = t;
+#endif
+    cache->count++;
+
+    /* Releases above may have shifted the index */
+    slot = ssl_cache_index_lookup(cache, session_id, session_id_len, hash);
+    cache->index[slot] = cur;
+
+    *dst = cur;
+    return 0;
+}
+
+int mbedtls_ssl_cache_set(void *data,
+                          unsigned char const *session_id,
+                          size_t session_id_len,
+                          const mbedtls_ssl_session *session)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_cache_context *cache = (mbedtls_ssl_cache_context *) data;
+    mbedtls_ssl_cache_entry *cur;
+    size_t session_serialized_len = 0;
+
+#if defined(MBEDTLS_THREADING_C)
+    if ((ret = mbedtls_mutex_lock(&cache->mutex)) != 0) {
+        return ret;
+    }
+#endif
+
+    ret = ssl_cache_pick_writing_slot(cache,
+                                      session_id, session_id_len,
+                                      &cur);
+    if (ret != 0) {
+        goto exit;
+    }
+
+    if (cache->pool != NULL) {
+        /* Serialize straight into the entry's slot of the pool */
+        cur->session = cache->pool +
+                       (size_t) (cur - cache->entries) * cache->pool_session_len;
+        ret = mbedtls_ssl_session_save(session, cur->session,
+                                       cache->pool_session_len,
+                                       &session_serialized_len);
+    } else {
+        ret = mbedtls_ssl_session_save(session, NULL, 0, &session_serialized_len);
+        if (ret == MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL) {
+            cur->session = mbedtls_calloc(1, session_serialized_len);
+            if (cur->session == NULL) {
+                ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
+            } else {
+                ret = mbedtls_ssl_session_save(session, cur->session,
+                                               session_serialized_len,
+                                               &session_serialized_len);
+            }
+        }
+    }
+
+    if (ret != 0) {
+        /* Never leave an entry without a valid session in the index */
+        cur->session_len = cache->pool != NULL ? cache->pool_session_len :
+                           session_serialized_len;
+        ssl_cache_entry_release(cache, cur);
+        goto exit;
+    }
+
+    cur->session_len = session_serialized_len;
+
+exit:
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_unlock(&cache->mutex) != 0) {
+        ret = MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    return ret;
+}
+
+int mbedtls_ssl_cache_remove(void *data,
+                             unsigned char const *session_id,
+                             size_t session_id_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    mbedtls_ssl_cache_context *cache = (mbedtls_ssl_cache_context *) data;
+    mbedtls_ssl_cache_entry *entry;
+
+#if defined(MBEDTLS_THREADING_C)
+    if ((ret = mbedtls_mutex_lock(&cache->mutex)) != 0) {
+        return ret;
+    }
+#endif
+
+    /* A missing entry is not an error */
+    if (ssl_cache_find_entry(cache, session_id, session_id_len, &entry) == 0) {
+        ssl_cache_entry_release(cache, entry);
+    }
+    ret = 0;
+
+#if defined(MBEDTLS_THREADING_C)
+    if (mbedtls_mutex_unlock(&cache->mutex) != 0) {
+        ret = MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+    }
+#endif
+
+    return ret;
+}
+#endif /* !MBEDTLS_SSL_CACHE_HASH_INDEX */
 
 #if defined(MBEDTLS_HAVE_TIME)
 void mbedtls_ssl_cache_set_timeout(mbedtls_ssl_cache_context *cache, int timeout)
@@ -377,6 +760,104 @@ void mbedtls_ssl_cache_set_timeout(mbedtls_ssl_cache_context *cache, int timeout
 }
 #endif /* MBEDTLS_HAVE_TIME */
 
+#if defined(MBEDTLS_SSL_CACHE_HASH_INDEX)
+void mbedtls_ssl_cache_set_max_entries(mbedtls_ssl_cache_context *cache, int max)
+{
+    size_t i;
+
+    if (max < 0) {
+        max = 0;
+    }
+
+    /* The capacity of a fixed pool cannot change */
+    if (cache->pool != NULL) {
+        return;
+    }
+
+    /* Resizing a heap-backed cache in use starts over empty */
+    if (cache->entries != NULL && (size_t) max != cache->capacity) {
+        for (i = 0; i < cache->capacity; i++) {
+            ssl_cache_entry_release(cache, &cache->entries[i]);
+        }
+        mbedtls_free(cache->entries);
+        mbedtls_free(cache->index);
+        cache->entries = NULL;
+        cache->index = NULL;
+        cache->chain = NULL;
+    }
+
+    cache->max_entries = max;
+}
+
+int mbedtls_ssl_cache_set_pool(mbedtls_ssl_cache_context *cache,
+                               unsigned char *buf, size_t buf_len,
+                               size_t session_len)
+{
+    size_t pad = (size_t) (-(uintptr_t) buf) & (SSL_CACHE_POOL_ALIGN - 1);
+    size_t capacity;
+    size_t index_size;
+
+    if (cache->entries != NULL || buf == NULL || buf_len <= pad || session_len == 0) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    buf += pad;
+    buf_len -= pad;
+    session_len = (session_len + SSL_CACHE_POOL_ALIGN - 1) &
+                  ~((size_t) SSL_CACHE_POOL_ALIGN - 1);
+
+    /* Layout: entries, index, then one session slot per entry */
+    capacity = buf_len / (sizeof(mbedtls_ssl_cache_entry) + session_len +
+                          2 * sizeof(mbedtls_ssl_cache_entry *));
+    for (; capacity > 0; capacity--) {
+        index_size = ssl_cache_index_size(capacity);
+        if (capacity * (sizeof(mbedtls_ssl_cache_entry) + session_len) +
+            index_size * sizeof(mbedtls_ssl_cache_entry *) <= buf_len) {
+            break;
+        }
+    }
+    if (capacity == 0) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    cache->entries = (mbedtls_ssl_cache_entry *) buf;
+    cache->index = (mbedtls_ssl_cache_entry **) (buf + capacity *
+                                                 sizeof(mbedtls_ssl_cache_entry));
+    cache->pool = (unsigned char *) (cache->index + index_size);
+    cache->pool_session_len = session_len;
+    cache->capacity = capacity;
+    cache->index_size = index_size;
+    cache->max_entries = (int) capacity;
+
+    memset(cache->pool, 0, capacity * session_len);
+    ssl_cache_reset(cache);
+
+    return 0;
+}
+
+void mbedtls_ssl_cache_free(mbedtls_ssl_cache_context *cache)
+{
+    size_t i;
+
+    if (cache->entries != NULL) {
+        for (i = 0; i < cache->capacity; i++) {
+            ssl_cache_entry_release(cache, &cache->entries[i]);
+        }
+        if (cache->pool == NULL) {
+            mbedtls_free(cache->entries);
+            mbedtls_free(cache->index);
+        }
+    }
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_free(&cache->mutex);
+#endif
+    cache->entries = NULL;
+    cache->index = NULL;
+    cache->pool = NULL;
+    cache->chain = NULL;
+}
+#else /* MBEDTLS_SSL_CACHE_HASH_INDEX */
 void mbedtls_ssl_cache_set_max_entries(mbedtls_ssl_cache_context *cache, int max)
 {
     if (max < 0) {
@@ -405,5 +886,6 @@ void mbedtls_ssl_cache_free(mbedtls_ssl_cache_context *cache)
 #endif
     cache->chain = NULL;
 }
+#endif /* MBEDTLS_SSL_CACHE_HASH_INDEX */
 
 #endif /* MBEDTLS_SSL_CACHE_C */
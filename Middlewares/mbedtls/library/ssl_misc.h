@@ -61,6 +61,9 @@ extern const mbedtls_error_pair_t psa_to_ssl_errors[7];
 typedef enum {
     /** Set if mbedtls_ssl_set_hostname() has been called. */
     MBEDTLS_SSL_CONTEXT_FLAG_HOSTNAME_SET = 1,
+    /** Set if the last handshake resumed a session, for TLS 1.3 if it used
+     * a PSK key exchange. */
+    MBEDTLS_SSL_CONTEXT_FLAG_SESSION_RESUMED = 2,
 } mbedtls_ssl_context_flags_t;
 
 /** Flags from ::mbedtls_ssl_context_flags_t to keep in
@@ -398,10 +401,18 @@ uint32_t mbedtls_ssl_get_extension_mask(unsigned int extension_type);
 
 /* Calculate buffer sizes */
 
+/* Alignment of the payload of TLS records in their buffer */
+#if defined(MBEDTLS_SSL_ALIGNED_RECORDS)
+#define MBEDTLS_SSL_RECORD_ALIGN 16
+#else
+#define MBEDTLS_SSL_RECORD_ALIGN 1
+#endif
+
 /* Note: Even though the TLS record header is only 5 bytes
    long, we're internally using 8 bytes to store the
-   implicit sequence number. */
-#define MBEDTLS_SSL_HEADER_LEN 13
+   implicit sequence number. Aligned records may start
+   up to MBEDTLS_SSL_RECORD_ALIGN - 1 bytes later. */
+#define MBEDTLS_SSL_HEADER_LEN (13 + MBEDTLS_SSL_RECORD_ALIGN - 1)
 
 #if !defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
 #define MBEDTLS_SSL_IN_BUFFER_LEN  \
@@ -782,6 +793,10 @@ struct mbedtls_ssl_handshake_params {
     uint8_t xxdh_psa_privkey_is_external;
     unsigned char xxdh_psa_peerkey[PSA_EXPORT_PUBLIC_KEY_MAX_SIZE];
     size_t xxdh_psa_peerkey_len;
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+    void *ecdhe_key;        /*!< key from f_ecdhe_gen, NULL when PSA
+                                 holds the key in xxdh_psa_privkey */
+#endif /* MBEDTLS_SSL_ECDHE_CB */
 #endif /* MBEDTLS_KEY_EXCHANGE_SOME_XXDH_PSA_ANY_ENABLED */
 
 #if defined(MBEDTLS_KEY_EXCHANGE_ECJPAKE_ENABLED)
@@ -1777,6 +1792,49 @@ int mbedtls_ssl_check_timer(mbedtls_ssl_context *ssl);
 
 void mbedtls_ssl_reset_in_pointers(mbedtls_ssl_context *ssl);
 void mbedtls_ssl_update_in_pointers(mbedtls_ssl_context *ssl);
+
+#if defined(MBEDTLS_SSL_IN_BUFFER_ON_DEMAND)
+/*
+ * Grow the input buffer so that it holds at least `needed` bytes from
+ * its start, if MBEDTLS_SSL_IN_BUFFER_LEN allows it.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_grow_in_buffer(mbedtls_ssl_context *ssl, size_t needed);
+#endif /* MBEDTLS_SSL_IN_BUFFER_ON_DEMAND */
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+/*
+ * Take the record buffers back from the pool if they were released.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_buffers_acquire(mbedtls_ssl_context *ssl);
+/*
+ * Give the record buffers back to the pool if the handshake is over and
+ * nothing is pending in either direction.
+ */
+void mbedtls_ssl_buffers_release_idle(mbedtls_ssl_context *ssl);
+#endif /* MBEDTLS_SSL_BUFFER_POOL */
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+/*
+ * Generate the ephemeral key pair with the f_ecdhe_gen callback and write
+ * its public part to `pub`. Returns MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH if
+ * there is no callback or it declined, in which case PSA is used.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_ecdhe_gen(mbedtls_ssl_context *ssl,
+                          unsigned char *pub, size_t pub_size, size_t *pub_len);
+/*
+ * Compute the shared secret with the key from mbedtls_ssl_ecdhe_gen() and
+ * release it. Returns MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH if the key is
+ * held by PSA.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+int mbedtls_ssl_ecdhe_derive(mbedtls_ssl_context *ssl, unsigned char *secret,
+                             size_t secret_size, size_t *secret_len);
+/*
+ * Release the key from mbedtls_ssl_ecdhe_gen() if it was not used.
+ */
+void mbedtls_ssl_ecdhe_free(mbedtls_ssl_context *ssl);
+#endif /* MBEDTLS_SSL_ECDHE_CB */
 void mbedtls_ssl_reset_out_pointers(mbedtls_ssl_context *ssl);
 void mbedtls_ssl_update_out_pointers(mbedtls_ssl_context *ssl,
                                      mbedtls_ssl_transform *transform);
@@ -3072,6 +3072,14 @@ int mbedtls_ssl_prepare_handshake_record(mbedtls_ssl_context *ssl)
                                    (void *) ssl->in_buf, in_buf_len));
             return MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
         }
+#if defined(MBEDTLS_SSL_ALIGNED_RECORDS)
+        /* An aligned record may start after the reassembly point; bring its
+         * header along before the payload can overwrite it. */
+        if (ssl->in_hsfraglen == 0 && ssl->in_hdr != reassembled_record_start) {
+            memmove(reassembled_record_start, ssl->in_hdr,
+                    mbedtls_ssl_in_hdr_len(ssl));
+        }
+#endif
         memmove(payload_end, ssl->in_msg, ssl->in_msglen);
 
         ssl->in_hsfraglen += ssl->in_msglen;
@@ -4681,6 +4689,17 @@ static int ssl_get_next_record(mbedtls_ssl_context *ssl)
     }
 #endif /* MBEDTLS_SSL_PROTO_DTLS */
 
+#if defined(MBEDTLS_SSL_ALIGNED_RECORDS)
+    /* Unless part of a record or of a handshake message is already in the
+     * buffer, fetch the record where its payload will be aligned. */
+    if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM &&
+        ssl->in_left == 0 && ssl->in_hsfraglen == 0) {
+        ssl->in_hdr = ssl->in_buf +
+                      ssl_aligned_hdr_offset(ssl->in_buf, ssl->transform_in);
+        mbedtls_ssl_update_in_pointers(ssl);
+    }
+#endif
+
     /* Ensure that we have enough space available for the default form
      * of TLS / DTLS record headers (5 Bytes for TLS, 13 Bytes for DTLS,
      * with no space for CIDs counted in). */
@@ -4759,6 +4778,17 @@ static int ssl_get_next_record(mbedtls_ssl_context *ssl)
     } else
 #endif
     {
+#if defined(MBEDTLS_SSL_IN_BUFFER_ON_DEMAND)
+        /* Make room for a record larger than the input buffer */
+        ret = mbedtls_ssl_grow_in_buffer(ssl,
+                                         (size_t) (ssl->in_hdr - ssl->in_buf) + rec.buf_len);
+        if (ret != 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_grow_in_buffer", ret);
+            return ret;
+        }
+        rec.buf = ssl->in_hdr;
+#endif /* MBEDTLS_SSL_IN_BUFFER_ON_DEMAND */
+
         /*
          * Fetch record contents from underlying transport.
          */
@@ -4995,6 +5025,12 @@ int mbedtls_ssl_send_alert_message(mbedtls_ssl_context *ssl,
         return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
     }
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    if ((ret = mbedtls_ssl_buffers_acquire(ssl)) != 0) {
+        return ret;
+    }
+#endif
+
     if (ssl->out_left != 0) {
         return mbedtls_ssl_flush_output(ssl);
     }
@@ -5109,6 +5145,27 @@ static size_t ssl_transform_get_explicit_iv_len(
     return transform->ivlen - transform->fixed_ivlen;
 }
 
+#if defined(MBEDTLS_SSL_ALIGNED_RECORDS)
+/*
+ * Offset of the header of the next TLS record from the start of buf such
+ * that the record payload, after the explicit IV of transform if any, is
+ * aligned to MBEDTLS_SSL_RECORD_ALIGN. The implicit sequence number keeps
+ * the first 8 bytes of buf.
+ */
+static size_t ssl_aligned_hdr_offset(const unsigned char *buf,
+                                     mbedtls_ssl_transform const *transform)
+{
+    size_t payload = MBEDTLS_SSL_SEQUENCE_NUMBER_LEN + 5;
+
+    if (transform != NULL) {
+        payload += ssl_transform_get_explicit_iv_len(transform);
+    }
+
+    return MBEDTLS_SSL_SEQUENCE_NUMBER_LEN +
+           ((0 - (uintptr_t) (buf + payload)) & (MBEDTLS_SSL_RECORD_ALIGN - 1));
+}
+#endif /* MBEDTLS_SSL_ALIGNED_RECORDS */
+
 void mbedtls_ssl_update_out_pointers(mbedtls_ssl_context *ssl,
                                      mbedtls_ssl_transform *transform)
 {
@@ -5128,6 +5185,13 @@ void mbedtls_ssl_update_out_pointers(mbedtls_ssl_context *ssl,
     } else
 #endif
     {
+#if defined(MBEDTLS_SSL_ALIGNED_RECORDS)
+        /* With nothing left to send, the next record may move */
+        if (ssl->out_left == 0) {
+            ssl->out_hdr = ssl->out_buf +
+                           ssl_aligned_hdr_offset(ssl->out_buf, transform);
+        }
+#endif
         ssl->out_len = ssl->out_hdr + 3;
 #if defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
         ssl->out_cid = ssl->out_len;
@@ -5536,6 +5600,27 @@ static int ssl_handle_hs_message_post_handshake(mbedtls_ssl_context *ssl)
     return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
 }
 
+/*
+ * Mark the first n bytes of unread application data as read and erase them.
+ */
+static void ssl_consume_application_data(mbedtls_ssl_context *ssl, size_t n)
+{
+    ssl->in_msglen -= n;
+
+    /* Zeroising the plaintext buffer to erase unused application data
+       from the memory. */
+    mbedtls_platform_zeroize(ssl->in_offt, n);
+
+    if (ssl->in_msglen == 0) {
+        /* all bytes consumed */
+        ssl->in_offt = NULL;
+        ssl->keep_current_message = 0;
+    } else {
+        /* more data available */
+        ssl->in_offt += n;
+    }
+}
+
 /*
  * brief          Read at most 'len' application data bytes from the input
  *                buffer.
@@ -5559,38 +5644,22 @@ static int ssl_read_application_data(
 
     if (len != 0) {
         memcpy(buf, ssl->in_offt, n);
-        ssl->in_msglen -= n;
     }
 
-    /* Zeroising the plaintext buffer to erase unused application data
-       from the memory. */
-    mbedtls_platform_zeroize(ssl->in_offt, n);
-
-    if (ssl->in_msglen == 0) {
-        /* all bytes consumed */
-        ssl->in_offt = NULL;
-        ssl->keep_current_message = 0;
-    } else {
-        /* more data available */
-        ssl->in_offt += n;
-    }
+    ssl_consume_application_data(ssl, n);
 
     return (int) n;
 }
 
 /*
- * Receive application data decrypted from the SSL layer
+ * Process records until application data is available at in_offt.
+ * Returns MBEDTLS_ERR_SSL_CONN_EOF when the connection was closed.
  */
-int mbedtls_ssl_read(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len)
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_read_prepare(mbedtls_ssl_context *ssl)
 {
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
 
-    if (ssl == NULL || ssl->conf == NULL) {
-        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
-    }
-
-    MBEDTLS_SSL_DEBUG_MSG(2, ("=> read"));
-
 #if defined(MBEDTLS_SSL_PROTO_DTLS)
     if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
         if ((ret = mbedtls_ssl_flush_output(ssl)) != 0) {
@@ -5636,6 +5705,13 @@ int mbedtls_ssl_read(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len)
         }
     }
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    /* A completed handshake gives the buffers back */
+    if ((ret = mbedtls_ssl_buffers_acquire(ssl)) != 0) {
+        return ret;
+    }
+#endif
+
     /* Loop as long as no application data record is available */
     while (ssl->in_offt == NULL) {
         /* Start timer if not already running */
@@ -5646,7 +5722,7 @@ int mbedtls_ssl_read(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len)
 
         if ((ret = mbedtls_ssl_read_record(ssl, 1)) != 0) {
             if (ret == MBEDTLS_ERR_SSL_CONN_EOF) {
-                return 0;
+                return ret;
             }
 
             MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_read_record", ret);
@@ -5660,7 +5736,7 @@ int mbedtls_ssl_read(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len)
              */
             if ((ret = mbedtls_ssl_read_record(ssl, 1)) != 0) {
                 if (ret == MBEDTLS_ERR_SSL_CONN_EOF) {
-                    return 0;
+                    return ret;
                 }
 
                 MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_read_record", ret);
@@ -5747,13 +5823,97 @@ int mbedtls_ssl_read(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len)
 #endif /* MBEDTLS_SSL_PROTO_DTLS */
     }
 
-    ret = ssl_read_application_data(ssl, buf, len);
+    return 0;
+}
+
+int mbedtls_ssl_read(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
+    if (ssl == NULL || ssl->conf == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    if ((ret = mbedtls_ssl_buffers_acquire(ssl)) != 0) {
+        return ret;
+    }
+#endif
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("=> read"));
+
+    ret = ssl_read_prepare(ssl);
+    if (ret == 0) {
+        ret = ssl_read_application_data(ssl, buf, len);
+    } else if (ret == MBEDTLS_ERR_SSL_CONN_EOF) {
+        ret = 0;
+    }
+
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    /* Waiting for the next record costs no buffer */
+    mbedtls_ssl_buffers_release_idle(ssl);
+#endif
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("<= read"));
 
     return ret;
 }
 
+#if defined(MBEDTLS_SSL_ZERO_COPY)
+int mbedtls_ssl_read_view(mbedtls_ssl_context *ssl, const unsigned char **buf)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
+    if (ssl == NULL || ssl->conf == NULL || buf == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    if ((ret = mbedtls_ssl_buffers_acquire(ssl)) != 0) {
+        return ret;
+    }
+#endif
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("=> read view"));
+
+    ret = ssl_read_prepare(ssl);
+    if (ret == 0) {
+        /* The record stays in the input buffer until it is consumed */
+        *buf = ssl->in_offt;
+        ret = (int) ssl->in_msglen;
+    } else if (ret == MBEDTLS_ERR_SSL_CONN_EOF) {
+        ret = 0;
+    }
+
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    mbedtls_ssl_buffers_release_idle(ssl);
+#endif
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("<= read view"));
+
+    return ret;
+}
+
+int mbedtls_ssl_read_consume(mbedtls_ssl_context *ssl, size_t len)
+{
+    if (ssl == NULL || ssl->conf == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (ssl->in_offt == NULL || len > ssl->in_msglen) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    ssl_consume_application_data(ssl, len);
+
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    mbedtls_ssl_buffers_release_idle(ssl);
+#endif
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_ZERO_COPY */
+
 #if defined(MBEDTLS_SSL_SRV_C) && defined(MBEDTLS_SSL_EARLY_DATA)
 int mbedtls_ssl_read_early_data(mbedtls_ssl_context *ssl,
                                 unsigned char *buf, size_t len)
@@ -5831,7 +5991,8 @@ static int ssl_write_real(mbedtls_ssl_context *ssl,
          */
         ssl->out_msglen  = len;
         ssl->out_msgtype = MBEDTLS_SSL_MSG_APPLICATION_DATA;
-        if (len > 0) {
+        /* Zero-copy writes already put the data in place */
+        if (len > 0 && buf != ssl->out_msg) {
             memcpy(ssl->out_msg, buf, len);
         }
 
@@ -5871,13 +6032,102 @@ int mbedtls_ssl_write(mbedtls_ssl_context *ssl, const unsigned char *buf, size_t
         }
     }
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    /* After the handshake, which gives the buffers back when it completes */
+    if ((ret = mbedtls_ssl_buffers_acquire(ssl)) != 0) {
+        return ret;
+    }
+#endif
+
     ret = ssl_write_real(ssl, buf, len);
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    mbedtls_ssl_buffers_release_idle(ssl);
+#endif
+
     MBEDTLS_SSL_DEBUG_MSG(2, ("<= write"));
 
     return ret;
 }
 
+#if defined(MBEDTLS_SSL_ZERO_COPY)
+int mbedtls_ssl_write_view(mbedtls_ssl_context *ssl, unsigned char **buf)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("=> write view"));
+
+    if (ssl == NULL || ssl->conf == NULL || buf == NULL) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    if (ssl->state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+        if ((ret = mbedtls_ssl_handshake(ssl)) != 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_handshake", ret);
+            return ret;
+        }
+    }
+
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    if ((ret = mbedtls_ssl_buffers_acquire(ssl)) != 0) {
+        return ret;
+    }
+#endif
+
+    /* The view must not overlap a record still being sent */
+    if (ssl->out_left != 0) {
+        if ((ret = mbedtls_ssl_flush_output(ssl)) != 0) {
+            MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_flush_output", ret);
+            return ret;
+        }
+    }
+
+    ret = mbedtls_ssl_get_max_out_record_payload(ssl);
+    if (ret < 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_get_max_out_record_payload", ret);
+        return ret;
+    }
+
+    *buf = ssl->out_msg;
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("<= write view"));
+
+    return ret;
+}
+
+int mbedtls_ssl_write_commit(mbedtls_ssl_context *ssl, size_t len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("=> write commit"));
+
+    if (ssl == NULL || ssl->conf == NULL || ssl->out_buf == NULL ||
+        ssl->state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    ret = mbedtls_ssl_get_max_out_record_payload(ssl);
+    if (ret < 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "mbedtls_ssl_get_max_out_record_payload", ret);
+        return ret;
+    }
+    if (len > (size_t) ret) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    /* Encrypts in place, or finishes sending after WANT_WRITE */
+    ret = ssl_write_real(ssl, ssl->out_msg, len);
+
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    mbedtls_ssl_buffers_release_idle(ssl);
+#endif
+
+    MBEDTLS_SSL_DEBUG_MSG(2, ("<= write commit"));
+
+    return ret;
+}
+#endif /* MBEDTLS_SSL_ZERO_COPY */
+
 #if defined(MBEDTLS_SSL_EARLY_DATA) && defined(MBEDTLS_SSL_CLI_C)
 int mbedtls_ssl_write_early_data(mbedtls_ssl_context *ssl,
                                  const unsigned char *buf, size_t len)
@@ -6005,6 +6255,10 @@ int mbedtls_ssl_close_notify(mbedtls_ssl_context *ssl)
         }
     }
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    mbedtls_ssl_buffers_release_idle(ssl);
+#endif
+
     MBEDTLS_SSL_DEBUG_MSG(2, ("<= write close notify"));
 
     return 0;
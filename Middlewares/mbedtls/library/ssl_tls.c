@@ -312,11 +312,64 @@ int mbedtls_ssl_session_copy(mbedtls_ssl_session *dst,
     return 0;
 }
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+static mbedtls_ssl_buffer_acquire_t *ssl_buffer_pool_acquire = NULL;
+static mbedtls_ssl_buffer_release_t *ssl_buffer_pool_release = NULL;
+static void *ssl_buffer_pool_ctx = NULL;
+
+void mbedtls_ssl_set_buffer_pool_cb(mbedtls_ssl_buffer_acquire_t *f_acquire,
+                                    mbedtls_ssl_buffer_release_t *f_release,
+                                    void *p_pool)
+{
+    ssl_buffer_pool_acquire = f_acquire;
+    ssl_buffer_pool_release = f_release;
+    ssl_buffer_pool_ctx = p_pool;
+}
+#endif /* MBEDTLS_SSL_BUFFER_POOL */
+
+/*
+ * Record buffers come from the pool of the context if it has one, from the
+ * heap otherwise. Both are zeroized, like mbedtls_calloc().
+ */
+static unsigned char *ssl_buffer_alloc(mbedtls_ssl_context *ssl, size_t len)
+{
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    if (ssl->f_buf_acquire != NULL) {
+        unsigned char *buf = ssl->f_buf_acquire(ssl->p_buf_pool, len);
+        if (buf != NULL) {
+            memset(buf, 0, len);
+        }
+        return buf;
+    }
+#else
+    (void) ssl;
+#endif
+    return mbedtls_calloc(1, len);
+}
+
+static void ssl_buffer_free(mbedtls_ssl_context *ssl, unsigned char *buf, size_t len)
+{
+    if (buf == NULL) {
+        return;
+    }
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    if (ssl->f_buf_acquire != NULL) {
+        mbedtls_platform_zeroize(buf, len);
+        ssl->f_buf_release(ssl->p_buf_pool, buf, len);
+        return;
+    }
+#else
+    (void) ssl;
+#endif
+    mbedtls_zeroize_and_free(buf, len);
+}
+
 #if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
 MBEDTLS_CHECK_RETURN_CRITICAL
-static int resize_buffer(unsigned char **buffer, size_t len_new, size_t *len_old)
+static int resize_buffer(mbedtls_ssl_context *ssl, unsigned char **buffer,
+                         size_t len_new, size_t *len_old)
 {
-    unsigned char *resized_buffer = mbedtls_calloc(1, len_new);
+    unsigned char *resized_buffer = ssl_buffer_alloc(ssl, len_new);
     if (resized_buffer == NULL) {
         return MBEDTLS_ERR_SSL_ALLOC_FAILED;
     }
@@ -327,7 +380,7 @@ static int resize_buffer(unsigned char **buffer, size_t len_new, size_t *len_old
      * lost, are done outside of this function. */
     memcpy(resized_buffer, *buffer,
            (len_new < *len_old) ? len_new : *len_old);
-    mbedtls_zeroize_and_free(*buffer, *len_old);
+    ssl_buffer_free(ssl, *buffer, *len_old);
 
     *buffer = resized_buffer;
     *len_old = len_new;
@@ -341,7 +394,7 @@ static void handle_buffer_resizing(mbedtls_ssl_context *ssl, int downsizing,
 {
     int modified = 0;
     size_t written_in = 0, iv_offset_in = 0, len_offset_in = 0, hdr_in = 0;
-    size_t written_out = 0, iv_offset_out = 0, len_offset_out = 0;
+    size_t written_out = 0, iv_offset_out = 0, len_offset_out = 0, hdr_out = 0;
     if (ssl->in_buf != NULL) {
         written_in = ssl->in_msg - ssl->in_buf;
         iv_offset_in = ssl->in_iv - ssl->in_buf;
@@ -350,7 +403,7 @@ static void handle_buffer_resizing(mbedtls_ssl_context *ssl, int downsizing,
         if (downsizing ?
             ssl->in_buf_len > in_buf_new_len && ssl->in_left < in_buf_new_len :
             ssl->in_buf_len < in_buf_new_len) {
-            if (resize_buffer(&ssl->in_buf, in_buf_new_len, &ssl->in_buf_len) != 0) {
+            if (resize_buffer(ssl, &ssl->in_buf, in_buf_new_len, &ssl->in_buf_len) != 0) {
                 MBEDTLS_SSL_DEBUG_MSG(1, ("input buffer resizing failed - out of memory"));
             } else {
                 MBEDTLS_SSL_DEBUG_MSG(2, ("Reallocating in_buf to %" MBEDTLS_PRINTF_SIZET,
@@ -364,10 +417,11 @@ static void handle_buffer_resizing(mbedtls_ssl_context *ssl, int downsizing,
         written_out = ssl->out_msg - ssl->out_buf;
         iv_offset_out = ssl->out_iv - ssl->out_buf;
         len_offset_out = ssl->out_len - ssl->out_buf;
+        hdr_out = ssl->out_hdr - ssl->out_buf;
         if (downsizing ?
             ssl->out_buf_len > out_buf_new_len && ssl->out_left < out_buf_new_len :
             ssl->out_buf_len < out_buf_new_len) {
-            if (resize_buffer(&ssl->out_buf, out_buf_new_len, &ssl->out_buf_len) != 0) {
+            if (resize_buffer(ssl, &ssl->out_buf, out_buf_new_len, &ssl->out_buf_len) != 0) {
                 MBEDTLS_SSL_DEBUG_MSG(1, ("output buffer resizing failed - out of memory"));
             } else {
                 MBEDTLS_SSL_DEBUG_MSG(2, ("Reallocating out_buf to %" MBEDTLS_PRINTF_SIZET,
@@ -384,6 +438,7 @@ static void handle_buffer_resizing(mbedtls_ssl_context *ssl, int downsizing,
 
         /* Fields below might not be properly updated with record
          * splitting or with CID, so they are manually updated here. */
+        ssl->out_hdr = ssl->out_buf + hdr_out;
         ssl->out_msg = ssl->out_buf + written_out;
         ssl->out_len = ssl->out_buf + len_offset_out;
         ssl->out_iv = ssl->out_buf + iv_offset_out;
@@ -393,8 +448,148 @@ static void handle_buffer_resizing(mbedtls_ssl_context *ssl, int downsizing,
         ssl->in_iv = ssl->in_buf + iv_offset_in;
     }
 }
+
+#if defined(MBEDTLS_SSL_IN_BUFFER_ON_DEMAND)
+/*
+ * Input buffer size to start a connection or a handshake with: enough for
+ * the configured maximum fragment length
+ */
+static size_t ssl_get_initial_in_buflen(const mbedtls_ssl_config *conf)
+{
+    size_t len;
+
+    if (conf->transport != MBEDTLS_SSL_TRANSPORT_STREAM) {
+        return MBEDTLS_SSL_IN_BUFFER_LEN;
+    }
+
+    len = ssl_mfl_code_to_length(conf->mfl_code)
+          + MBEDTLS_SSL_HEADER_LEN + MBEDTLS_SSL_PAYLOAD_OVERHEAD;
+    return len < MBEDTLS_SSL_IN_BUFFER_LEN ? len : MBEDTLS_SSL_IN_BUFFER_LEN;
+}
+
+int mbedtls_ssl_grow_in_buffer(mbedtls_ssl_context *ssl, size_t needed)
+{
+    size_t new_len;
+    size_t offt_offset = 0;
+
+    if (needed <= ssl->in_buf_len || needed > MBEDTLS_SSL_IN_BUFFER_LEN) {
+        /* Fits already, or never will: the usual length checks report it */
+        return 0;
+    }
+
+    /* Grow geometrically, so that a peer sending ever larger records costs
+     * a few reallocations rather than one per record */
+    new_len = ssl->in_buf_len * 2;
+    if (new_len < needed) {
+        new_len = needed;
+    }
+    if (new_len > MBEDTLS_SSL_IN_BUFFER_LEN) {
+        new_len = MBEDTLS_SSL_IN_BUFFER_LEN;
+    }
+
+    if (ssl->in_offt != NULL) {
+        offt_offset = (size_t) (ssl->in_offt - ssl->in_buf);
+    }
+
+    handle_buffer_resizing(ssl, 0, new_len, ssl->out_buf_len);
+
+    if (ssl->in_offt != NULL) {
+        ssl->in_offt = ssl->in_buf + offt_offset;
+    }
+
+    if (ssl->in_buf_len < needed) {
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    return 0;
+}
+#endif /* MBEDTLS_SSL_IN_BUFFER_ON_DEMAND */
 #endif /* MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH */
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+int mbedtls_ssl_buffers_acquire(mbedtls_ssl_context *ssl)
+{
+    if (ssl->in_buf != NULL || ssl->f_buf_acquire == NULL) {
+        return 0;
+    }
+
+    ssl->in_buf = ssl_buffer_alloc(ssl, ssl->in_buf_len);
+    ssl->out_buf = ssl_buffer_alloc(ssl, ssl->out_buf_len);
+    if (ssl->in_buf == NULL || ssl->out_buf == NULL) {
+        MBEDTLS_SSL_DEBUG_MSG(2, ("record buffer pool exhausted"));
+        ssl_buffer_free(ssl, ssl->in_buf, ssl->in_buf_len);
+        ssl_buffer_free(ssl, ssl->out_buf, ssl->out_buf_len);
+        ssl->in_buf = NULL;
+        ssl->out_buf = NULL;
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+
+    mbedtls_ssl_reset_in_pointers(ssl);
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+    if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM)
+#endif
+    {
+        /* TLS keeps the incoming record counter in front of the record */
+        memcpy(ssl->in_ctr, ssl->in_ctr_saved, MBEDTLS_SSL_SEQUENCE_NUMBER_LEN);
+    }
+    mbedtls_ssl_reset_out_pointers(ssl);
+    mbedtls_ssl_update_out_pointers(ssl, ssl->transform_out);
+
+    return 0;
+}
+
+void mbedtls_ssl_buffers_release_idle(mbedtls_ssl_context *ssl)
+{
+    if (ssl->in_buf == NULL || ssl->f_buf_acquire == NULL) {
+        return;
+    }
+
+    /* Nothing may live in the buffers but the incoming record counter: no
+     * handshake, no partial record in either direction, no pending alert
+     * and no unread data */
+    if (ssl->state != MBEDTLS_SSL_HANDSHAKE_OVER || ssl->handshake != NULL ||
+        ssl->out_left != 0 || ssl->send_alert != 0 || ssl->in_hsfraglen != 0 ||
+        mbedtls_ssl_check_pending(ssl) != 0) {
+        return;
+    }
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+    if (ssl->conf->transport == MBEDTLS_SSL_TRANSPORT_STREAM)
+#endif
+    {
+        if (ssl->in_left != 0) {
+            return;
+        }
+        memcpy(ssl->in_ctr_saved, ssl->in_ctr, MBEDTLS_SSL_SEQUENCE_NUMBER_LEN);
+    }
+
+    /* What the next record read would do: drop the consumed message and,
+     * for DTLS, the rest of the datagram */
+    ssl->in_left = 0;
+#if defined(MBEDTLS_SSL_PROTO_DTLS)
+    ssl->next_record_offset = 0;
+#endif
+    ssl->in_msglen = 0;
+    ssl->in_hslen = 0;
+
+    ssl_buffer_free(ssl, ssl->in_buf, ssl->in_buf_len);
+    ssl_buffer_free(ssl, ssl->out_buf, ssl->out_buf_len);
+    ssl->in_buf = NULL;
+    ssl->out_buf = NULL;
+
+    ssl->in_hdr = NULL;
+    ssl->in_ctr = NULL;
+    ssl->in_len = NULL;
+    ssl->in_iv = NULL;
+    ssl->in_msg = NULL;
+
+    ssl->out_hdr = NULL;
+    ssl->out_ctr = NULL;
+    ssl->out_len = NULL;
+    ssl->out_iv = NULL;
+    ssl->out_msg = NULL;
+}
+#endif /* MBEDTLS_SSL_BUFFER_POOL */
+
 #if defined(MBEDTLS_SSL_PROTO_TLS1_2)
 
 #if defined(MBEDTLS_SSL_CONTEXT_SERIALIZATION)
@@ -995,8 +1190,14 @@ static int ssl_handshake_init(mbedtls_ssl_context *ssl)
 #if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
     /* If the buffers are too small - reallocate */
 
+#if defined(MBEDTLS_SSL_IN_BUFFER_ON_DEMAND)
+    /* The input buffer grows later if a record needs it */
+    handle_buffer_resizing(ssl, 0, ssl_get_initial_in_buflen(ssl->conf),
+                           MBEDTLS_SSL_OUT_BUFFER_LEN);
+#else
     handle_buffer_resizing(ssl, 0, MBEDTLS_SSL_IN_BUFFER_LEN,
                            MBEDTLS_SSL_OUT_BUFFER_LEN);
+#endif
 #endif
 
     /* All pointers should exist and can be directly freed without issue */
@@ -1180,6 +1381,10 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl,
     }
     ssl->tls_version = ssl->conf->max_tls_version;
 
+#if defined(MBEDTLS_SSL_IN_BUFFER_ON_DEMAND)
+    in_buf_len = ssl_get_initial_in_buflen(conf);
+#endif
+
     /*
      * Prepare base structures
      */
@@ -1187,10 +1392,16 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl,
     /* Set to NULL in case of an error condition */
     ssl->out_buf = NULL;
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    ssl->f_buf_acquire = ssl_buffer_pool_acquire;
+    ssl->f_buf_release = ssl_buffer_pool_release;
+    ssl->p_buf_pool = ssl_buffer_pool_ctx;
+#endif
+
 #if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
     ssl->in_buf_len = in_buf_len;
 #endif
-    ssl->in_buf = mbedtls_calloc(1, in_buf_len);
+    ssl->in_buf = ssl_buffer_alloc(ssl, in_buf_len);
     if (ssl->in_buf == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("alloc(%" MBEDTLS_PRINTF_SIZET " bytes) failed", in_buf_len));
         ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
@@ -1200,7 +1411,7 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl,
 #if defined(MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH)
     ssl->out_buf_len = out_buf_len;
 #endif
-    ssl->out_buf = mbedtls_calloc(1, out_buf_len);
+    ssl->out_buf = ssl_buffer_alloc(ssl, out_buf_len);
     if (ssl->out_buf == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("alloc(%" MBEDTLS_PRINTF_SIZET " bytes) failed", out_buf_len));
         ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
@@ -1221,8 +1432,8 @@ int mbedtls_ssl_setup(mbedtls_ssl_context *ssl,
     return 0;
 
 error:
-    mbedtls_free(ssl->in_buf);
-    mbedtls_free(ssl->out_buf);
+    ssl_buffer_free(ssl, ssl->in_buf, in_buf_len);
+    ssl_buffer_free(ssl, ssl->out_buf, out_buf_len);
 
     ssl->conf = NULL;
 
@@ -1343,6 +1554,12 @@ int mbedtls_ssl_session_reset_int(mbedtls_ssl_context *ssl, int partial)
 {
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    if ((ret = mbedtls_ssl_buffers_acquire(ssl)) != 0) {
+        return ret;
+    }
+#endif
+
     mbedtls_ssl_handshake_set_state(ssl, MBEDTLS_SSL_HELLO_REQUEST);
     ssl->flags &= MBEDTLS_SSL_CONTEXT_FLAGS_KEEP_AT_SESSION;
     ssl->tls_version = ssl->conf->max_tls_version;
@@ -2686,6 +2903,90 @@ void mbedtls_ssl_set_async_operation_data(mbedtls_ssl_context *ssl,
 }
 #endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+void mbedtls_ssl_conf_ecdhe_cb(mbedtls_ssl_config *conf,
+                               mbedtls_ssl_ecdhe_gen_t *f_gen,
+                               mbedtls_ssl_ecdhe_derive_t *f_derive,
+                               mbedtls_ssl_ecdhe_free_t *f_free,
+                               void *p_ecdhe)
+{
+    conf->f_ecdhe_gen = f_gen;
+    conf->f_ecdhe_derive = f_derive;
+    conf->f_ecdhe_free = f_free;
+    conf->p_ecdhe = p_ecdhe;
+}
+
+int mbedtls_ssl_ecdhe_gen(mbedtls_ssl_context *ssl,
+                          unsigned char *pub, size_t pub_size, size_t *pub_len)
+{
+    int ret;
+    mbedtls_ssl_handshake_params *handshake = ssl->handshake;
+    void *key = NULL;
+
+    if (ssl->conf->f_ecdhe_gen == NULL) {
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH;
+    }
+
+    /* A key share left over from before a HelloRetryRequest */
+    mbedtls_ssl_ecdhe_free(ssl);
+
+    ret = ssl->conf->f_ecdhe_gen(ssl->conf->p_ecdhe,
+                                 handshake->xxdh_psa_type,
+                                 handshake->xxdh_psa_bits,
+                                 &key, pub, pub_size, pub_len);
+    if (ret == MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH) {
+        return ret;
+    }
+    if (ret != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "f_ecdhe_gen", ret);
+        return ret;
+    }
+    if (key == NULL) {
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    handshake->ecdhe_key = key;
+    return 0;
+}
+
+int mbedtls_ssl_ecdhe_derive(mbedtls_ssl_context *ssl, unsigned char *secret,
+                             size_t secret_size, size_t *secret_len)
+{
+    int ret;
+    mbedtls_ssl_handshake_params *handshake = ssl->handshake;
+    void *key = handshake->ecdhe_key;
+
+    if (key == NULL) {
+        return MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH;
+    }
+
+    /* The callback releases the key whatever the outcome */
+    handshake->ecdhe_key = NULL;
+    ret = ssl->conf->f_ecdhe_derive(ssl->conf->p_ecdhe, key,
+                                    handshake->xxdh_psa_peerkey,
+                                    handshake->xxdh_psa_peerkey_len,
+                                    secret, secret_size, secret_len);
+    if (ret != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "f_ecdhe_derive", ret);
+    }
+    return ret;
+}
+
+void mbedtls_ssl_ecdhe_free(mbedtls_ssl_context *ssl)
+{
+    mbedtls_ssl_handshake_params *handshake = ssl->handshake;
+
+    if (handshake->ecdhe_key == NULL) {
+        return;
+    }
+
+    if (ssl->conf->f_ecdhe_free != NULL) {
+        ssl->conf->f_ecdhe_free(ssl->conf->p_ecdhe, handshake->ecdhe_key);
+    }
+    handshake->ecdhe_key = NULL;
+}
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
 /*
  * SSL get accessors
  */
@@ -2994,6 +3295,11 @@ int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl,
 }
 #endif /* MBEDTLS_SSL_CLI_C */
 
+int mbedtls_ssl_session_resumed(const mbedtls_ssl_context *ssl)
+{
+    return (ssl->flags & MBEDTLS_SSL_CONTEXT_FLAG_SESSION_RESUMED) != 0;
+}
+
 #if defined(MBEDTLS_SSL_PROTO_TLS1_2)
 
 /* Serialization of TLS 1.2 sessions
@@ -4226,6 +4532,12 @@ int mbedtls_ssl_handshake(mbedtls_ssl_context *ssl)
         }
     }
 
+#if defined(MBEDTLS_SSL_BUFFER_POOL)
+    if (ret == 0) {
+        mbedtls_ssl_buffers_release_idle(ssl);
+    }
+#endif
+
     MBEDTLS_SSL_DEBUG_MSG(2, ("<= handshake"));
 
     return ret;
@@ -4464,6 +4776,9 @@ void mbedtls_ssl_handshake_free(mbedtls_ssl_context *ssl)
     if (handshake->xxdh_psa_privkey_is_external == 0) {
         psa_destroy_key(handshake->xxdh_psa_privkey);
     }
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+    mbedtls_ssl_ecdhe_free(ssl);
+#endif /* MBEDTLS_SSL_ECDHE_CB */
 #endif /* MBEDTLS_KEY_EXCHANGE_SOME_XXDH_PSA_ANY_ENABLED */
 
 #if defined(MBEDTLS_SSL_PROTO_TLS1_3)
@@ -4481,8 +4796,22 @@ void mbedtls_ssl_handshake_free(mbedtls_ssl_context *ssl)
      * processes datagrams and the fact that a datagram is allowed to have
      * several records in it, it is possible that the I/O buffers are not
      * empty at this stage */
+#if defined(MBEDTLS_SSL_IN_BUFFER_ON_DEMAND)
+    {
+        /* Back to the initial size even if the peer ignored the maximum
+         * fragment length; the buffer grows again for a larger record */
+        size_t in_buf_len = mbedtls_ssl_get_input_buflen(ssl);
+
+        if (in_buf_len > ssl_get_initial_in_buflen(ssl->conf)) {
+            in_buf_len = ssl_get_initial_in_buflen(ssl->conf);
+        }
+        handle_buffer_resizing(ssl, 1, in_buf_len,
+                               mbedtls_ssl_get_output_buflen(ssl));
+    }
+#else
     handle_buffer_resizing(ssl, 1, mbedtls_ssl_get_input_buflen(ssl),
                            mbedtls_ssl_get_output_buflen(ssl));
+#endif
 #endif
 
     /* mbedtls_platform_zeroize MUST be last one in this function */
@@ -5099,7 +5428,7 @@ void mbedtls_ssl_free(mbedtls_ssl_context *ssl)
         size_t out_buf_len = MBEDTLS_SSL_OUT_BUFFER_LEN;
 #endif
 
-        mbedtls_zeroize_and_free(ssl->out_buf, out_buf_len);
+        ssl_buffer_free(ssl, ssl->out_buf, out_buf_len);
         ssl->out_buf = NULL;
     }
 
@@ -5110,7 +5439,7 @@ void mbedtls_ssl_free(mbedtls_ssl_context *ssl)
         size_t in_buf_len = MBEDTLS_SSL_IN_BUFFER_LEN;
 #endif
 
-        mbedtls_zeroize_and_free(ssl->in_buf, in_buf_len);
+        ssl_buffer_free(ssl, ssl->in_buf, in_buf_len);
         ssl->in_buf = NULL;
     }
 
@@ -7305,6 +7634,12 @@ void mbedtls_ssl_handshake_wrapup(mbedtls_ssl_context *ssl)
 
     MBEDTLS_SSL_DEBUG_MSG(3, ("=> handshake wrapup"));
 
+    if (resume) {
+        ssl->flags |= MBEDTLS_SSL_CONTEXT_FLAG_SESSION_RESUMED;
+    } else {
+        ssl->flags &= ~MBEDTLS_SSL_CONTEXT_FLAG_SESSION_RESUMED;
+    }
+
 #if defined(MBEDTLS_SSL_RENEGOTIATION)
     if (ssl->renego_status == MBEDTLS_SSL_RENEGOTIATION_IN_PROGRESS) {
         ssl->renego_status =  MBEDTLS_SSL_RENEGOTIATION_DONE;
@@ -2280,6 +2280,45 @@ static int ssl_parse_server_hello_done(mbedtls_ssl_context *ssl)
     return 0;
 }
 
+#if defined(MBEDTLS_SSL_ECDHE_CB) && \
+    defined(MBEDTLS_KEY_EXCHANGE_SOME_XXDH_PSA_1_2_ENABLED)
+/*
+ * ECDHE through the f_ecdhe_* callbacks: write the public key with its
+ * length byte at p, not beyond end, and the shared secret to secret.
+ * Returns MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH when PSA has to do it.
+ */
+MBEDTLS_CHECK_RETURN_CRITICAL
+static int ssl_write_ecdhe_cb(mbedtls_ssl_context *ssl,
+                              unsigned char *p, const unsigned char *end,
+                              size_t *content_len,
+                              unsigned char *secret, size_t secret_size,
+                              size_t *secret_len)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    size_t own_pubkey_len = 0;
+
+    if (end - p < 2) {
+        return MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+    }
+
+    ret = mbedtls_ssl_ecdhe_gen(ssl, p + 1, (size_t) (end - (p + 1)),
+                                &own_pubkey_len);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (own_pubkey_len > 255) {
+        mbedtls_ssl_ecdhe_free(ssl);
+        return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
+    }
+
+    *p = (unsigned char) own_pubkey_len;
+    *content_len = own_pubkey_len + 1;
+
+    return mbedtls_ssl_ecdhe_derive(ssl, secret, secret_size, secret_len);
+}
+#endif /* MBEDTLS_SSL_ECDHE_CB && MBEDTLS_KEY_EXCHANGE_SOME_XXDH_PSA_1_2_ENABLED */
+
 MBEDTLS_CHECK_RETURN_CRITICAL
 static int ssl_write_client_key_exchange(mbedtls_ssl_context *ssl)
 {
@@ -2304,6 +2343,20 @@ static int ssl_write_client_key_exchange(mbedtls_ssl_context *ssl)
 
         header_len = 4;
 
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+        ret = ssl_write_ecdhe_cb(ssl, ssl->out_msg + header_len,
+                                 ssl->out_msg + MBEDTLS_SSL_OUT_CONTENT_LEN,
+                                 &content_len, handshake->premaster,
+                                 sizeof(handshake->premaster),
+                                 &handshake->pmslen);
+        if (ret != MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH) {
+            if (ret != 0) {
+                return ret;
+            }
+            goto ecdhe_written;
+        }
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
         MBEDTLS_SSL_DEBUG_MSG(3, ("Perform PSA-based ECDH computation."));
 
         /*
@@ -2412,6 +2465,27 @@ static int ssl_write_client_key_exchange(mbedtls_ssl_context *ssl)
 
         header_len += ssl->conf->psk_identity_len;
 
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+        {
+            /* Same premaster layout as below: uint16 length, then the
+             * ECDH computation */
+            size_t cb_zlen = 0;
+
+            ret = ssl_write_ecdhe_cb(ssl, p,
+                                     ssl->out_msg + MBEDTLS_SSL_OUT_CONTENT_LEN,
+                                     &content_len, handshake->premaster + 2,
+                                     sizeof(handshake->premaster) - 2,
+                                     &cb_zlen);
+            if (ret != MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH) {
+                if (ret != 0) {
+                    return ret;
+                }
+                MBEDTLS_PUT_UINT16_BE(cb_zlen, handshake->premaster, 0);
+                goto ecdhe_written;
+            }
+        }
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
         MBEDTLS_SSL_DEBUG_MSG(3, ("Perform PSA-based ECDH computation."));
 
         /*
@@ -2559,6 +2633,10 @@ static int ssl_write_client_key_exchange(mbedtls_ssl_context *ssl)
         return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
     }
 
+#if defined(MBEDTLS_SSL_ECDHE_CB) && \
+    defined(MBEDTLS_KEY_EXCHANGE_SOME_XXDH_PSA_1_2_ENABLED)
+ecdhe_written:
+#endif
     ssl->out_msglen  = header_len + content_len;
     ssl->out_msgtype = MBEDTLS_SSL_MSG_HANDSHAKE;
     ssl->out_msg[0]  = MBEDTLS_SSL_HS_CLIENT_KEY_EXCHANGE;
@@ -2620,6 +2698,13 @@ static int ssl_write_certificate_verify(mbedtls_ssl_context *ssl)
 
     MBEDTLS_SSL_DEBUG_MSG(2, ("=> write certificate verify"));
 
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+    if (ssl->handshake->async_in_progress != 0) {
+        MBEDTLS_SSL_DEBUG_MSG(2, ("resuming signature operation"));
+        goto async_resume;
+    }
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
+
 #if defined(MBEDTLS_SSL_ECP_RESTARTABLE_ENABLED)
     if (ssl->handshake->ecrs_enabled &&
         ssl->handshake->ecrs_state == ssl_ecrs_crt_vrfy_sign) {
@@ -2645,7 +2730,11 @@ static int ssl_write_certificate_verify(mbedtls_ssl_context *ssl)
         return 0;
     }
 
-    if (mbedtls_ssl_own_key(ssl) == NULL) {
+    if (mbedtls_ssl_own_key(ssl) == NULL
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+        && ssl->conf->f_async_sign_start == NULL
+#endif
+        ) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("got no private key for certificate"));
         return MBEDTLS_ERR_SSL_PRIVATE_KEY_REQUIRED;
     }
@@ -2690,7 +2779,35 @@ sign:
         md_alg = MBEDTLS_MD_SHA256;
         ssl->out_msg[4] = MBEDTLS_SSL_HASH_SHA256;
     }
-    ssl->out_msg[5] = mbedtls_ssl_sig_from_pk(mbedtls_ssl_own_key(ssl));
+    ssl->out_msg[5] = mbedtls_ssl_sig_from_pk(mbedtls_ssl_own_key(ssl) != NULL ?
+                                              mbedtls_ssl_own_key(ssl) :
+                                              &mbedtls_ssl_own_cert(ssl)->pk);
+
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+    if (ssl->conf->f_async_sign_start != NULL) {
+        ret = ssl->conf->f_async_sign_start(ssl, mbedtls_ssl_own_cert(ssl),
+                                            md_alg, hash, hashlen);
+        switch (ret) {
+            case MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH:
+                /* act as if f_async_sign was null */
+                break;
+            case 0:
+                ssl->handshake->async_in_progress = 1;
+                goto async_resume;
+            case MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS:
+                ssl->handshake->async_in_progress = 1;
+                return MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS;
+            default:
+                MBEDTLS_SSL_DEBUG_RET(1, "f_async_sign_start", ret);
+                return ret;
+        }
+    }
+
+    if (mbedtls_ssl_own_key(ssl) == NULL) {
+        MBEDTLS_SSL_DEBUG_MSG(1, ("got no private key for certificate"));
+        return MBEDTLS_ERR_SSL_PRIVATE_KEY_REQUIRED;
+    }
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
 
     /* Info from md_alg will be used instead */
     hashlen = 0;
@@ -2717,6 +2834,27 @@ sign:
         return ret;
     }
 
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+    goto write_msg;
+
+async_resume:
+    /* out_msg[4..5] were written before the operation was started */
+    offset = 2;
+    ret = ssl->conf->f_async_resume(ssl, ssl->out_msg + 6 + offset, &n,
+                                    out_buf_len - 6 - offset);
+    if (ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+        return ret;
+    }
+    ssl->handshake->async_in_progress = 0;
+    mbedtls_ssl_set_async_operation_data(ssl, NULL);
+    if (ret != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "f_async_resume", ret);
+        return ret;
+    }
+
+write_msg:
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
+
     MBEDTLS_PUT_UINT16_BE(n, ssl->out_msg, offset + 4);
 
     ssl->out_msglen  = 6 + n + offset;
@@ -185,6 +185,10 @@ static int ssl_tls13_reset_key_share(mbedtls_ssl_context *ssl)
         int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
         psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
 
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+        mbedtls_ssl_ecdhe_free(ssl);
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
         /* Destroy generated private key. */
         status = psa_destroy_key(ssl->handshake->xxdh_psa_privkey);
         if (status != PSA_SUCCESS) {
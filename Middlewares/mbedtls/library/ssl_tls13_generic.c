@@ -893,7 +893,22 @@ static int ssl_tls13_write_certificate_verify_body(mbedtls_ssl_context *ssl,
 
     *out_len = 0;
 
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+    if (ssl->handshake->async_in_progress != 0) {
+        MBEDTLS_SSL_DEBUG_MSG(2, ("resuming signature operation"));
+        goto async_resume;
+    }
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
+
     own_key = mbedtls_ssl_own_key(ssl);
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+    /* The callbacks may hold the only handle to the private key, select the
+     * algorithm from the certificate's public key then */
+    if (own_key == NULL && ssl->conf->f_async_sign_start != NULL &&
+        mbedtls_ssl_own_cert(ssl) != NULL) {
+        own_key = &mbedtls_ssl_own_cert(ssl)->pk;
+    }
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
     if (own_key == NULL) {
         MBEDTLS_SSL_DEBUG_MSG(1, ("should never happen"));
         return MBEDTLS_ERR_SSL_INTERNAL_ERROR;
@@ -963,6 +978,30 @@ static int ssl_tls13_write_certificate_verify_body(mbedtls_ssl_context *ssl,
 
         MBEDTLS_SSL_DEBUG_BUF(3, "verify hash", verify_hash, verify_hash_len);
 
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+        if (ssl->conf->f_async_sign_start != NULL) {
+            /* Written before the operation is started, the output buffer
+             * is left alone until it completes */
+            MBEDTLS_PUT_UINT16_BE(*sig_alg, p, 0);
+            ret = ssl->conf->f_async_sign_start(ssl, mbedtls_ssl_own_cert(ssl),
+                                                md_alg, verify_hash, verify_hash_len);
+            switch (ret) {
+                case MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH:
+                    /* act as if f_async_sign was null */
+                    break;
+                case 0:
+                    ssl->handshake->async_in_progress = 1;
+                    goto async_resume;
+                case MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS:
+                    ssl->handshake->async_in_progress = 1;
+                    return MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS;
+                default:
+                    MBEDTLS_SSL_DEBUG_RET(1, "f_async_sign_start", ret);
+                    return ret;
+            }
+        }
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
+
         if ((ret = mbedtls_pk_sign_ext((mbedtls_pk_sigalg_t) pk_type, own_key,
                                        md_alg, verify_hash, verify_hash_len,
                                        p + 4, (size_t) (end - (p + 4)), &signature_len)) != 0) {
@@ -992,6 +1031,26 @@ static int ssl_tls13_write_certificate_verify_body(mbedtls_ssl_context *ssl,
     }
 
     MBEDTLS_PUT_UINT16_BE(*sig_alg, p, 0);
+
+#if defined(MBEDTLS_SSL_ASYNC_PRIVATE)
+    goto write_len;
+
+async_resume:
+    ret = ssl->conf->f_async_resume(ssl, p + 4, &signature_len,
+                                    (size_t) (end - (p + 4)));
+    if (ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) {
+        return ret;
+    }
+    ssl->handshake->async_in_progress = 0;
+    mbedtls_ssl_set_async_operation_data(ssl, NULL);
+    if (ret != 0) {
+        MBEDTLS_SSL_DEBUG_RET(1, "f_async_resume", ret);
+        return ret;
+    }
+
+write_len:
+#endif /* MBEDTLS_SSL_ASYNC_PRIVATE */
+
     MBEDTLS_PUT_UINT16_BE(signature_len, p, 2);
 
     *out_len = 4 + signature_len;
@@ -1216,6 +1275,12 @@ void mbedtls_ssl_tls13_handshake_wrapup(mbedtls_ssl_context *ssl)
     MBEDTLS_SSL_DEBUG_MSG(1, ("Switch to application keys for outbound traffic"));
     mbedtls_ssl_set_outbound_transform(ssl, ssl->transform_application);
 
+    if (mbedtls_ssl_tls13_key_exchange_mode_with_psk(ssl)) {
+        ssl->flags |= MBEDTLS_SSL_CONTEXT_FLAG_SESSION_RESUMED;
+    } else {
+        ssl->flags &= ~MBEDTLS_SSL_CONTEXT_FLAG_SESSION_RESUMED;
+    }
+
     /*
      * Free the previous session and switch to the current one.
      */
@@ -1554,6 +1619,13 @@ int mbedtls_ssl_tls13_generate_and_write_xxdh_key_exchange(
     handshake->xxdh_psa_type = key_type;
     ssl->handshake->xxdh_psa_bits = bits;
 
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+    ret = mbedtls_ssl_ecdhe_gen(ssl, buf, buf_size, out_len);
+    if (ret != MBEDTLS_ERR_SSL_HW_ACCEL_FALLTHROUGH) {
+        return ret;
+    }
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
     key_attributes = psa_key_attributes_init();
     psa_set_key_usage_flags(&key_attributes, PSA_KEY_USAGE_DERIVE);
     psa_set_key_algorithm(&key_attributes, alg);
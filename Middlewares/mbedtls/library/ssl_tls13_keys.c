@@ -1437,6 +1437,26 @@ static int ssl_tls13_key_schedule_stage_handshake(mbedtls_ssl_context *ssl)
                 mbedtls_ssl_tls13_named_group_is_ecdhe(handshake->offered_group_id) ?
                 PSA_ALG_ECDH : PSA_ALG_FFDH;
 
+#if defined(MBEDTLS_SSL_ECDHE_CB)
+            /* Key share generated by the f_ecdhe_gen callback */
+            if (handshake->ecdhe_key != NULL) {
+                shared_secret_len = PSA_BITS_TO_BYTES(handshake->xxdh_psa_bits);
+                shared_secret = mbedtls_calloc(1, shared_secret_len);
+                if (shared_secret == NULL) {
+                    mbedtls_ssl_ecdhe_free(ssl);
+                    return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+                }
+
+                ret = mbedtls_ssl_ecdhe_derive(ssl, shared_secret,
+                                               shared_secret_len,
+                                               &shared_secret_len);
+                if (ret != 0) {
+                    goto cleanup;
+                }
+                goto ecdhe_derived;
+            }
+#endif /* MBEDTLS_SSL_ECDHE_CB */
+
             /* Compute ECDH shared secret. */
             psa_status_t status = PSA_ERROR_GENERIC_ERROR;
             psa_key_attributes_t key_attributes = PSA_KEY_ATTRIBUTES_INIT;
@@ -1483,6 +1503,10 @@ static int ssl_tls13_key_schedule_stage_handshake(mbedtls_ssl_context *ssl)
     /*
      * Compute the Handshake Secret
      */
+#if defined(MBEDTLS_SSL_ECDHE_CB) && \
+    defined(MBEDTLS_SSL_TLS1_3_KEY_EXCHANGE_MODE_SOME_EPHEMERAL_ENABLED)
+ecdhe_derived:
+#endif
     ret = mbedtls_ssl_tls13_evolve_secret(
         hash_alg, handshake->tls13_master_secrets.early,
         shared_secret, shared_secret_len,
@@ -2098,18 +2098,103 @@ static int x509_crt_verifycrl(mbedtls_x509_crt *crt, mbedtls_x509_crt *ca,
 }
 #endif /* MBEDTLS_X509_CRL_PARSE_C */
 
+typedef struct x509_crt_sig_batch x509_crt_sig_batch;
+
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+/*
+ * Signatures of a chain collected while building it
+ */
+struct x509_crt_sig_batch {
+    mbedtls_x509_crt_sig_item items[MBEDTLS_X509_MAX_VERIFY_CHAIN_SIZE];
+    size_t len;
+};
+
+static mbedtls_x509_crt_batch_check_cb_t x509_crt_batch_check_f = NULL;
+static mbedtls_x509_crt_batch_verify_cb_t x509_crt_batch_verify_f = NULL;
+static void *x509_crt_batch_verify_p = NULL;
+
+void mbedtls_x509_crt_set_batch_verify_cb(mbedtls_x509_crt_batch_check_cb_t f_check,
+                                          mbedtls_x509_crt_batch_verify_cb_t f_batch,
+                                          void *p_batch)
+{
+    x509_crt_batch_check_f = f_check;
+    x509_crt_batch_verify_f = f_batch;
+    x509_crt_batch_verify_p = p_batch;
+}
+
+/*
+ * Tell whether the signature of child by parent is left to the batch, or
+ * checked right away because the batch callback could not verify it
+ */
+static int x509_crt_sig_batch_can_defer(const mbedtls_x509_crt *child,
+                                        const mbedtls_x509_crt *parent)
+{
+    if (x509_crt_batch_check_f == NULL) {
+        return 1;
+    }
+
+    return x509_crt_batch_check_f(x509_crt_batch_verify_p, &parent->pk,
+                                  child->sig_pk, child->sig_md) == 0;
+}
+
+/*
+ * Record the signature of child by parent for later batch verification
+ */
+static int x509_crt_sig_batch_add(x509_crt_sig_batch *batch,
+                                  const mbedtls_x509_crt *child,
+                                  mbedtls_x509_crt *parent)
+{
+    mbedtls_x509_crt_sig_item *item;
+    psa_status_t status;
+
+    if (batch->len >= MBEDTLS_X509_MAX_VERIFY_CHAIN_SIZE) {
+        return MBEDTLS_ERR_X509_FATAL_ERROR;
+    }
+
+    item = &batch->items[batch->len];
+    status = psa_hash_compute(mbedtls_md_psa_alg_from_type(child->sig_md),
+                              child->tbs.p,
+                              child->tbs.len,
+                              item->hash,
+                              sizeof(item->hash),
+                              &item->hash_len);
+    if (status != PSA_SUCCESS) {
+        return MBEDTLS_ERR_PLATFORM_HW_ACCEL_FAILED;
+    }
+
+    item->pk = &parent->pk;
+    item->sig_pk = child->sig_pk;
+    item->md_alg = child->sig_md;
+    item->sig = child->sig.p;
+    item->sig_len = child->sig.len;
+    batch->len++;
+
+    return 0;
+}
+#endif /* MBEDTLS_X509_CRT_BATCH_VERIFY */
+
 /*
  * Check the signature of a certificate by its parent
  */
 static int x509_crt_check_signature(const mbedtls_x509_crt *child,
                                     mbedtls_x509_crt *parent,
-                                    mbedtls_x509_crt_restart_ctx *rs_ctx)
+                                    mbedtls_x509_crt_restart_ctx *rs_ctx,
+                                    int defer)
 {
     size_t hash_len;
     unsigned char hash[MBEDTLS_MD_MAX_SIZE];
     psa_algorithm_t hash_alg = mbedtls_md_psa_alg_from_type(child->sig_md);
     psa_status_t status = PSA_ERROR_CORRUPTION_DETECTED;
 
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+    /* The signature itself is checked later, together with the whole chain */
+    if (defer && x509_crt_sig_batch_can_defer(child, parent)) {
+        return mbedtls_pk_can_do(&parent->pk, (mbedtls_pk_type_t) child->sig_pk) ? 0 : -1;
+    }
+#else
+    (void) defer;
+#endif
+
     status = psa_hash_compute(hash_alg,
                               child->tbs.p,
                               child->tbs.len,
@@ -2215,6 +2300,8 @@ static int x509_crt_check_parent(const mbedtls_x509_crt *child,
  *  - [in] self_cnt: number of self-signed intermediates seen so far
  *         (will never be greater than path_cnt)
  *  - [in-out] rs_ctx: context for restarting operations
+ *  - [in] defer: 1 to assume signatures are good and leave them to the
+ *         batch verification of the chain, 0 otherwise
  *
  * Return value:
  *  - 0 on success
@@ -2229,7 +2316,8 @@ static int x509_crt_find_parent_in(
     unsigned path_cnt,
     unsigned self_cnt,
     mbedtls_x509_crt_restart_ctx *rs_ctx,
-    const mbedtls_x509_time *now)
+    const mbedtls_x509_time *now,
+    int defer)
 {
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
     mbedtls_x509_crt *parent, *fallback_parent;
@@ -2272,7 +2360,7 @@ static int x509_crt_find_parent_in(
 #if defined(MBEDTLS_ECP_RESTARTABLE)
 check_signature:
 #endif
-        ret = x509_crt_check_signature(child, parent, rs_ctx);
+        ret = x509_crt_check_signature(child, parent, rs_ctx, defer);
 
 #if defined(MBEDTLS_ECP_RESTARTABLE)
         if (rs_ctx != NULL && ret == MBEDTLS_ERR_ECP_IN_PROGRESS) {
@@ -2338,6 +2426,7 @@ check_signature:
  *  - [in] self_cnt: number of self-signed certs in the chain so far
  *         (will always be no greater than path_cnt)
  *  - [in-out] rs_ctx: context for restarting operations
+ *  - [in] defer: as in find_parent_in()
  *
  * Return value:
  *  - 0 on success
@@ -2352,7 +2441,8 @@ static int x509_crt_find_parent(
     unsigned path_cnt,
     unsigned self_cnt,
     mbedtls_x509_crt_restart_ctx *rs_ctx,
-    const mbedtls_x509_time *now)
+    const mbedtls_x509_time *now,
+    int defer)
 {
     int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
     mbedtls_x509_crt *search_list;
@@ -2373,7 +2463,7 @@ static int x509_crt_find_parent(
         ret = x509_crt_find_parent_in(child, search_list,
                                       parent, signature_is_good,
                                       *parent_is_trusted,
-                                      path_cnt, self_cnt, rs_ctx, now);
+                                      path_cnt, self_cnt, rs_ctx, now, defer);
 
 #if defined(MBEDTLS_ECP_RESTARTABLE)
         if (rs_ctx != NULL && ret == MBEDTLS_ERR_ECP_IN_PROGRESS) {
@@ -2466,6 +2556,8 @@ static int x509_crt_check_ee_locally_trusted(
  *      Only valid when return value is 0, may contain garbage otherwise!
  *      Restart note: need not be the same when calling again to resume.
  *  - [in-out] rs_ctx: context for restarting operations
+ *  - [out] batch: if not NULL, signatures are not checked while building
+ *      the chain but collected here for batch verification
  *
  * Return value:
  *  - non-zero if the chain could not be fully built and examined
@@ -2480,7 +2572,8 @@ static int x509_crt_verify_chain(
     void *p_ca_cb,
     const mbedtls_x509_crt_profile *profile,
     mbedtls_x509_crt_verify_chain *ver_chain,
-    mbedtls_x509_crt_restart_ctx *rs_ctx)
+    mbedtls_x509_crt_restart_ctx *rs_ctx,
+    x509_crt_sig_batch *batch)
 {
     /* Don't initialize any of those variables here, so that the compiler can
      * catch potential issues with jumping ahead when restarting */
@@ -2592,7 +2685,7 @@ find_parent:
         ret = x509_crt_find_parent(child, cur_trust_ca, &parent,
                                    &parent_is_trusted, &signature_is_good,
                                    ver_chain->len - 1, self_cnt, rs_ctx,
-                                   &now);
+                                   &now, batch != NULL);
 
 #if defined(MBEDTLS_ECP_RESTARTABLE)
         if (rs_ctx != NULL && ret == MBEDTLS_ERR_ECP_IN_PROGRESS) {
@@ -2633,6 +2726,14 @@ find_parent:
         if (!signature_is_good) {
             *flags |= MBEDTLS_X509_BADCERT_NOT_TRUSTED;
         }
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+        else if (batch != NULL && x509_crt_sig_batch_can_defer(child, parent)) {
+            ret = x509_crt_sig_batch_add(batch, child, parent);
+            if (ret != 0) {
+                return ret;
+            }
+        }
+#endif
 
         /* check size of signing key */
         if (x509_profile_check_key(profile, &parent->pk) != 0) {
@@ -3004,6 +3105,127 @@ static int x509_crt_merge_flags_with_cb(
     return 0;
 }
 
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+/*
+ * Build the chain assuming signatures are good, then verify all of them
+ * with a single call to the batch callback. If any of them is bad, start
+ * over with the regular path so that parent selection and flags are
+ * exactly the same as without batching.
+ */
+static int x509_crt_verify_chain_batch(
+    mbedtls_x509_crt *crt,
+    mbedtls_x509_crt *trust_ca,
+    mbedtls_x509_crl *ca_crl,
+    mbedtls_x509_crt_ca_cb_t f_ca_cb,
+    void *p_ca_cb,
+    const mbedtls_x509_crt_profile *profile,
+    mbedtls_x509_crt_verify_chain *ver_chain)
+{
+    int ret = MBEDTLS_ERR_ERROR_CORRUPTION_DETECTED;
+    x509_crt_sig_batch batch;
+
+    batch.len = 0;
+
+    ret = x509_crt_verify_chain(crt, trust_ca, ca_crl,
+                                f_ca_cb, p_ca_cb, profile,
+                                ver_chain, NULL, &batch);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (batch.len == 0 ||
+        x509_crt_batch_verify_f(x509_crt_batch_verify_p, batch.items, batch.len) == 0) {
+        return 0;
+    }
+
+#if defined(MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK)
+    mbedtls_x509_crt_free(ver_chain->trust_ca_cb_result);
+    mbedtls_free(ver_chain->trust_ca_cb_result);
+#endif /* MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK */
+    x509_crt_verify_chain_reset(ver_chain);
+
+    return x509_crt_verify_chain(crt, trust_ca, ca_crl,
+                                 f_ca_cb, p_ca_cb, profile,
+                                 ver_chain, NULL, NULL);
+}
+#endif /* MBEDTLS_X509_CRT_BATCH_VERIFY */
+
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+static mbedtls_x509_crt_cache_lookup_cb_t x509_crt_cache_lookup_f = NULL;
+static mbedtls_x509_crt_cache_store_cb_t x509_crt_cache_store_f = NULL;
+static void *x509_crt_cache_p = NULL;
+
+void mbedtls_x509_crt_set_verify_cache_cb(mbedtls_x509_crt_cache_lookup_cb_t f_lookup,
+                                          mbedtls_x509_crt_cache_store_cb_t f_store,
+                                          void *p_cache)
+{
+    x509_crt_cache_lookup_f = f_lookup;
+    x509_crt_cache_store_f = f_store;
+    x509_crt_cache_p = p_cache;
+}
+
+/*
+ * Check the validity window of a cached chain, as x509_crt_verify_chain()
+ * would for each of its certificates
+ */
+static int x509_crt_cache_check_time(const mbedtls_x509_time *valid_from,
+                                     const mbedtls_x509_time *valid_to,
+                                     uint32_t *flags)
+{
+#if defined(MBEDTLS_HAVE_TIME_DATE)
+    mbedtls_x509_time now;
+
+    if (mbedtls_x509_time_gmtime(mbedtls_time(NULL), &now) != 0) {
+        return MBEDTLS_ERR_X509_FATAL_ERROR;
+    }
+
+    if (mbedtls_x509_time_cmp(valid_to, &now) < 0) {
+        *flags |= MBEDTLS_X509_BADCERT_EXPIRED;
+    }
+
+    if (mbedtls_x509_time_cmp(valid_from, &now) > 0) {
+        *flags |= MBEDTLS_X509_BADCERT_FUTURE;
+    }
+#else
+    (void) valid_from;
+    (void) valid_to;
+    (void) flags;
+#endif
+
+    return 0;
+}
+
+/*
+ * Hand a chain that verified cleanly to the cache, with the intersection of
+ * the validity periods of every certificate in it
+ */
+static void x509_crt_cache_store(const mbedtls_x509_crt *crt,
+                                 const mbedtls_x509_crt *trust_ca,
+                                 mbedtls_x509_crt_ca_cb_t f_ca_cb,
+                                 const void *p_ca_cb,
+                                 const mbedtls_x509_crt_profile *profile,
+                                 const mbedtls_x509_crt_verify_chain *ver_chain)
+{
+    const mbedtls_x509_time *valid_from = &crt->valid_from;
+    const mbedtls_x509_time *valid_to = &crt->valid_to;
+    const mbedtls_x509_crt *cur;
+    unsigned i;
+
+    for (i = 1; i < ver_chain->len; i++) {
+        cur = ver_chain->items[i].crt;
+        if (mbedtls_x509_time_cmp(&cur->valid_from, valid_from) > 0) {
+            valid_from = &cur->valid_from;
+        }
+        if (mbedtls_x509_time_cmp(&cur->valid_to, valid_to) < 0) {
+            valid_to = &cur->valid_to;
+        }
+    }
+
+    x509_crt_cache_store_f(x509_crt_cache_p, crt, trust_ca, f_ca_cb, p_ca_cb,
+                           profile, valid_from, valid_to);
+}
+#endif /* MBEDTLS_X509_CRT_VERIFY_CACHE */
+
 /*
  * Verify the certificate validity, with profile, restartable version
  *
@@ -3039,6 +3261,11 @@ static int x509_crt_verify_restartable_ca_cb(mbedtls_x509_crt *crt,
     mbedtls_pk_type_t pk_type;
     mbedtls_x509_crt_verify_chain ver_chain;
     uint32_t ee_flags;
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+    int use_cache;
+    mbedtls_x509_time cache_from;
+    mbedtls_x509_time cache_to;
+#endif
 
     *flags = 0;
     ee_flags = 0;
@@ -3065,10 +3292,31 @@ static int x509_crt_verify_restartable_ca_cb(mbedtls_x509_crt *crt,
         ee_flags |= MBEDTLS_X509_BADCERT_BAD_KEY;
     }
 
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+    /* A chain that verified before against the same trust anchors and
+     * profile only needs its validity window checked again */
+    use_cache = x509_crt_cache_lookup_f != NULL && ca_crl == NULL &&
+                f_vrfy == NULL && rs_ctx == NULL;
+    if (use_cache &&
+        x509_crt_cache_lookup_f(x509_crt_cache_p, crt, trust_ca, f_ca_cb, p_ca_cb,
+                                profile, &cache_from, &cache_to) == 0) {
+        *flags = ee_flags;
+        ret = x509_crt_cache_check_time(&cache_from, &cache_to, flags);
+        goto exit;
+    }
+#endif /* MBEDTLS_X509_CRT_VERIFY_CACHE */
+
     /* Check the chain */
+#if defined(MBEDTLS_X509_CRT_BATCH_VERIFY)
+    if (x509_crt_batch_verify_f != NULL && rs_ctx == NULL) {
+        ret = x509_crt_verify_chain_batch(crt, trust_ca, ca_crl,
+                                          f_ca_cb, p_ca_cb, profile,
+                                          &ver_chain);
+    } else
+#endif /* MBEDTLS_X509_CRT_BATCH_VERIFY */
     ret = x509_crt_verify_chain(crt, trust_ca, ca_crl,
                                 f_ca_cb, p_ca_cb, profile,
-                                &ver_chain, rs_ctx);
+                                &ver_chain, rs_ctx, NULL);
 
     if (ret != 0) {
         goto exit;
@@ -3080,6 +3328,12 @@ static int x509_crt_verify_restartable_ca_cb(mbedtls_x509_crt *crt,
     /* Build final flags, calling callback on the way if any */
     ret = x509_crt_merge_flags_with_cb(flags, &ver_chain, f_vrfy, p_vrfy);
 
+#if defined(MBEDTLS_X509_CRT_VERIFY_CACHE)
+    if (ret == 0 && *flags == 0 && use_cache && x509_crt_cache_store_f != NULL) {
+        x509_crt_cache_store(crt, trust_ca, f_ca_cb, p_ca_cb, profile, &ver_chain);
+    }
+#endif /* MBEDTLS_X509_CRT_VERIFY_CACHE */
+
 exit:
 
 #if defined(MBEDTLS_X509_TRUSTED_CERTIFICATE_CALLBACK)
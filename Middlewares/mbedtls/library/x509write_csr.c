@@ -56,6 +56,16 @@ void mbedtls_x509write_csr_set_md_alg(mbedtls_x509write_csr *ctx, mbedtls_md_typ
     ctx->md_alg = md_alg;
 }
 
+#if defined(MBEDTLS_X509_CSR_WRITE_SIGN_CB)
+void mbedtls_x509write_csr_set_sign_cb(mbedtls_x509write_csr *ctx,
+                                       mbedtls_x509write_csr_sign_cb_t f_sign,
+                                       void *p_sign)
+{
+    ctx->f_sign = f_sign;
+    ctx->p_sign = p_sign;
+}
+#endif /* MBEDTLS_X509_CSR_WRITE_SIGN_CB */
+
 void mbedtls_x509write_csr_set_key(mbedtls_x509write_csr *ctx, mbedtls_pk_context *key)
 {
     ctx->key = key;
@@ -226,8 +236,17 @@ static int x509write_csr_der_internal(mbedtls_x509write_csr *ctx,
         return MBEDTLS_ERR_X509_INVALID_ALG;
     }
 
-    if ((ret = mbedtls_pk_sign_ext(pk_alg, ctx->key, ctx->md_alg, hash, 0,
-                                   sig, sig_size, &sig_len)) != 0) {
+#if defined(MBEDTLS_X509_CSR_WRITE_SIGN_CB)
+    if (ctx->f_sign != NULL) {
+        ret = ctx->f_sign(ctx->p_sign, pk_alg, ctx->md_alg, hash, hash_len,
+                          sig, sig_size, &sig_len);
+    } else
+#endif
+    {
+        ret = mbedtls_pk_sign_ext(pk_alg, ctx->key, ctx->md_alg, hash, 0,
+                                  sig, sig_size, &sig_len);
+    }
+    if (ret != 0) {
         return ret;
     }
 
@@ -140,6 +140,18 @@ uint8_t g_no_of_session = 0;
 
 static ApduTransceiveFunction_t pSmCom_Transceive = NULL;
 static ApduTransceiveRawFunction_t pSmCom_TransceiveRaw = NULL;
+static smComTxnHook_t pSmCom_TxnHook = NULL;
+static void *pSmCom_TxnHookArg = NULL;
+
+/**
+ * Install a function called around every APDU exchange, NULL to remove it.
+ *
+ */
+void smCom_SetTxnHook(smComTxnHook_t pHook, void *pArg)
+{
+    pSmCom_TxnHook = pHook;
+    pSmCom_TxnHookArg = pArg;
+}
 
 /**
  * Install interconnect and protocol specific implementation of APDU transfer functions.
@@ -231,9 +243,17 @@ U32 smCom_Transceive(void *conn_ctx, apdu_t * pApdu)
     U32 ret = SMCOM_NO_PRIOR_INIT;
     if (pSmCom_Transceive != NULL)
     {
+        if (pSmCom_TxnHook != NULL)
+        {
+            pSmCom_TxnHook(pSmCom_TxnHookArg, 0);
+        }
         LOCK_TXN();
         ret = pSmCom_Transceive(conn_ctx, pApdu);
         UNLOCK_TXN();
+        if (pSmCom_TxnHook != NULL)
+        {
+            pSmCom_TxnHook(pSmCom_TxnHookArg, 1);
+        }
     }
     return ret;
 }
@@ -255,9 +275,17 @@ U32 smCom_TransceiveRaw(void *conn_ctx, U8 * pTx, U16 txLen, U8 * pRx, U32 * pRx
     U32 ret = SMCOM_NO_PRIOR_INIT;
     if (pSmCom_TransceiveRaw != NULL)
     {
+        if (pSmCom_TxnHook != NULL)
+        {
+            pSmCom_TxnHook(pSmCom_TxnHookArg, 0);
+        }
         LOCK_TXN();
         ret = pSmCom_TransceiveRaw(conn_ctx, pTx, txLen, pRx, pRxLen);
         UNLOCK_TXN();
+        if (pSmCom_TxnHook != NULL)
+        {
+            pSmCom_TxnHook(pSmCom_TxnHookArg, 1);
+        }
     }
     return ret;
 }
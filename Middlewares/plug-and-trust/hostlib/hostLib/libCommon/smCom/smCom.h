@@ -34,11 +34,15 @@ extern "C" {
 /* ------------------------------------------------------------------------- */
 typedef U32 (*ApduTransceiveFunction_t) (void* conn_ctx, apdu_t * pAdpu);
 typedef U32 (*ApduTransceiveRawFunction_t) (void* conn_ctx, U8 * pTx, U16 txLen, U8 * pRx, U32 * pRxLen);
+/** Called before (done = 0) and after (done = 1) each APDU exchange, the
+ *  interval includes waiting for the communication lock */
+typedef void (*smComTxnHook_t) (void* pArg, U8 done);
 
 U16 smCom_Init(ApduTransceiveFunction_t pTransceive, ApduTransceiveRawFunction_t pTransceiveRaw);
 void smCom_DeInit(void);
 U32 smCom_Transceive(void *conn_ctx, apdu_t *pApdu);
 U32 smCom_TransceiveRaw(void *conn_ctx, U8 *pTx, U16 txLen, U8 *pRx, U32 *pRxLen);
+void smCom_SetTxnHook(smComTxnHook_t pHook, void *pArg);
 
 #if defined(SMCOM_JRCP_V2)
 void smCom_Echo(void *conn_ctx, const char *comp, const char *level, const char *buffer);
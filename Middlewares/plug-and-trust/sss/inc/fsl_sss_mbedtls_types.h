@@ -71,6 +71,11 @@
 
 #define SSS_AEAD_TYPE_IS_MBEDTLS(context) (context && SSS_SESSION_TYPE_IS_MBEDTLS(context->session))
 
+/** Maximum number of signatures accepted by sss_mbedtls_asymmetric_verify_digest_batch() */
+#ifndef SSS_MBEDTLS_VERIFY_BATCH_MAX
+#define SSS_MBEDTLS_VERIFY_BATCH_MAX 10
+#endif
+
 /* ************************************************************************** */
 /* Structrues and Typedefs                                                    */
 /* ************************************************************************** */
@@ -151,6 +156,16 @@ typedef struct _sss_mbedtls_asymmetric
 
 } sss_mbedtls_asymmetric_t;
 
+/** One (key, digest, signature) tuple of a batch verification */
+typedef struct _sss_mbedtls_verify_item
+{
+    sss_mbedtls_asymmetric_t *context; /*!< Key and algorithm, as for a single verify */
+    const uint8_t *digest;             /*!< Message digest */
+    size_t digestLen;                  /*!< Length of the digest */
+    const uint8_t *signature;          /*!< DER encoded signature */
+    size_t signatureLen;               /*!< Length of the signature */
+} sss_mbedtls_verify_item_t;
+
 typedef struct _sss_mbedtls_symmetric
 {
     /*! Virtual connection between application (user context) and specific
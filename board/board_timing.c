@@ -0,0 +1,82 @@
+/**
+ * @file board_timing.c
+ * @brief Board cycle counter helpers used for profiling
+ */
+
+#include "board_timing.h"
+#include "stm32f4xx_hal.h"
+
+/**
+ * @brief Enable the DWT cycle counter
+ */
+void board_timing_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Read the current cycle count
+ * @retval Free-running 32-bit cycle counter value
+ */
+uint32_t board_timing_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Convert a cycle delta to microseconds
+ * @param cycles Number of elapsed cycles
+ * @retval Elapsed time in microseconds
+ */
+uint32_t board_timing_cycles_to_us(uint32_t cycles)
+{
+    uint32_t mhz = SystemCoreClock / 1000000U;
+
+    if (mhz == 0) {
+        return 0;
+    }
+    return cycles / mhz;
+}
+
+/**
+ * @brief Arm or cancel a pair of delays on the millisecond tick
+ * @param data Timer state, a board_timing_delay_t
+ * @param int_ms Intermediate delay in milliseconds
+ * @param fin_ms Final delay in milliseconds, 0 to cancel
+ */
+void board_timing_set_delay(void *data, uint32_t int_ms, uint32_t fin_ms)
+{
+    board_timing_delay_t *delay = data;
+
+    delay->int_ms = int_ms;
+    delay->fin_ms = fin_ms;
+    if (fin_ms != 0) {
+        delay->start = HAL_GetTick();
+    }
+}
+
+/**
+ * @brief Report which delays have passed
+ * @param data Timer state, a board_timing_delay_t
+ * @retval -1 if cancelled, 0 if none passed, 1 if only the intermediate one,
+ *         2 if the final one
+ */
+int board_timing_get_delay(void *data)
+{
+    board_timing_delay_t *delay = data;
+    uint32_t elapsed;
+
+    if (delay->fin_ms == 0) {
+        return -1;
+    }
+    elapsed = HAL_GetTick() - delay->start;
+    if (elapsed >= delay->fin_ms) {
+        return 2;
+    }
+    if (elapsed >= delay->int_ms) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file board_timing.h
+ * @brief Board cycle counter helpers used for profiling
+ */
+
+#ifndef BOARD_TIMING_H
+#define BOARD_TIMING_H
+
+#include <stdint.h>
+
+/**
+ * @brief Enable the DWT cycle counter
+ */
+void board_timing_init(void);
+
+/**
+ * @brief Read the current cycle count
+ * @retval Free-running 32-bit cycle counter value
+ */
+uint32_t board_timing_cycles(void);
+
+/**
+ * @brief Convert a cycle delta to microseconds
+ * @param cycles Number of elapsed cycles
+ * @retval Elapsed time in microseconds
+ */
+uint32_t board_timing_cycles_to_us(uint32_t cycles);
+
+/**
+ * @brief DTLS retransmission timer state, see mbedtls_ssl_set_timer_cb()
+ */
+typedef struct {
+    uint32_t start;
+    uint32_t int_ms;
+    uint32_t fin_ms;
+} board_timing_delay_t;
+
+/**
+ * @brief Arm or cancel a pair of delays on the millisecond tick
+ * @param data Timer state, a board_timing_delay_t
+ * @param int_ms Intermediate delay in milliseconds
+ * @param fin_ms Final delay in milliseconds, 0 to cancel
+ */
+void board_timing_set_delay(void *data, uint32_t int_ms, uint32_t fin_ms);
+
+/**
+ * @brief Report which delays have passed
+ * @param data Timer state, a board_timing_delay_t
+ * @retval -1 if cancelled, 0 if none passed, 1 if only the intermediate one,
+ *         2 if the final one
+ */
+int board_timing_get_delay(void *data);
+
+#endif /* BOARD_TIMING_H */
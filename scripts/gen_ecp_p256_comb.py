@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""Generate the secp256r1 fixed-base comb table used by Core/ecp_p256_comb.c.
+
+The table has the layout mbedTLS' ecp_precompute_comb() builds at runtime for
+P == G: with d = ceil(256 / w) and i = i_{w-1} ... i_1 in binary,
+
+    T[i] = i_{w-1} 2^{(w-1)d} G + ... + i_1 2^d G + G
+
+stored in affine coordinates (Z = 1), so ecp_mul_comb() can read it directly
+from flash instead of computing and caching it in RAM.
+
+Usage: gen_ecp_p256_comb.py <output.h> [window]
+"""
+
+import sys
+
+P = 0xFFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF
+A = P - 3
+GX = 0x6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296
+GY = 0x4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5
+NBITS = 256
+
+# ecp_pick_window() selects w = 5 for a 256-bit curve when P == G
+DEFAULT_WINDOW = 5
+
+
+def point_add(p1, p2):
+    if p1 is None:
+        return p2
+    if p2 is None:
+        return p1
+    x1, y1 = p1
+    x2, y2 = p2
+    if x1 == x2:
+        if (y1 + y2) % P == 0:
+            return None
+        lam = (3 * x1 * x1 + A) * pow(2 * y1, -1, P) % P
+    else:
+        lam = (y2 - y1) * pow(x2 - x1, -1, P) % P
+    x3 = (lam * lam - x1 - x2) % P
+    return (x3, (lam * (x1 - x3) - y1) % P)
+
+
+def point_double_n(pt, n):
+    for _ in range(n):
+        pt = point_add(pt, pt)
+    return pt
+
+
+def comb_table(w):
+    d = (NBITS + w - 1) // w
+    base = [(GX, GY)]
+    for _ in range(w - 1):
+        base.append(point_double_n(base[-1], d))
+
+    table = []
+    for i in range(1 << (w - 1)):
+        pt = base[0]
+        for l in range(1, w):
+            if i & (1 << (l - 1)):
+                pt = point_add(pt, base[l])
+        table.append(pt)
+    return table
+
+
+def limbs(value):
+    raw = value.to_bytes(NBITS // 8, "little")
+    lines = []
+    for off in range(0, len(raw), 8):
+        args = ", ".join("0x%02X" % b for b in raw[off:off + 8])
+        lines.append("    ECP_COMB_BYTES_TO_T_UINT_8(%s)," % args)
+    return "\n".join(lines)
+
+
+def render(w):
+    table = comb_table(w)
+    out = []
+    out.append("/* Generated by scripts/gen_ecp_p256_comb.py, do not edit */")
+    out.append("")
+    out.append("#ifndef ECP_P256_COMB_TABLE_H")
+    out.append("#define ECP_P256_COMB_TABLE_H")
+    out.append("")
+    out.append("#define ECP_P256_COMB_WINDOW %d" % w)
+    out.append("#define ECP_P256_COMB_SIZE %d" % len(table))
+    out.append("")
+    for i, (x, y) in enumerate(table):
+        out.append("static const mbedtls_mpi_uint ecp_p256_comb_%d_X[] = {" % i)
+        out.append(limbs(x))
+        out.append("};")
+        out.append("static const mbedtls_mpi_uint ecp_p256_comb_%d_Y[] = {" % i)
+        out.append(limbs(y))
+        out.append("};")
+    out.append("")
+    out.append("static const mbedtls_ecp_point ecp_p256_comb_T[ECP_P256_COMB_SIZE] = {")
+    for i in range(len(table)):
+        out.append("    ECP_COMB_POINT_INIT_XY_Z1(ecp_p256_comb_%d_X, ecp_p256_comb_%d_Y)," % (i, i))
+    out.append("};")
+    out.append("")
+    out.append("#endif /* ECP_P256_COMB_TABLE_H */")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 1
+    w = int(sys.argv[2]) if len(sys.argv) == 3 else DEFAULT_WINDOW
+    if not 2 <= w <= 7:
+        sys.stderr.write("window must be between 2 and 7\n")
+        return 1
+    with open(sys.argv[1], "w") as f:
+        f.write(render(w))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
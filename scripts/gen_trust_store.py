@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+"""Generate the indexed trust store consumed by Core/trust_store.c.
+
+Reads a PEM bundle (or DER files) of CA certificates and writes one blob:
+
+    header    magic "TSI2", version, count, ski_count,
+              entries_off, subject_index_off, ski_index_off, total_len
+    entries   count x pre-parsed certificate, 24 fields:
+                der, subject, ski, tbs, serial, issuer, spki, extensions,
+                sig_oid, sig          10 x (offset, length)
+                not_before, not_after seconds since the Unix epoch
+                flags                 bit 0 basicConstraints cA, bit 1
+                                      keyUsage present, bits 16-31 keyUsage
+                max_pathlen           pathLenConstraint + 1, 0 if none
+    subjects  count x (hash, ca) sorted by hash
+    skis      ski_count x (hash, ca) sorted by hash
+    DER       the certificates, 4-byte aligned
+
+All fields are little-endian uint32, offsets are from the start of the blob.
+Hashes are FNV-1a over the DER subject Name (tag and length included) and
+over the Subject Key Identifier value. The version is the FNV-1a hash of
+all certificates, so it changes whenever the store content does.
+
+--fill N pads the store to N CAs with copies of the first certificate whose
+subject and key identifier are altered. They never verify anything and only
+exist to benchmark lookups in a store of realistic size.
+
+Usage: gen_trust_store.py [--fill N] <output.h|output.bin> <ca.pem|ca.der>...
+"""
+
+import base64
+import calendar
+import re
+import struct
+import sys
+
+MAGIC = b"TSI2"
+HEADER_FMT = "<4s7I"
+ENTRY_FMT = "<24I"
+INDEX_FMT = "<2I"
+
+OID_SUBJECT_KEY_ID = bytes.fromhex("0603551d0e")
+OID_KEY_USAGE = bytes.fromhex("0603551d0f")
+OID_BASIC_CONSTRAINTS = bytes.fromhex("0603551d13")
+
+FLAG_CA = 1 << 0
+FLAG_KEY_USAGE = 1 << 1
+
+
+def fnv1a(data):
+    h = 0x811C9DC5
+    for b in data:
+        h ^= b
+        h = (h * 0x01000193) & 0xFFFFFFFF
+    return h
+
+
+def der_tlv(buf, off):
+    """Return (tag, header_len, content_len) of the TLV at off."""
+    tag = buf[off]
+    first = buf[off + 1]
+    if first < 0x80:
+        return tag, 2, first
+    n = first & 0x7F
+    length = int.from_bytes(buf[off + 2:off + 2 + n], "big")
+    return tag, 2 + n, length
+
+
+def der_children(buf, off):
+    """Yield (offset, total_len) of the children of the constructed TLV at off."""
+    _, hl, cl = der_tlv(buf, off)
+    pos = off + hl
+    end = pos + cl
+    while pos < end:
+        _, chl, ccl = der_tlv(buf, pos)
+        yield pos, chl + ccl
+        pos += chl + ccl
+
+
+def der_value(buf, off):
+    """Return (offset, length) of the content of the TLV at off."""
+    _, hl, cl = der_tlv(buf, off)
+    return off + hl, cl
+
+
+def der_time(buf, off):
+    """Decode a UTCTime or GeneralizedTime into seconds, clamped to uint32."""
+    tag = buf[off]
+    v_off, v_len = der_value(buf, off)
+    text = buf[v_off:v_off + v_len].decode("ascii").rstrip("Z")
+    if tag == 0x17:
+        year = int(text[0:2])
+        year += 2000 if year < 50 else 1900
+        text = text[2:]
+    else:
+        year = int(text[0:4])
+        text = text[4:]
+    fields = [int(text[i:i + 2]) for i in range(0, len(text), 2)] + [0, 0, 0, 0, 0]
+    t = calendar.timegm((year, fields[0], fields[1], fields[2], fields[3], fields[4]))
+    return min(max(t, 0), 0xFFFFFFFF)
+
+
+def der_bits(buf, off):
+    """Decode a BIT STRING of up to 16 bits the way mbedTLS stores keyUsage."""
+    v_off, v_len = der_value(buf, off)
+    value = 0
+    for i in range(1, min(v_len, 3)):
+        value |= buf[v_off + i] << (8 * (i - 1))
+    return value
+
+
+def parse_cert(der):
+    """Pre-parse a certificate.
+
+    Returns a dict of (offset, length) views into der for "subject", "ski"
+    (None when absent), "tbs", "serial", "issuer", "spki", "extensions",
+    "sig_oid" and "sig", plus "not_before", "not_after", "flags" and
+    "max_pathlen".
+    """
+    cert = {}
+    top = list(der_children(der, 0))
+    cert["tbs"] = top[0]
+    cert["sig_oid"] = der_value(der, next(der_children(der, top[1][0]))[0])
+    # Skip the unused-bits byte of the BIT STRING, as mbedTLS does
+    sig_off, sig_len = der_value(der, top[2][0])
+    cert["sig"] = (sig_off + 1, sig_len - 1)
+
+    fields = list(der_children(der, top[0][0]))
+    if der[fields[0][0]] == 0xA0:
+        fields = fields[1:]
+    # serial, signature, issuer, validity, subject, spki, [1], [2], [3]
+    cert["serial"] = der_value(der, fields[0][0])
+    cert["issuer"] = fields[2]
+    validity = list(der_children(der, fields[3][0]))
+    cert["not_before"] = der_time(der, validity[0][0])
+    cert["not_after"] = der_time(der, validity[1][0])
+    cert["subject"] = fields[4]
+    cert["spki"] = fields[5]
+    cert["extensions"] = (0, 0)
+    cert["ski"] = None
+    cert["flags"] = 0
+    cert["max_pathlen"] = 0
+
+    for off, length in fields[6:]:
+        if der[off] != 0xA3:
+            continue
+        exts_off, exts_len = next(der_children(der, off))
+        cert["extensions"] = (exts_off, exts_len)
+        for ext_off, _ in der_children(der, exts_off):
+            parts = list(der_children(der, ext_off))
+            oid_off, oid_len = parts[0]
+            oid = der[oid_off:oid_off + oid_len]
+            # extnValue OCTET STRING wraps the extension value
+            val_off, _ = parts[-1]
+            inner, _ = der_value(der, val_off)
+            if oid == OID_SUBJECT_KEY_ID:
+                cert["ski"] = der_value(der, inner)
+            elif oid == OID_KEY_USAGE:
+                cert["flags"] |= FLAG_KEY_USAGE | (der_bits(der, inner) << 16)
+            elif oid == OID_BASIC_CONSTRAINTS:
+                for c_off, _ in der_children(der, inner):
+                    c_val, c_len = der_value(der, c_off)
+                    if der[c_off] == 0x01 and der[c_val] != 0:
+                        cert["flags"] |= FLAG_CA
+                    elif der[c_off] == 0x02:
+                        cert["max_pathlen"] = int.from_bytes(der[c_val:c_val + c_len], "big") + 1
+    return cert
+
+
+def load_certs(paths):
+    certs = []
+    for path in paths:
+        with open(path, "rb") as f:
+            data = f.read()
+        if b"-----BEGIN CERTIFICATE-----" in data:
+            for m in re.finditer(rb"-----BEGIN CERTIFICATE-----(.+?)-----END CERTIFICATE-----",
+                                 data, re.S):
+                certs.append(base64.b64decode(b"".join(m.group(1).split())))
+        else:
+            certs.append(data)
+    return certs
+
+
+def filler(der, n):
+    """Copy of der with the last bytes of the subject and SKI replaced by n."""
+    out = bytearray(der)
+    cert = parse_cert(der)
+    s_off, s_len = cert["subject"]
+    ski = cert["ski"]
+    tag = b"%06d" % n
+    out[s_off + s_len - len(tag):s_off + s_len] = tag
+    if ski is not None and ski[1] >= 4:
+        out[ski[0] + ski[1] - 4:ski[0] + ski[1]] = struct.pack(">I", n)
+    return bytes(out)
+
+
+VIEWS = ("subject", "ski", "tbs", "serial", "issuer", "spki", "extensions", "sig_oid", "sig")
+
+
+def build(certs):
+    count = len(certs)
+    entries_off = struct.calcsize(HEADER_FMT)
+    subjects_off = entries_off + count * struct.calcsize(ENTRY_FMT)
+
+    parsed = [parse_cert(der) for der in certs]
+    ski_count = sum(1 for cert in parsed if cert["ski"] is not None)
+    skis_off = subjects_off + count * struct.calcsize(INDEX_FMT)
+    der_off = skis_off + ski_count * struct.calcsize(INDEX_FMT)
+
+    entries = b""
+    subjects = []
+    skis = []
+    blob = b""
+    version = 0x811C9DC5
+    for i, (der, cert) in enumerate(zip(certs, parsed)):
+        base = der_off + len(blob)
+        fields = [base, len(der)]
+        for name in VIEWS:
+            view = cert[name]
+            if view is None or view[1] == 0:
+                fields += [0, 0]
+            else:
+                fields += [base + view[0], view[1]]
+        fields += [cert["not_before"], cert["not_after"], cert["flags"], cert["max_pathlen"]]
+        entries += struct.pack(ENTRY_FMT, *fields)
+
+        s_off, s_len = cert["subject"]
+        subjects.append((fnv1a(der[s_off:s_off + s_len]), i))
+        if cert["ski"] is not None:
+            k_off, k_len = cert["ski"]
+            skis.append((fnv1a(der[k_off:k_off + k_len]), i))
+        blob += der + b"\0" * (-len(der) % 4)
+        version = fnv1a(struct.pack("<I", version) + der)
+
+    index = b"".join(struct.pack(INDEX_FMT, h, i) for h, i in sorted(subjects))
+    index += b"".join(struct.pack(INDEX_FMT, h, i) for h, i in sorted(skis))
+    total = der_off + len(blob)
+    header = struct.pack(HEADER_FMT, MAGIC, version, count, ski_count,
+                         entries_off, subjects_off, skis_off, total)
+    return header + entries + index + blob, version
+
+
+def render(data, version, count):
+    out = []
+    out.append("/* Generated by scripts/gen_trust_store.py, do not edit */")
+    out.append("")
+    out.append("#ifndef TRUST_STORE_BLOB_H")
+    out.append("#define TRUST_STORE_BLOB_H")
+    out.append("")
+    out.append("#include <stdint.h>")
+    out.append("")
+    out.append("#define TRUST_STORE_BLOB_VERSION 0x%08XU" % version)
+    out.append("#define TRUST_STORE_BLOB_COUNT %d" % count)
+    out.append("")
+    out.append("static const uint8_t trust_store_blob[%d] __attribute__((aligned(4))) = {" % len(data))
+    for off in range(0, len(data), 16):
+        out.append("    " + ", ".join("0x%02X" % b for b in data[off:off + 16]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("#endif /* TRUST_STORE_BLOB_H */")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    args = sys.argv[1:]
+    fill = 0
+    if len(args) >= 2 and args[0] == "--fill":
+        fill = int(args[1])
+        args = args[2:]
+    if len(args) < 2:
+        sys.stderr.write(__doc__)
+        return 1
+
+    certs = load_certs(args[1:])
+    if not certs:
+        sys.stderr.write("no certificates found\n")
+        return 1
+    for n in range(len(certs), fill):
+        certs.append(filler(certs[0], n))
+
+    data, version = build(certs)
+    if args[0].endswith(".h"):
+        with open(args[0], "w") as f:
+            f.write(render(data, version, len(certs)))
+    else:
+        with open(args[0], "wb") as f:
+            f.write(data)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())